@@ -10,11 +10,14 @@
 #include <Hobgoblin/QAO/Instantiation_guard.hpp>
 #include <Hobgoblin/QAO/Name_ref.hpp>
 #include <Hobgoblin/QAO/Orderer.hpp>
+#include <Hobgoblin/QAO/Pooled_allocation.hpp>
 #include <Hobgoblin/QAO/Priority_resolver.hpp>
 #include <Hobgoblin/QAO/Priority_resolver2.hpp>
+#include <Hobgoblin/QAO/Profiling.hpp>
 #include <Hobgoblin/QAO/Reflection.hpp>
 #include <Hobgoblin/QAO/Registry.hpp>
 #include <Hobgoblin/QAO/Runtime.hpp>
+#include <Hobgoblin/QAO/Runtime_group.hpp>
 #include <Hobgoblin/QAO/Runtime_ref.hpp>
 
 namespace jbatnozic {
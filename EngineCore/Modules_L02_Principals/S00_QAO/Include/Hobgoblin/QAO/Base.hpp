@@ -15,6 +15,7 @@
 #include <Hobgoblin/Utility/Any_ptr.hpp>
 #include <Hobgoblin/Utility/No_copy_no_move.hpp>
 
+#include <atomic>
 #include <cstdint>
 #include <string_view>
 
@@ -23,6 +24,7 @@
 HOBGOBLIN_NAMESPACE_BEGIN
 namespace qao {
 
+class QAO_ClassMetadata;
 class QAO_Runtime;
 
 // Forward-declare the create function:
@@ -72,6 +74,14 @@ public:
 
     QAO_GenericId getId() const noexcept;
 
+    //! \brief get the reflection metadata of the instance's most-derived class.
+    //! \returns pointer to the metadata, or `nullptr` if the class wasn't registered with
+    //!          `QAO_REGISTER_CLASS`.
+    //! \note the metadata is looked up only once per instance and cached afterwards.
+    //! \warning don't call this from a constructor or a destructor (as with `typeid`, the most-derived
+    //!          class isn't known at that point).
+    const QAO_ClassMetadata* getClassMetadata() const;
+
 protected:
     // Lifecycle callbacks
     virtual void _setUp();
@@ -93,6 +103,8 @@ private:
         QAO_Runtime*        runtime = nullptr;
     };
 
+    mutable std::atomic<const QAO_ClassMetadata*> _classMetadata{nullptr};
+
     const char*   _instanceName = nullptr;
     Context       _context;
     std::int32_t  _executionPriority;
@@ -126,6 +138,7 @@ private:
     // Display
     virtual void _eventDisplay() {}
 
+    void _setName(QAO_NameRef aName);
     void _callEvent(QAO_Event::Enum ev);
 
     friend class QAO_Runtime;
@@ -56,6 +56,18 @@ struct QAO_Event {
     };
 };
 
+//! Event flags are bitmasks where bit N (counting from the least significant bit) represents
+//! the event with value N in `QAO_Event::Enum`.
+constexpr std::int32_t QAO_ALL_EVENT_FLAGS = 0xFFFFFFFF;
+
+//! Event flags with no event selected.
+constexpr std::int32_t QAO_NO_EVENT_FLAGS = 0;
+
+//! Returns event flags with only the bit of the given event set.
+constexpr std::int32_t QAO_EventFlag(QAO_Event::Enum aEvent) {
+    return (1 << static_cast<std::int32_t>(aEvent));
+}
+
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
 
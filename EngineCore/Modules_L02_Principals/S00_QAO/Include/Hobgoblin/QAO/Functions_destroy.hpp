@@ -49,6 +49,25 @@ inline void QAO_Destroy(QAO_Base& aObject) {
     QAO_Destroy(&aObject);
 }
 
+//! Schedules the object pointed to by the passed pointer to be destroyed at the end of the
+//! current event, provided that the object is attached to a runtime and owned by that runtime.
+//! Unlike `QAO_Destroy`, this is safe to call on any object from any event (see
+//! `QAO_Runtime::scheduleObjectDestruction` for details), and destructions are carried out
+//! together after the event has been executed for all objects.
+//!
+//! \note does nothing if passed a NULL pointer.
+//!
+//! \throws PreconditionNotMetError if the object is not attached to a runtime or not owned by it.
+void QAO_DestroyDeferred(QAO_Base* aObject);
+
+//! Schedules the object pointed to by the passed reference to be destroyed at the end of the
+//! current event, provided that the object is attached to a runtime and owned by that runtime.
+//!
+//! \throws PreconditionNotMetError if the object is not attached to a runtime or not owned by it.
+inline void QAO_DestroyDeferred(QAO_Base& aObject) {
+    QAO_DestroyDeferred(&aObject);
+}
+
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
 
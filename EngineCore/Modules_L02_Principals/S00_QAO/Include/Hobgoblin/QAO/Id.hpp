@@ -73,6 +73,22 @@ protected:
         : QAO_GenericId{serial, index} {}
 };
 
+inline bool QAO_GenericId::operator==(const QAO_GenericId& other) const {
+    return (_serial == other._serial && _index == other._index);
+}
+
+inline bool QAO_GenericId::operator!=(const QAO_GenericId& other) const {
+    return !(*this == other);
+}
+
+inline QAO_Index QAO_GenericId::getIndex() const noexcept {
+    return _index;
+}
+
+inline QAO_Serial QAO_GenericId::getSerial() const noexcept {
+    return _serial;
+}
+
 template <class T>
 QAO_Id<T> QAO_GenericId::cast() const noexcept {
     return QAO_Id<T>{_serial, _index};
@@ -4,9 +4,14 @@
 #ifndef UHOBGOBLIN_QAO_ORDERER_HPP
 #define UHOBGOBLIN_QAO_ORDERER_HPP
 
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/QAO/Execon.hpp>
 #include <Hobgoblin/QAO/Handle.hpp>
 
-#include <set>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
@@ -17,11 +22,186 @@ class QAO_Base;
 
 namespace qao_detail {
 
-struct QAO_OrdererComparator {
-    bool operator()(const QAO_GenericHandle& a, const QAO_GenericHandle& b) const;
+class QAO_Orderer;
+
+//! Bidirectional iterator over the objects in a `QAO_Orderer`.
+//! Dereferencing yields a (non-owning) handle to the object.
+//!
+//! \note the iterator is just an index into the orderer's node storage, so it remains valid
+//!       as long as the object it refers to remains in the orderer (inserting or erasing other
+//!       objects doesn't invalidate it).
+class QAO_OrdererIteratorImpl {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type        = QAO_GenericHandle;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const QAO_GenericHandle*;
+    using reference         = const QAO_GenericHandle&;
+
+    QAO_OrdererIteratorImpl() = default;
+
+    reference operator*() const;
+    pointer   operator->() const;
+
+    QAO_OrdererIteratorImpl& operator++();
+    QAO_OrdererIteratorImpl  operator++(int);
+    QAO_OrdererIteratorImpl& operator--();
+    QAO_OrdererIteratorImpl  operator--(int);
+
+    bool operator==(const QAO_OrdererIteratorImpl& aOther) const {
+        return (_index == aOther._index && _orderer == aOther._orderer);
+    }
+
+    bool operator!=(const QAO_OrdererIteratorImpl& aOther) const {
+        return !(SELF == aOther);
+    }
+
+private:
+    friend class QAO_Orderer;
+
+    QAO_OrdererIteratorImpl(const QAO_Orderer* aOrderer, std::int32_t aIndex)
+        : _orderer{aOrderer}
+        , _index{aIndex} {}
+
+    const QAO_Orderer* _orderer = nullptr;
+    std::int32_t       _index   = -1;
 };
 
-using QAO_Orderer = std::set<QAO_GenericHandle, QAO_OrdererComparator>;
+//! Container which keeps QAO objects sorted by their execution priority (descending), and objects
+//! with the same priority by their execon threshold (ascending).
+//!
+//! Objects are kept in a single doubly linked list whose nodes live in one contiguous array
+//! (linked by indices, not pointers), so walking the list in order touches memory that is as
+//! compact as possible. The list is split into buckets - one per distinct combination of priority
+//! and execon threshold that is in use - and each bucket remembers its first and last node. Thus
+//! (with B being the number of buckets, which is normally very small compared to the number of
+//! objects):
+//! - inserting an object appends it to the end of its bucket - O(log B) if the bucket exists,
+//!   otherwise O(B),
+//! - erasing an object just unlinks its node - O(log B) (O(B) if its bucket becomes empty),
+//! - iteration is a walk through the array following `next` indices,
+//! - skipping all remaining objects with some priority (see `nextPriority`) is O(log B).
+//! No operation allocates memory, except when the node or bucket arrays need to grow.
+//!
+//! Objects with the same priority and execon threshold are ordered in order of insertion.
+class QAO_Orderer {
+public:
+    using iterator               = QAO_OrdererIteratorImpl;
+    using const_iterator         = QAO_OrdererIteratorImpl;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    //! Inserts the object into the orderer, at the end of the bucket for its current execution
+    //! priority. The handle must be non-null and non-owning.
+    //! \returns iterator to the inserted object.
+    iterator insert(QAO_GenericHandle aHandle);
+
+    //! Removes the object at the given position from the orderer.
+    //! \returns iterator to the object which followed the erased object.
+    iterator erase(iterator aPosition);
+
+    //! Moves the object at the given position into the bucket for its current execution priority
+    //! and execon threshold. Call this after either of them is changed for an object in the orderer.
+    //! \note the iterator `aPosition` remains valid and refers to the same object.
+    //! \returns `true` if the object was moved (to the end of its new bucket), or `false` if it
+    //!          already was in the right bucket (in which case it keeps its place).
+    bool reposition(iterator aPosition);
+
+    //! \returns iterator to the first object with a lower execution priority than the object at
+    //!          the given position, or `end()` if there is no such object.
+    iterator nextPriority(iterator aPosition) const;
+
+    //! Removes all objects from the orderer.
+    void clear();
+
+    //! Reserve space for at least `aCapacity` objects.
+    void reserve(PZInteger aCapacity);
+
+    PZInteger size() const;
+    bool      empty() const;
+
+    iterator begin() const;
+    iterator end() const;
+
+    reverse_iterator rbegin() const;
+    reverse_iterator rend() const;
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+private:
+    friend class QAO_OrdererIteratorImpl;
+
+    static constexpr std::int32_t NONE = -1;
+
+    struct Node {
+        QAO_GenericHandle handle;
+        std::int32_t      prev     = NONE;
+        std::int32_t      next     = NONE;
+        int               priority = 0;
+        QAO_ExeCon        execon   = QAO_ExeCon::META_EXECUTE_NONE;
+    };
+
+    struct Bucket {
+        int          priority;
+        QAO_ExeCon   execon;
+        std::int32_t head;
+        std::int32_t tail;
+    };
+
+    std::vector<Node>   _nodes;
+    std::vector<Bucket> _buckets; //!< Sorted by priority (descending), then by execon (ascending)
+    std::int32_t        _head     = NONE;
+    std::int32_t        _tail     = NONE;
+    std::int32_t        _freeHead = NONE;
+    PZInteger           _size     = 0;
+
+    std::int32_t _acquireNode();
+    void         _releaseNode(std::int32_t aIndex);
+    void         _link(std::int32_t aIndex, int aPriority, QAO_ExeCon aExecon);
+    void         _unlink(std::int32_t aIndex);
+
+    std::vector<Bucket>::iterator _lowerBound(int aPriority, QAO_ExeCon aExecon);
+};
+
+// MARK: Iterator (inline implementation)
+
+inline QAO_OrdererIteratorImpl::reference QAO_OrdererIteratorImpl::operator*() const {
+    return _orderer->_nodes[ToSz(_index)].handle;
+}
+
+inline QAO_OrdererIteratorImpl::pointer QAO_OrdererIteratorImpl::operator->() const {
+    return &(_orderer->_nodes[ToSz(_index)].handle);
+}
+
+inline QAO_OrdererIteratorImpl& QAO_OrdererIteratorImpl::operator++() {
+    _index = _orderer->_nodes[ToSz(_index)].next;
+    return SELF;
+}
+
+inline QAO_OrdererIteratorImpl QAO_OrdererIteratorImpl::operator++(int) {
+    auto rv = SELF;
+    ++SELF;
+    return rv;
+}
+
+inline QAO_OrdererIteratorImpl& QAO_OrdererIteratorImpl::operator--() {
+    if (_index == QAO_Orderer::NONE) {
+        _index = _orderer->_tail;
+    } else {
+        _index = _orderer->_nodes[ToSz(_index)].prev;
+    }
+    return SELF;
+}
+
+inline QAO_OrdererIteratorImpl QAO_OrdererIteratorImpl::operator--(int) {
+    auto rv = SELF;
+    --SELF;
+    return rv;
+}
 
 } // namespace qao_detail
 
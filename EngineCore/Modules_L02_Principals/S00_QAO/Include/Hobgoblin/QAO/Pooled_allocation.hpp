@@ -0,0 +1,104 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_QAO_POOLED_ALLOCATION_HPP
+#define UHOBGOBLIN_QAO_POOLED_ALLOCATION_HPP
+
+#include <Hobgoblin/Common.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+//! Sizes of the blocks handed out by the QAO object pools are multiples of this value.
+constexpr std::size_t QAO_POOL_SIZE_CLASS_STEP = 16;
+
+//! Objects larger than this are never pooled (they are allocated with the global `operator new`).
+constexpr std::size_t QAO_POOL_MAX_BLOCK_SIZE = 1024;
+
+//! Occupancy of the pool for a single size class.
+struct QAO_PoolStats {
+    //! Size of the blocks in the pool, in bytes.
+    std::size_t blockSize = 0;
+
+    //! Number of blocks currently holding an object.
+    PZInteger blocksInUse = 0;
+
+    //! Number of blocks which were allocated from the system (in use + free).
+    PZInteger blocksTotal = 0;
+
+    //! Total number of allocations served by the pool since the start of the program.
+    std::int64_t allocationCount = 0;
+};
+
+//! \brief Returns the stats of all pools which have served at least one allocation.
+//! \note pools are shared by all runtimes (and threads), so these stats are global.
+std::vector<QAO_PoolStats> QAO_GetPoolStats();
+
+namespace qao_detail {
+
+//! Allocates a block of at least `aSize` bytes from the pool for its size class (or from the
+//! global `operator new` if `aSize` is greater than `QAO_POOL_MAX_BLOCK_SIZE`).
+//! \throws std::bad_alloc on failure.
+void* QAO_PoolAllocate(std::size_t aSize);
+
+//! Returns a block obtained from `QAO_PoolAllocate(aSize)` to its pool.
+void QAO_PoolDeallocate(void* aPtr, std::size_t aSize) noexcept;
+
+} // namespace qao_detail
+
+//! \brief Makes instances of a QAO class (and of its subclasses) be allocated from pools.
+//!
+//! By default, `QAO_Create` allocates each object separately with the global `operator new`. Put this
+//! macro in the public section of a class definition to allocate instances of the class from pools of
+//! fixed-size blocks instead (one pool per size class, shared by all classes which use pooling).
+//! Freed blocks are kept by their pool and reused by following allocations of the same size class,
+//! so creating and destroying objects doesn't touch the global allocator at all once the pools have
+//! grown enough, and doesn't fragment the heap. Memory held by the pools is never returned to the
+//! system, so this is best used for classes whose instances are created and destroyed in large
+//! numbers (projectiles, particles and such). See `QAO_GetPoolStats` for the occupancy of the pools.
+//!
+//! Each thread keeps a small cache of free blocks of its own, which it refills from (and empties
+//! into) the shared pools a batch of blocks at a time, so threads which create and destroy objects
+//! concurrently (for example, those of different runtimes) don't contend with each other. Objects
+//! can be freed by a different thread than the one which allocated them.
+//!
+//! \note over-aligned classes (those with alignment greater than `__STDCPP_DEFAULT_NEW_ALIGNMENT__`)
+//!       and classes larger than `QAO_POOL_MAX_BLOCK_SIZE` are allocated normally.
+//!
+//! Example:
+//! class Bullet : public QAO_Base {
+//! public:
+//!     QAO_POOLED_ALLOCATION;
+//!     ...
+//! };
+#define QAO_POOLED_ALLOCATION                                                              \
+    static void* operator new(::std::size_t aSize) {                                       \
+        return ::jbatnozic::hobgoblin::qao::qao_detail::QAO_PoolAllocate(aSize);           \
+    }                                                                                      \
+    static void operator delete(void* aPtr, ::std::size_t aSize) noexcept {                \
+        ::jbatnozic::hobgoblin::qao::qao_detail::QAO_PoolDeallocate(aPtr, aSize);          \
+    }                                                                                      \
+    static void* operator new(::std::size_t aSize, ::std::align_val_t aAlignment) {        \
+        return ::operator new(aSize, aAlignment);                                          \
+    }                                                                                      \
+    static void operator delete(void*               aPtr,                                  \
+                                ::std::size_t       aSize,                                 \
+                                ::std::align_val_t aAlignment) noexcept {                  \
+        ::operator delete(aPtr, aSize, aAlignment);                                        \
+    }                                                                                      \
+    static_assert(true, "QAO_POOLED_ALLOCATION requires a semicolon after it")
+
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+#include <Hobgoblin/Private/Short_namespace.hpp>
+
+#endif // !UHOBGOBLIN_QAO_POOLED_ALLOCATION_HPP
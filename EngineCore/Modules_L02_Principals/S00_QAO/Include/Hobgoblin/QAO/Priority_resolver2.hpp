@@ -5,7 +5,7 @@
 #define UHOBGOBLIN_QAO_PRIORITY_RESOLVER2_HPP
 
 #include <cassert>
-#include <memory>
+#include <cstddef>
 #include <optional>
 #include <type_traits>
 #include <unordered_map>
@@ -45,36 +45,54 @@ public:
     QAO_PriorityResolver2();
     QAO_PriorityResolver2(int initialPriority, int priorityStep);
 
+    //! Defines a category (if it's not defined yet) and returns an object through which its
+    //! dependencies can be declared.
     DependencyInserter category(int* category);
 
+    //! Assigns priorities to all defined categories (renumbering all of them, including those which
+    //! were already resolved) and writes them to the categories' variables.
+    //! \throws TracedLogicError if the dependencies are cyclic. In that case nothing is changed.
     void resolveAll();
 
+    //! Assigns priorities only to categories which were defined since the last resolve, without
+    //! changing the priorities of the categories which were already resolved. New categories are
+    //! fitted into the gaps between existing priorities (bigger `priorityStep`s leave more room),
+    //! so objects which already use the existing priorities don't need to be updated.
+    //! \returns true if the existing priorities were kept; false if the new categories (or new
+    //!          dependencies between already resolved categories) couldn't be satisfied without
+    //!          changing them, in which case all categories are renumbered, like with `resolveAll()`.
+    //!          Then the priorities of existing objects have to be updated (for example, with
+    //!          `QAO_Runtime::updateExecutionPriorities()`).
+    //! \throws TracedLogicError if the dependencies are cyclic (including cycles among categories
+    //!         which were already resolved). In that case nothing is changed.
+    bool resolveNew();
+
 private:
     friend class DependencyInserter;
 
-    struct CategoryDefinition;
-    using DefinitionMap         = std::unordered_map<int*, std::unique_ptr<CategoryDefinition>>;
-    using DefinitionMapIterator = DefinitionMap::iterator;
-
     struct CategoryDefinition {
-        std::vector<DefinitionMapIterator> dependees;
-        int                                dependencyCounter          = 0;
-        int                                dependencyFulfilledCounter = 0;
-        std::optional<int>                 priority;
-
-        void reset();
-        bool priorityAssigned() const;
-        bool dependenciesSatisfied() const;
+        int*                     category;
+        std::vector<std::size_t> dependencies; //!< Indices of the categories this one depends on
+        std::vector<std::size_t> dependees;    //!< Indices of the categories which depend on this one
+        std::optional<int>       priority;     //!< Set once resolved
     };
 
-    DefinitionMap _definitions;
-    int           _initialPriority;
-    int           _priorityStep;
-    int           _priorityCounter;
+    std::vector<CategoryDefinition>       _definitions; //!< In order of definition
+    std::unordered_map<int*, std::size_t> _definitionIndices;
+
+    int _initialPriority;
+    int _priorityStep;
+    int _priorityCounter;
+
+    void        categoryDependsOn(int* category, int* dependency);
+    void        categoryPrecedes(int* category, int* dependee);
+    std::size_t defineCategory(int* category);
+
+    //! Sorts the given definitions so that each one comes after all of its dependencies among them.
+    //! \throws TracedLogicError if that's impossible because of a cycle.
+    std::vector<std::size_t> sortTopologically(const std::vector<std::size_t>& indices) const;
 
-    void                                      categoryDependsOn(int* category, int* dependency);
-    void                                      categoryPrecedes(int* category, int* dependee);
-    std::vector<CategoryDefinition>::iterator findDefinition(int categoryId);
+    void writePriorities();
 };
 
 template <class... NoArgs>
@@ -0,0 +1,42 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_QAO_PROFILING_HPP
+#define UHOBGOBLIN_QAO_PROFILING_HPP
+
+#include <Hobgoblin/QAO/Config.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+class QAO_ClassMetadata;
+
+//! Time spent by the instances of one class in one event, as measured by a runtime with
+//! profiling enabled (see `QAO_Runtime::setProfilingEnabled`).
+struct QAO_EventStats {
+    //! Metadata of the class. Null for objects of classes which aren't registered with
+    //! `QAO_REGISTER_CLASS` (all such objects are counted together).
+    const QAO_ClassMetadata* classMetadata = nullptr;
+
+    //! The event.
+    QAO_Event::Enum event = QAO_Event::NONE;
+
+    //! Number of times the event was executed by instances of the class.
+    std::int64_t callCount = 0;
+
+    //! Total time the instances of the class spent executing the event.
+    std::chrono::nanoseconds totalTime{0};
+};
+
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+#include <Hobgoblin/Private/Short_namespace.hpp>
+
+#endif // !UHOBGOBLIN_QAO_PROFILING_HPP
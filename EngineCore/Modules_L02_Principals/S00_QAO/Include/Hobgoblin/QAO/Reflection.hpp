@@ -8,10 +8,8 @@
 #include <Hobgoblin/Preprocessor.hpp>
 #include <Hobgoblin/QAO/Base.hpp>
 
-#include <gtl/phmap.hpp>
-
 #include <cassert>
-#include <mutex>
+#include <cstdint>
 #include <span>
 #include <string_view>
 #include <type_traits>
@@ -36,20 +34,25 @@ using QAO_UntypedMessage = void (*)(QAO_Base&, void*, bool);
 
 using QAO_UntypedClassMessage = void (*)(const QAO_ClassMetadata&, void*);
 
-using QAO_MessageHandlerMap =
-    gtl::parallel_flat_hash_map<std::type_index,
-                                QAO_UntypedMessage,
-                                gtl::priv::hash_default_hash<std::type_index>,
-                                gtl::priv::hash_default_eq<std::type_index>,
-                                std::allocator<std::pair<std::type_index, QAO_UntypedMessage>>,
-                                4,
-                                std::recursive_mutex>;
-
-bool QAO_SendMessage(QAO_MessageHandlerMap& aMessageHandlerMap,
-                     std::type_index        aMessageTypeIndex,
-                     QAO_Base&              aReceiverInstance,
-                     void*                  aMessagePayloadPtr,
-                     bool                   aConst);
+//! Each message type gets a small integer ID (starting from 0) the first time it is used
+//! (registering a handler or sending it), which indexes the dense dispatch tables of classes.
+std::int32_t QAO_AllocateMessageId();
+
+template <class taMessage>
+std::int32_t QAO_GetMessageId() {
+    static const std::int32_t id = QAO_AllocateMessageId();
+    return id;
+}
+
+bool QAO_SendMessage(std::int32_t aMessageId,
+                     QAO_Base&    aReceiverInstance,
+                     void*        aMessagePayloadPtr,
+                     bool         aConst);
+
+PZInteger QAO_BroadcastMessage(std::int32_t             aMessageId,
+                               QAO_Runtime&             aRuntime,
+                               const QAO_ClassMetadata& aReceiverClass,
+                               void*                    aMessagePayloadPtr);
 } // namespace qao_detail
 
 ///////////////////////////////////////////////////////////////////////////
@@ -97,30 +100,11 @@ void QAO_InitializeMetadata();
 //! QAO_DEFINE_MESSAGE(SetPower, const double*); // A message carrying a pointer to a read-only `double`
 //! QAO_DEFINE_MESSAGE(AddScore, int*);          // A message carrying a pointer to a mutable `int`
 //! QAO_DEFINE_MESSAGE(Ping, QAO_NO_PAYLOAD);    // A message carrying no payload at all
-#define QAO_DEFINE_MESSAGE(_message_name_, _payload_ptr_)                                             \
-    static_assert(::std::is_pointer_v<_payload_ptr_>, #_payload_ptr_ " is not a pointer type!");      \
-    class _message_name_ {                                                                            \
-    public:                                                                                           \
-        using PayloadPtr = _payload_ptr_;                                                             \
-        using Payload    = ::std::remove_pointer_t<_payload_ptr_>;                                    \
-                                                                                                      \
-    private:                                                                                          \
-        using QAO_Base              = ::jbatnozic::hobgoblin::qao::QAO_Base;                          \
-        using QAO_ClassMetadata     = ::jbatnozic::hobgoblin::qao::QAO_ClassMetadata;                 \
-        using QAO_MessageHandlerMap = ::jbatnozic::hobgoblin::qao::qao_detail::QAO_MessageHandlerMap; \
-        template <class taMessage>                                                                    \
-        friend bool ::jbatnozic::hobgoblin::qao::QAO_SendMessage(                                     \
-            QAO_Base&,                                                                                \
-            ::jbatnozic::hobgoblin::Nullable<typename taMessage::PayloadPtr>);                        \
-        template <class taMessage>                                                                    \
-        friend bool ::jbatnozic::hobgoblin::qao::QAO_SendMessage(                                     \
-            const QAO_Base&,                                                                          \
-            ::jbatnozic::hobgoblin::Nullable<typename taMessage::PayloadPtr>);                        \
-        inline static QAO_MessageHandlerMap& _getMessageHandlerMap() {                                \
-            static QAO_MessageHandlerMap map{                                                         \
-                static_cast<std::size_t>(QAO_ClassMetadata::getClassCount())};                        \
-            return map;                                                                               \
-        }                                                                                             \
+#define QAO_DEFINE_MESSAGE(_message_name_, _payload_ptr_)                                        \
+    static_assert(::std::is_pointer_v<_payload_ptr_>, #_payload_ptr_ " is not a pointer type!"); \
+    struct _message_name_ {                                                                      \
+        using PayloadPtr = _payload_ptr_;                                                        \
+        using Payload    = ::std::remove_pointer_t<_payload_ptr_>;                               \
     }
 
 //! \brief Declares a message type that can be sent to QAO classes via `QAO_SendMessage`.
@@ -172,6 +156,10 @@ void QAO_InitializeMetadata();
 //!
 //! \returns `true` if a handler was found and invoked, `false` otherwise.
 //!
+//! \note handlers (including inherited ones) are resolved into a dense table per class by
+//!       `QAO_InitializeMetadata`, so sending a message costs two array lookups and an indirect
+//!       call - there is no hashing or locking involved.
+//!
 //! Example:
 //! struct MyPayload { ... };
 //! QAO_DEFINE_MESSAGE(MyMessage, const MyPayload*);
@@ -190,6 +178,33 @@ template <class taMessage>
 bool QAO_SendMessage(const QAO_Base&                          aReceiverInstance,
                      Nullable<typename taMessage::PayloadPtr> aMessagePayloadPtr);
 
+//! \brief Sends a message of type `taMessage` to all instances of a class (including instances of
+//!        its subclasses) which are attached to a runtime.
+//!
+//! Each instance handles the message the same way as with `QAO_SendMessage` (based on its dynamic
+//! type). Only the instances of the given class and its subclasses are visited, so the cost depends
+//! on the number of those instances and not on the total number of objects in the runtime (see
+//! `QAO_Runtime::forEachInstanceOf`).
+//!
+//! \tparam taMessage message type previously declared with `QAO_DEFINE_MESSAGE`.
+//!
+//! \param aRuntime runtime whose instances should receive the message.
+//! \param aReceiverClass metadata of the class whose instances should receive the message.
+//! \param aMessagePayloadPtr the payload pointer to pass to each handler. The same payload is passed
+//!                           to all receivers.
+//!
+//! \returns number of instances which had a handler for the message.
+//!
+//! Example:
+//! QAO_DEFINE_MESSAGE(Alert, const AlertInfo*);
+//! ...
+//! const auto* enemyClass = QAO_ClassMetadata::get(typeid(Enemy));
+//! QAO_BroadcastMessage<Alert>(runtime, *enemyClass, &alertInfo);
+template <class taMessage>
+PZInteger QAO_BroadcastMessage(QAO_Runtime&                             aRuntime,
+                               const QAO_ClassMetadata&                 aReceiverClass,
+                               Nullable<typename taMessage::PayloadPtr> aMessagePayloadPtr);
+
 //! \brief Send a message of type `taMessage` to a class itself rather than an instance of a class.
 //!
 //! Unlike 'regular' messages, class messages don't interact with inheritance - the specific class
@@ -281,6 +296,22 @@ public:
     //! \note the pointers in the collection are guaranteed to be non-null.
     std::span<const QAO_ClassMetadata* const> getChildClasses() const;
 
+    //! \brief check whether the described class is the same as, or derived from, another class.
+    //! \note relies on superclasses being resolved, so before `QAO_InitializeMetadata` is called
+    //!       this only returns true if both metadata objects describe the same class.
+    bool isSubclassOf(const QAO_ClassMetadata& aOther) const;
+
+    //! \brief get event flags of the events which instances of the described class handle.
+    //! \note returns `QAO_ALL_EVENT_FLAGS` if the class didn't declare its handled events.
+    //! \see setHandledEvents
+    std::int32_t getHandledEvents() const;
+
+    //! \brief get event flags of the events which instances of the described class may execute
+    //!        in parallel with each other.
+    //! \note returns `QAO_NO_EVENT_FLAGS` if the class didn't declare any parallel events.
+    //! \see setParallelEvents
+    std::int32_t getParallelEvents() const;
+
     // Setters
     // NOTE: All setters return a reference to (*this) so that calls can be chained.
 
@@ -375,13 +406,52 @@ public:
     template <class taMessage, auto taMethod>
     QAO_ClassMetadata& setClassMessageHandler();
 
+    //! \brief Declares which events instances of this class handle (override the `_event*` methods of).
+    //!
+    //! A runtime only invokes the declared events of an instance, so events which the instance
+    //! doesn't handle cost nothing during the step. Classes which don't declare their handled events
+    //! are treated as if they handled all of them.
+    //!
+    //! \param aEventFlags bitmask of handled events (see `QAO_EventFlag`).
+    //!
+    //! \note the declared flags are combined with those of the superclass (after
+    //!       `QAO_InitializeMetadata` is called), which are all events if the superclass didn't
+    //!       declare its handled events (unless it's `QAO_Base`).
+    //!
+    //! Example:
+    //! QAO_REGISTER_CLASS(MyClass, MyClass) {
+    //!     QAO_LOCAL_ALIAS(C, klass);
+    //!     klass.setSuperclass<QAO_Base>().setHandledEvents(QAO_EventFlag(QAO_Event::UPDATE_1) |
+    //!                                                      QAO_EventFlag(QAO_Event::DRAW_1));
+    //! }
+    QAO_ClassMetadata& setHandledEvents(std::int32_t aEventFlags);
+
+    //! \brief Declares which events of this class are safe to execute in parallel.
+    //!
+    //! If a runtime has parallel workers (see `QAO_Runtime::setParallelWorkerCount`), consecutive
+    //! instances with the same execution priority which execute a parallel event are spread across
+    //! the workers, and the runtime waits for all of them to finish before moving on to the next
+    //! object. All other events keep executing serially, in order of priority.
+    //!
+    //! \param aEventFlags bitmask of parallel events (see `QAO_EventFlag`).
+    //!
+    //! \warning a parallel event implementation must not attach, detach or destroy objects, or change
+    //!          execution priorities, and must not touch any state shared with other instances
+    //!          without proper synchronization.
+    //!
+    //! \note unlike handled events, parallel events are not inherited by subclasses (a subclass which
+    //!       overrides an event might no longer be safe to execute in parallel).
+    //!
+    //! Example:
+    //! QAO_REGISTER_CLASS(Agent, Agent) {
+    //!     QAO_LOCAL_ALIAS(C, klass);
+    //!     klass.setSuperclass<QAO_Base>().setParallelEvents(QAO_EventFlag(QAO_Event::UPDATE_1));
+    //! }
+    QAO_ClassMetadata& setParallelEvents(std::int32_t aEventFlags);
+
 private:
     friend void QAO_InitializeMetadata();
-    friend bool qao_detail::QAO_SendMessage(qao_detail::QAO_MessageHandlerMap&,
-                                            std::type_index,
-                                            QAO_Base&,
-                                            void*,
-                                            bool);
+    friend bool qao_detail::QAO_SendMessage(std::int32_t, QAO_Base&, void*, bool);
     template <class taMessage>
     friend bool QAO_SendMessage(const QAO_ClassMetadata&                 aReceiverClass,
                                 Nullable<typename taMessage::PayloadPtr> aMessagePayloadPtr);
@@ -395,9 +465,14 @@ private:
     const std::string_view          _selfUniqueName;
     std::vector<QAO_ClassMetadata*> _childClasses;
 
-    // Messaging
-    std::unordered_map<std::type_index, qao_detail::QAO_UntypedMessage>      _messageHandlers;
-    std::unordered_map<std::type_index, qao_detail::QAO_UntypedClassMessage> _classMessageHandlers;
+    // Messaging (indexed by message IDs; null where there is no handler)
+    std::vector<qao_detail::QAO_UntypedMessage>      _messageHandlers;
+    std::vector<qao_detail::QAO_UntypedClassMessage> _classMessageHandlers;
+
+    // Events
+    std::int32_t _handledEvents         = QAO_ALL_EVENT_FLAGS;
+    bool         _handledEventsDeclared = false;
+    std::int32_t _parallelEvents        = QAO_NO_EVENT_FLAGS;
 
 public:
     //! \brief Constructor.
@@ -504,9 +579,13 @@ QAO_ClassMetadata& QAO_ClassMetadata::setMessageHandler() {
     auto lambda = [](QAO_Base& aInstance, void* aPayload, bool aConst) {
         ((taReceiver&)(aInstance).*taMethod)((typename taMessage::Payload*)aPayload, aConst);
     };
-    auto [_, didInsert] =
-        _messageHandlers.insert(std::make_pair(std::type_index{typeid(taMessage)}, lambda));
-    assert(didInsert && "Cannot have multiple message handlers for the same message type!");
+    const auto id = ToSz(qao_detail::QAO_GetMessageId<taMessage>());
+    if (id >= _messageHandlers.size()) {
+        _messageHandlers.resize(id + 1);
+    }
+    assert(_messageHandlers[id] == nullptr &&
+           "Cannot have multiple message handlers for the same message type!");
+    _messageHandlers[id] = lambda;
     return SELF;
 }
 
@@ -515,9 +594,13 @@ QAO_ClassMetadata& QAO_ClassMetadata::setClassMessageHandler() {
     auto lambda = [](const QAO_ClassMetadata& aClass, void* aPayload) {
         (taMethod)(aClass, (typename taMessage::Payload*)aPayload);
     };
-    auto [_, didInsert] =
-        _classMessageHandlers.insert(std::make_pair(std::type_index{typeid(taMessage)}, lambda));
-    assert(didInsert && "Cannot have multiple message handlers for the same message type!");
+    const auto id = ToSz(qao_detail::QAO_GetMessageId<taMessage>());
+    if (id >= _classMessageHandlers.size()) {
+        _classMessageHandlers.resize(id + 1);
+    }
+    assert(_classMessageHandlers[id] == nullptr &&
+           "Cannot have multiple message handlers for the same message type!");
+    _classMessageHandlers[id] = lambda;
     return SELF;
 }
 
@@ -534,8 +617,7 @@ QAO_ClassMetadata& QAO_RegisterClass(std::string_view aUniqueName) {
 
 template <class taMessage>
 bool QAO_SendMessage(QAO_Base& aReceiverInstance, typename taMessage::PayloadPtr aMessagePayloadPtr) {
-    return qao_detail::QAO_SendMessage(taMessage::_getMessageHandlerMap(),
-                                       std::type_index{typeid(taMessage)},
+    return qao_detail::QAO_SendMessage(qao_detail::QAO_GetMessageId<taMessage>(),
                                        aReceiverInstance,
                                        (void*)aMessagePayloadPtr,
                                        false);
@@ -544,21 +626,34 @@ bool QAO_SendMessage(QAO_Base& aReceiverInstance, typename taMessage::PayloadPtr
 template <class taMessage>
 bool QAO_SendMessage(const QAO_Base&                aReceiverInstance,
                      typename taMessage::PayloadPtr aMessagePayloadPtr) {
-    return qao_detail::QAO_SendMessage(taMessage::_getMessageHandlerMap(),
-                                       std::type_index{typeid(taMessage)},
+    return qao_detail::QAO_SendMessage(qao_detail::QAO_GetMessageId<taMessage>(),
                                        const_cast<QAO_Base&>(aReceiverInstance),
                                        (void*)aMessagePayloadPtr,
                                        true);
 }
 
+template <class taMessage>
+PZInteger QAO_BroadcastMessage(QAO_Runtime&                             aRuntime,
+                               const QAO_ClassMetadata&                 aReceiverClass,
+                               Nullable<typename taMessage::PayloadPtr> aMessagePayloadPtr) {
+    return qao_detail::QAO_BroadcastMessage(qao_detail::QAO_GetMessageId<taMessage>(),
+                                            aRuntime,
+                                            aReceiverClass,
+                                            (void*)aMessagePayloadPtr);
+}
+
 template <class taMessage>
 bool QAO_SendMessage(const QAO_ClassMetadata&                 aReceiverClass,
                      Nullable<typename taMessage::PayloadPtr> aMessagePayloadPtr) {
-    auto iter = aReceiverClass._classMessageHandlers.find(std::type_index{typeid(taMessage)});
-    if (iter == aReceiverClass._classMessageHandlers.end()) {
+    const auto id = ToSz(qao_detail::QAO_GetMessageId<taMessage>());
+    if (id >= aReceiverClass._classMessageHandlers.size()) {
+        return false;
+    }
+    const auto handler = aReceiverClass._classMessageHandlers[id];
+    if (handler == nullptr) {
         return false;
     }
-    (iter->second)(aReceiverClass, aMessagePayloadPtr);
+    handler(aReceiverClass, aMessagePayloadPtr);
     return true;
 }
 
@@ -10,7 +10,6 @@
 #include <Hobgoblin/QAO/Id.hpp>
 #include <Hobgoblin/Utility/Slab_indexer.hpp>
 
-#include <unordered_map>
 #include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -30,19 +29,19 @@ public:
     void              insertWithId(QAO_GenericHandle aHandle, QAO_GenericId aId);
     QAO_GenericHandle remove(QAO_Index aIndex);
 
+    //! Reserve space for at least `aCapacity` objects.
+    void reserve(PZInteger aCapacity);
+
     //! Look for an object with the specified index.
     //! \returns non-owning handle to the object if it is found, or a null handle if it is not found.
     //! \note this function has O(1) complexity.
     QAO_GenericHandle findObjectWithIndex(QAO_Index aIndex) const;
 
-    //! Look for an object with the specified serial number.
-    //! \returns non-owning handle to the object if it is found, or a null handle if it is not found.
-    //! \note this function has O(log(N)) complexity.
-    QAO_GenericHandle findObjectWithSerial(QAO_Serial aSerial) const;
-
     //! Look for an object with the specified ID.
-    //! \returns non-owning handle to the object if it is found, or a null handle if it is not found.
-    //! \note this function has O(1) complexity.
+    //! \returns non-owning handle to the object if it is found, or a null handle if it is not found
+    //!          (including when the object was removed and its index was reused by another object).
+    //! \note this function has O(1) complexity - it's just a bounds check and a comparison of
+    //!       serial numbers (which act as generations of the slots in the registry).
     QAO_GenericHandle findObjectWithId(QAO_GenericId aId) const;
 
     //! Check if an object by the given index is owned by the registry.
@@ -60,14 +59,33 @@ private:
 
     util::SlabIndexer _indexer;
     std::vector<Elem> _elements;
-    QAO_Serial        _serialCounter;
-
-    std::unordered_map<QAO_Serial, QAO_Index> _serialToIndex;
+    QAO_Serial        _serialCounter; //!< Always greater than all serials in use
 
     void       _adjustSize();
     QAO_Serial _nextSerial();
 };
 
+inline QAO_GenericHandle QAO_Registry::findObjectWithIndex(QAO_Index aIndex) const {
+    const auto szIdx = ToSz(aIndex);
+    if (szIdx >= _elements.size()) {
+        return {};
+    }
+    return _elements[szIdx].handle;
+}
+
+inline QAO_GenericHandle QAO_Registry::findObjectWithId(QAO_GenericId aId) const {
+    const auto szIdx = ToSz(aId.getIndex());
+    if (szIdx >= _elements.size()) {
+        return {};
+    }
+    // The index could have been reused by a different object since the ID was issued
+    const auto& elem = _elements[szIdx];
+    if (elem.id != aId) {
+        return {};
+    }
+    return elem.handle;
+}
+
 } // namespace qao_detail
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
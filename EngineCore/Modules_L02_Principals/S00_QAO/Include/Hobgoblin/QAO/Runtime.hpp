@@ -11,22 +11,37 @@
 #include <Hobgoblin/QAO/Handle.hpp>
 #include <Hobgoblin/QAO/Id.hpp>
 #include <Hobgoblin/QAO/Orderer.hpp>
+#include <Hobgoblin/QAO/Profiling.hpp>
 #include <Hobgoblin/QAO/Registry.hpp>
 #include <Hobgoblin/QAO/Runtime_ref.hpp>
 #include <Hobgoblin/Utility/Any_ptr.hpp>
 #include <Hobgoblin/Utility/No_copy_no_move.hpp>
 
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
 HOBGOBLIN_NAMESPACE_BEGIN
 namespace qao {
 
-constexpr std::int32_t QAO_ALL_EVENT_FLAGS = 0xFFFFFFFF;
-
 class QAO_Base;
+class QAO_ClassMetadata;
+
+namespace qao_detail {
+class QAO_Mailbox;
+class QAO_WorkerPool;
+} // namespace qao_detail
 
 class QAO_Runtime
     : NO_COPY
@@ -55,11 +70,54 @@ public:
     AvoidNull<QAO_GenericHandle> detachObject(QAO_Base& aObject);
     AvoidNull<QAO_GenericHandle> detachObject(NeverNull<QAO_GenericHandle> aObject);
 
+    //! Attach multiple objects at once (for example, when loading a level).
+    //! This is faster than attaching the objects one by one, because storage for all of them is
+    //! reserved up front. The objects' `_didAttach()` callbacks are invoked after all of the objects
+    //! are attached, in order.
+    //! \param aHandles handles to the objects; all of them will be moved from. Like with
+    //!                 `attachObject`, the runtime takes ownership of objects passed by owning handles.
+    //! \throws InvalidArgumentError if any of the handles is null or if the same object is passed
+    //!         more than once, and PreconditionNotMetError if any of the objects is already attached
+    //!         to a runtime (in all cases, before attaching anything).
+    void attachObjects(std::span<QAO_GenericHandle> aHandles);
+
+    //! Detach multiple objects at once (for example, when unloading a level).
+    //! The objects' `_willDetach()` callbacks are invoked first, while all of the objects are still
+    //! attached, and then all of them are detached.
+    //! \returns handles to the objects, in the same order as the passed IDs (owning handles for
+    //!          objects which were owned by the runtime, non-owning for others).
+    //! \throws PreconditionNotMetError if any of the objects is not attached to this runtime, and
+    //!         InvalidArgumentError if the same object is passed more than once (in both cases, before
+    //!         detaching anything).
+    //! \note if the `_willDetach()` callback of an object throws, no object is detached: the objects
+    //!       whose `_willDetach()` callbacks were already invoked get their `_didAttach()` callbacks
+    //!       invoked again (in order), and then the exception is propagated.
+    std::vector<QAO_GenericHandle> detachObjects(std::span<const QAO_GenericId> aIds);
+
     static constexpr bool PROPAGATE_EXCEPTIONS    = true;
     static constexpr bool NO_PROPAGATE_EXCEPTIONS = false;
 
     void destroyAllOwnedObjects(bool aPropagateExceptions = PROPAGATE_EXCEPTIONS);
 
+    //! Schedule an object owned by this runtime to be destroyed at the end of the current event
+    //! (or of the next event to be executed, if no event is currently being executed).
+    //! Until then, the object stays attached but none of its events are called anymore.
+    //! Scheduling an object which is already scheduled does nothing.
+    //! \throws PreconditionNotMetError if the object is not attached to and owned by this runtime,
+    //!         or if called while a parallel event is executing for any object other than the
+    //!         one whose event is calling it (from a parallel event, an object may only schedule
+    //!         its own destruction).
+    //! \see QAO_DestroyDeferred
+    void scheduleObjectDestruction(QAO_Base& aObject);
+
+    //! Find an attached object with the given name which is an instance of `T` (or a subclass of `T`).
+    //! If there are several, the one with the highest execution priority is returned (among those
+    //! with equal priority, it's unspecified which one).
+    //! \returns non-owning handle to the object, or a null handle if there is no such object.
+    //! \note the lookup is done through an index of names so its complexity doesn't depend on the
+    //!       total number of objects, only on the number of objects with the given name.
+    //! \note if both `T` and the class of the object are registered (see `QAO_REGISTER_CLASS`),
+    //!       the type check is done through the class metadata, otherwise `dynamic_cast` is used.
     template <class T = QAO_Base>
     QAO_Handle<T> find(const std::string& name) const;
 
@@ -69,8 +127,40 @@ public:
     template <class T>
     T* find(QAO_Id<T> id) const;
 
+    //! Get all attached instances of exactly the given class (not including its subclasses), in no
+    //! particular order.
+    //! \note the returned span is invalidated by attaching or detaching any object.
+    //! \note instances of classes which weren't registered with `QAO_REGISTER_CLASS` aren't tracked.
+    std::span<QAO_Base* const> getInstancesOf(const QAO_ClassMetadata& aClass) const;
+
+    //! Call `aFunc` for every attached instance of the given class or any of its subclasses.
+    //! The complexity depends only on the number of such instances, not on the total number of
+    //! objects in the runtime.
+    //! \note objects may be attached, detached and destroyed by `aFunc`. Objects which are detached
+    //!       before their turn are skipped, and objects attached while this is running aren't visited.
+    //! \note subclasses are found through `QAO_ClassMetadata::getChildClasses`, so this requires
+    //!       `QAO_InitializeMetadata` to have been called.
+    //! \returns the number of visited instances.
+    PZInteger forEachInstanceOf(const QAO_ClassMetadata&               aClass,
+                                const std::function<void(QAO_Base&)>& aFunc);
+
     void updateExecutionPriorityForObject(QAO_Base& object, int new_priority);
 
+    //! \brief change the execution priorities of many (or all) attached objects at once.
+    //!
+    //! `aGetNewPriority` is called once for every attached object and returns its new priority.
+    //! The orderers are then rebuilt in one go, which is much faster than calling
+    //! `setExecutionPriority` for every object when most of them change (for example, after
+    //! categories are renumbered by `QAO_PriorityResolver2::resolveAll()`). Objects which end up
+    //! with the same priority and execon threshold keep their relative order.
+    //!
+    //! \throws PreconditionNotMetError if a step is in progress.
+    void updateExecutionPriorities(const std::function<int(const QAO_Base&)>& aGetNewPriority);
+
+    void updateExeconThresholdForObject(QAO_Base& aObject, QAO_ExeCon aNewThreshold);
+
+    void updateNameForObject(QAO_Base& aObject, QAO_NameRef aNewName);
+
     // Execution
     void            startStep();
     void            advanceStep(bool& done, std::int32_t eventFlags = QAO_ALL_EVENT_FLAGS);
@@ -103,6 +193,82 @@ public:
     //! \brief return the set execon address.
     const QAO_ExeCon* getExeconAddress() const;
 
+    // Mailbox
+
+    //! \brief post a task to be executed by this runtime.
+    //!
+    //! Posted tasks (and objects, see `postObject`) are delivered by `deliverMail()`, in order of
+    //! posting, on the thread which runs the runtime.
+    //!
+    //! \note this is the only way for other threads to interact with a runtime while it could be
+    //!       executing a step (for example, when runtimes are stepped by a `QAO_RuntimeGroup`).
+    //!       It's thread-safe and lock-free, and can be called from any thread (including the
+    //!       events of objects in this or other runtimes).
+    void postTask(std::function<void(QAO_Runtime&)> aTask);
+
+    //! \brief post an object to be attached to this runtime.
+    //!
+    //! Behaves like `attachObject(aHandle)`, except that the object is attached only when the mail
+    //! is delivered (see `postTask`). Thread-safe and lock-free.
+    void postObject(AvoidNull<QAO_GenericHandle> aHandle);
+
+    //! \brief detach an object from this runtime and post it to another runtime.
+    //!
+    //! Must be called from the thread which runs this runtime (for example, from an event of the
+    //! object being transferred), but the target runtime can be running on a different thread.
+    //!
+    //! \throws PreconditionNotMetError if the object is not attached to this runtime.
+    void transferObject(QAO_Base& aObject, QAO_Runtime& aTargetRuntime);
+
+    //! \brief deliver all tasks and objects posted to this runtime before this call (those posted
+    //!        while it's delivering them are left for the next call).
+    //! `QAO_RuntimeGroup` calls this for all of its runtimes at the start of each step; for runtimes
+    //! which are stepped otherwise, it's up to the user to call it (typically right before
+    //! `startStep()`).
+    //! \returns number of delivered tasks and objects.
+    PZInteger deliverMail();
+
+    // Parallel execution
+
+    //! \brief set the number of worker threads used to execute parallel events.
+    //!
+    //! With 0 workers (the default) all events are executed serially on the thread which calls
+    //! `advanceStep()`. Otherwise, consecutive objects with the same execution priority which declared
+    //! the current event as parallel (see `QAO_ClassMetadata::setParallelEvents`) are executed by the
+    //! workers and the calling thread together, and the step continues once all of them are done.
+    //!
+    //! \warning must not be called while a step is in progress.
+    void setParallelWorkerCount(PZInteger aWorkerCount);
+
+    //! \brief return the number of worker threads used to execute parallel events.
+    PZInteger getParallelWorkerCount() const;
+
+    // Profiling
+
+    //! \brief enable or disable measuring the time spent by objects in their events.
+    //!
+    //! While enabled, every event executed by `advanceStep()` is timed, and call counts and times
+    //! are accumulated per class and event (see `getProfilingStats`). This costs two clock reads
+    //! per executed event, so it's disabled by default (in which case it costs only one check of
+    //! a flag per executed event). Disabling profiling keeps the stats gathered so far.
+    //!
+    //! \throws PreconditionNotMetError if called from a parallel event.
+    void setProfilingEnabled(bool aEnabled);
+
+    //! \brief check whether profiling is enabled.
+    bool isProfilingEnabled() const;
+
+    //! \brief return the stats gathered since profiling was enabled, or since the last call to
+    //!        `resetProfilingStats()`, sorted by total time (descending).
+    //! \note only combinations of class and event which were executed at least once are included.
+    std::vector<QAO_EventStats> getProfilingStats() const;
+
+    //! \brief discard the stats gathered so far.
+    //! To get stats per time window (such as a second, or a number of frames), call
+    //! `getProfilingStats()` followed by `resetProfilingStats()` at the end of every window.
+    //! \throws PreconditionNotMetError if called from a parallel event.
+    void resetProfilingStats();
+
     // Orderer/instance iterations:
     QAO_OrdererIterator begin();
     QAO_OrdererIterator end();
@@ -117,29 +283,141 @@ public:
     QAO_OrdererConstReverseIterator crend() const;
 
 private:
+    //! What the runtime keeps about each attached object: its class metadata (if the class is
+    //! registered), which events it handles, its position among the instances of its class, and its
+    //! position in `_allEventsOrderer` or its positions in the corresponding event orderers.
+    struct ObjectData {
+        const QAO_ClassMetadata*                                classMetadata      = nullptr;
+        std::int32_t                                            eventFlags         = QAO_NO_EVENT_FLAGS;
+        std::int32_t                                            parallelFlags      = QAO_NO_EVENT_FLAGS;
+        std::int32_t                                            classInstanceIndex = -1;
+        std::int32_t                                            nameIndexPosition  = -1;
+        std::int64_t                                            ordererSequence    = 0;
+        QAO_OrdererIterator                                     allEventsIterator;
+        std::array<QAO_OrdererIterator, QAO_Event::EVENT_COUNT> iterators;
+    };
+
     qao_detail::QAO_Registry _registry;
-    qao_detail::QAO_Orderer  _orderer;
+    qao_detail::QAO_Orderer  _orderer; //!< Holds all objects
+
+    //! Holds the objects which handle all events (which includes all instances of classes that
+    //! don't declare their handled events), so that each of them is in only one orderer besides
+    //! `_orderer`. Each event is executed for these objects and the ones in its event orderer,
+    //! merged in the order of execution.
+    qao_detail::QAO_Orderer _allEventsOrderer;
+
+    //! One orderer per event, holding the objects which handle that event, but not all of them.
+    std::array<qao_detail::QAO_Orderer, QAO_Event::EVENT_COUNT> _eventOrderers;
+
+    //! Incremented whenever an object is appended to a bucket of the orderers, so that objects with
+    //! the same priority and execon threshold keep their order (of insertion) when the two orderers
+    //! of an event are merged (see `ObjectData::ordererSequence`).
+    std::int64_t _ordererSequence = 0;
+
+    //! Indexed by object index (same as in the registry).
+    std::vector<ObjectData> _objectData;
+
+    //! Allows looking up `std::string` keys by `std::string_view` without a conversion.
+    struct NameHash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view aName) const {
+            return std::hash<std::string_view>{}(aName);
+        }
+    };
+
+    //! Maps names to all attached objects with that name (in no particular order).
+    //! The position of each object in its vector is kept in its `ObjectData::nameIndexPosition`.
+    std::unordered_map<std::string, std::vector<QAO_Base*>, NameHash, std::equal_to<>> _nameIndex;
+
+    //! Maps registered classes to their attached instances (not including those of subclasses).
+    //! The position of each object in its vector is kept in its `ObjectData::classInstanceIndex`.
+    std::unordered_map<const QAO_ClassMetadata*, std::vector<QAO_Base*>> _classInstances;
+
     std::int64_t             _step_counter;
     QAO_Event::Enum          _currentEvent;
-    QAO_OrdererIterator      _step_orderer_iterator;
+    QAO_OrdererIterator      _step_orderer_iterator;       //!< Into `_allEventsOrderer`
+    QAO_OrdererIterator      _step_event_orderer_iterator; //!< Into the current event's orderer
+    bool                     _step_orderer_iterator_advanced;
     util::AnyPtr             _userData;
     const QAO_ExeCon*        _execon;
+
+    std::vector<QAO_GenericId> _deferredDestructionQueue;
+    std::vector<QAO_GenericId> _deferredDestructionBatch; //!< Currently being destroyed
+    std::mutex                 _deferredDestructionMutex; //!< Used only during parallel batches
+
+    std::unique_ptr<qao_detail::QAO_Mailbox> _mailbox;
+
+    std::unique_ptr<qao_detail::QAO_WorkerPool> _workerPool;
+    std::vector<QAO_Base*>                      _parallelBatch;
+    bool                                        _parallelBatchInProgress = false;
+
+    //! Call counts and times of all events of one class.
+    struct ProfilingEntry {
+        std::array<std::int64_t, QAO_Event::EVENT_COUNT>             callCounts = {};
+        std::array<std::chrono::nanoseconds, QAO_Event::EVENT_COUNT> totalTimes = {};
+    };
+
+    //! Maps class metadata (null for unregistered classes) to their profiling stats.
+    std::unordered_map<const QAO_ClassMetadata*, ProfilingEntry> _profilingEntries;
+    std::mutex _profilingMutex; //!< Used only during parallel batches
+    bool       _profilingEnabled = false;
+
+    void              _validateObjectToAttach(const QAO_GenericHandle& aHandle);
+    void              _insertObject(QAO_Base& aObject, QAO_GenericId aId);
+    void              _completeAttaching(QAO_Base& aObject);
+    void              _checkForDuplicates(std::vector<QAO_Base*> aObjects);
+    void              _checkDetachedProperly(QAO_Base& aObject);
+    QAO_GenericHandle _removeObject(QAO_GenericId aId);
+
+    QAO_OrdererIterator _insertIntoOrderers(QAO_Base& aObject, QAO_Index aIndex);
+    void                _eraseFromOrderers(QAO_OrdererIterator aOrdererIterator, QAO_Index aIndex);
+    void                _repositionInOrderers(QAO_Base& aObject);
+    void                _advanceStepOrdererIteratorIfAt(QAO_OrdererIterator aIterator);
+    void                _advanceStepOrdererIteratorsIfAt(const ObjectData& aObjectData);
+    bool                _isParallel(const QAO_Base& aObject, QAO_Event::Enum aEvent) const;
+    void                _addToNameIndex(QAO_Base& aObject, QAO_Index aIndex);
+    void                _destroyDeferredObjects();
+    void                _removeFromNameIndex(QAO_Base& aObject, QAO_Index aIndex);
+    void                _addToClassInstances(QAO_Base& aObject, QAO_Index aIndex);
+    void                _removeFromClassInstances(QAO_Index aIndex);
+    void                _collectInstancesOf(const QAO_ClassMetadata&    aClass,
+                                            std::vector<QAO_GenericId>& aIds) const;
+
+    using InstanceOfPredicate = bool (*)(QAO_Base&);
+
+    QAO_Base* _findByName(std::string_view      aName,
+                          const std::type_info& aTypeInfo,
+                          InstanceOfPredicate   aIsInstanceOf) const;
+
+    //! Points both step orderer iterators to the start of the given event's execution.
+    void _resetStepOrdererIterators(QAO_Event::Enum aEvent);
+    //! Returns the step orderer iterator pointing to the object which executes the given (current)
+    //! event next, or `nullptr` if there are no objects left to execute it.
+    QAO_OrdererIterator* _getNextStepOrdererIterator(QAO_Event::Enum aEvent);
+    //! Returns `true` if `aLhs` executes events before `aRhs`.
+    bool _executesBefore(const QAO_Base& aLhs, const QAO_Base& aRhs) const;
+    void                _executeParallelBatch(QAO_Event::Enum aEvent);
+    void                _callEventProfiled(QAO_Base& aObject, QAO_Event::Enum aEvent);
+    void                _addProfilingSample(const QAO_ClassMetadata* aClass,
+                                            QAO_Event::Enum          aEvent,
+                                            std::int64_t             aCallCount,
+                                            std::chrono::nanoseconds aTime);
 };
 
 template <class T>
 QAO_Handle<T> QAO_Runtime::find(const std::string& name) const {
-    for (auto iter = cbegin(); iter != cend(); iter = std::next(iter)) {
-        if ((*iter)->getName() != name) {
-            continue;
-        }
-        if constexpr (!std::is_same_v<T, QAO_Base>) {
-            if (dynamic_cast<T*>(iter->ptr()) == nullptr) {
-                continue;
-            }
+    auto* object = _findByName(name, typeid(T), [](QAO_Base& aObject) -> bool {
+        if constexpr (std::is_same_v<T, QAO_Base>) {
+            return true;
+        } else {
+            return (dynamic_cast<T*>(&aObject) != nullptr);
         }
-        return iter->downcastCopy<T>();
+    });
+    if (object == nullptr) {
+        return {};
     }
-    return {};
+    return qao_detail::QAO_HandleFactory::createHandle(static_cast<T*>(object), false);
 }
 
 template <class T>
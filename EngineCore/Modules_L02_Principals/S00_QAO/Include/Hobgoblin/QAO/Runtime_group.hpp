@@ -0,0 +1,90 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_QAO_RUNTIME_GROUP_HPP
+#define UHOBGOBLIN_QAO_RUNTIME_GROUP_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/QAO/Config.hpp>
+#include <Hobgoblin/Utility/No_copy_no_move.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+class QAO_Runtime;
+
+namespace qao_detail {
+class QAO_WorkerPool;
+} // namespace qao_detail
+
+//! \brief Steps several runtimes in parallel.
+//!
+//! A simulation which is too big for one runtime can be split across several runtimes (shards),
+//! for example one per region of the map. Each call to `step()` executes a whole step of every
+//! runtime in the group, with the runtimes spread across the group's threads, and returns once all
+//! of them are done.
+//!
+//! Objects in different runtimes must not access each other directly while the runtimes are being
+//! stepped; instead, they should communicate through the runtimes' mailboxes (see
+//! `QAO_Runtime::postTask` and `QAO_Runtime::transferObject`). Mail posted during a call to
+//! `step()` is delivered at the start of the next call, before any runtime starts its step.
+//!
+//! Example:
+//! QAO_Runtime west, east;
+//! QAO_RuntimeGroup group{2};
+//! group.addRuntime(west);
+//! group.addRuntime(east);
+//! while (running) {
+//!     group.step();
+//! }
+class QAO_RuntimeGroup
+    : NO_COPY
+    , NO_MOVE {
+public:
+    //! \param aWorkerCount number of threads to create for stepping the runtimes (the thread which
+    //!                     calls `step()` takes part as well). With 0, runtimes are stepped one
+    //!                     after another on the calling thread.
+    explicit QAO_RuntimeGroup(PZInteger aWorkerCount);
+
+    ~QAO_RuntimeGroup();
+
+    //! \brief add a runtime to the group.
+    //! \note the group doesn't own the runtime, which must outlive the group or be removed from it.
+    //! \throws PreconditionNotMetError if the runtime is already in the group.
+    void addRuntime(QAO_Runtime& aRuntime);
+
+    //! \brief remove a runtime from the group.
+    //! \throws PreconditionNotMetError if the runtime is not in the group.
+    void removeRuntime(QAO_Runtime& aRuntime);
+
+    PZInteger getRuntimeCount() const;
+
+    //! \brief deliver the mail of every runtime in the group, and then execute a whole step
+    //!        (`startStep()` and `advanceStep()`) of every runtime in the group.
+    //! \param aEventFlags flags of the events to execute (see `QAO_Runtime::advanceStep`).
+    //! \throws if a runtime throws, the first exception is rethrown once all threads have stopped
+    //!         (runtimes which didn't start their step by then won't execute it).
+    void step(std::int32_t aEventFlags = QAO_ALL_EVENT_FLAGS);
+
+private:
+    std::vector<QAO_Runtime*>                   _runtimes;
+    std::unique_ptr<qao_detail::QAO_WorkerPool> _workerPool;
+
+    //! Calls `aFunc` for every runtime, spread across the threads, and waits for all calls to finish.
+    void _forEachRuntime(const std::function<void(QAO_Runtime&)>& aFunc);
+};
+
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+#include <Hobgoblin/Private/Short_namespace.hpp>
+
+#endif // !UHOBGOBLIN_QAO_RUNTIME_GROUP_HPP
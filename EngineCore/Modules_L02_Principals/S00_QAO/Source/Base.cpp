@@ -5,6 +5,7 @@
 #include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/Logging.hpp>
 #include <Hobgoblin/QAO/Base.hpp>
+#include <Hobgoblin/QAO/Reflection.hpp>
 #include <Hobgoblin/QAO/Runtime.hpp>
 #include <Hobgoblin/Utility/Passkey.hpp>
 
@@ -71,7 +72,14 @@ QAO_Runtime* QAO_Base::getRuntime() const noexcept {
 }
 
 void QAO_Base::setExeconThreshold(QAO_ExeCon aExeconThreshold) {
-    _execonThreshold = aExeconThreshold;
+    if (_execonThreshold == aExeconThreshold) {
+        return;
+    }
+    if (_context.runtime != nullptr) {
+        _context.runtime->updateExeconThresholdForObject(SELF, aExeconThreshold);
+    } else {
+        _execonThreshold = aExeconThreshold;
+    }
 }
 
 QAO_ExeCon QAO_Base::getExeconThreshold() const {
@@ -90,6 +98,16 @@ QAO_GenericId QAO_Base::getId() const noexcept {
     return _context.id;
 }
 
+const QAO_ClassMetadata* QAO_Base::getClassMetadata() const {
+    const auto* metadata = _classMetadata.load(std::memory_order_relaxed);
+    if (metadata == nullptr) {
+        // Racing threads would all find the same metadata, so it doesn't matter who stores it
+        metadata = QAO_ClassMetadata::get(typeid(SELF));
+        _classMetadata.store(metadata, std::memory_order_relaxed);
+    }
+    return metadata;
+}
+
 void QAO_Base::setExecutionPriority(int new_priority) {
     if (_executionPriority == new_priority) {
         return;
@@ -102,6 +120,16 @@ void QAO_Base::setExecutionPriority(int new_priority) {
 }
 
 void QAO_Base::setName(QAO_NameRef aName) {
+    if (_context.runtime != nullptr) {
+        _context.runtime->updateNameForObject(SELF, aName);
+    } else {
+        _setName(aName);
+    }
+}
+
+// Private
+
+void QAO_Base::_setName(QAO_NameRef aName) {
     HG_VALIDATE_PRECONDITION((aName.stringLength <= 255) &&
                              "Name length must be 255 characters or less!");
 
@@ -126,8 +154,6 @@ void QAO_Base::setName(QAO_NameRef aName) {
     }
 }
 
-// Private
-
 void QAO_Base::_callEvent(QAO_Event::Enum ev) {
     // clang-format off
     using EventHandlerPointer = void(QAO_Base::*)();
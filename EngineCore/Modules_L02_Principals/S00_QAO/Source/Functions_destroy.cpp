@@ -59,6 +59,17 @@ void QAO_Destroy(QAO_Base* aObject) {
     // Letting the handle go out of scope will destroy the object
 }
 
+void QAO_DestroyDeferred(QAO_Base* aObject) {
+    if (!aObject) {
+        return;
+    }
+
+    auto* rt = aObject->getRuntime();
+    HG_VALIDATE_PRECONDITION(rt != nullptr && "Object must be attached to a runtime.");
+
+    rt->scheduleObjectDestruction(*aObject);
+}
+
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
 
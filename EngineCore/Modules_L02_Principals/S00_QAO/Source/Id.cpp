@@ -22,22 +22,6 @@ QAO_GenericId::QAO_GenericId(QAO_Serial serial, QAO_Index index)
     : _serial{serial}
     , _index{index} {}
 
-bool QAO_GenericId::operator==(const QAO_GenericId& other) const {
-    return (_serial == other._serial && _index == other._index);
-}
-
-bool QAO_GenericId::operator!=(const QAO_GenericId& other) const {
-    return !(*this == other);
-}
-
-int QAO_GenericId::getIndex() const noexcept {
-    return _index;
-}
-
-QAO_Serial QAO_GenericId::getSerial() const noexcept {
-    return _serial;
-}
-
 bool QAO_GenericId::isNull() const noexcept {
     return (_serial == QAO_NULL_SERIAL || _index == QAO_NULL_INDEX);
 }
@@ -0,0 +1,82 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Mailbox.hpp"
+
+#include <Hobgoblin/HGExcept.hpp>
+#include <Hobgoblin/QAO/Runtime.hpp>
+
+#include <memory>
+#include <utility>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+namespace qao_detail {
+
+QAO_Mailbox::~QAO_Mailbox() {
+    auto* letter = _head.exchange(nullptr, std::memory_order_acquire);
+    while (letter != nullptr) {
+        delete std::exchange(letter, letter->next);
+    }
+    while (_pending != nullptr) {
+        delete std::exchange(_pending, _pending->next);
+    }
+}
+
+void QAO_Mailbox::postTask(Task aTask) {
+    HG_VALIDATE_ARGUMENT(!!aTask);
+    _push(new Letter{std::move(aTask), {}});
+}
+
+void QAO_Mailbox::postObject(QAO_GenericHandle aHandle) {
+    HG_VALIDATE_ARGUMENT(!aHandle.isNull());
+    _push(new Letter{{}, std::move(aHandle)});
+}
+
+PZInteger QAO_Mailbox::deliver(QAO_Runtime& aRuntime) {
+    // Take everything posted so far; the stack is in reverse order of posting. (Letters left
+    // over from a previous call which threw are delivered first.)
+    auto*    letter = _head.exchange(nullptr, std::memory_order_acquire);
+    Letter** tail   = &_pending;
+    while (*tail != nullptr) {
+        tail = &((*tail)->next);
+    }
+    Letter* taken = nullptr;
+    while (letter != nullptr) {
+        auto* next   = letter->next;
+        letter->next = taken;
+        taken        = letter;
+        letter       = next;
+    }
+    *tail = taken;
+
+    PZInteger deliveredCount = 0;
+    while (_pending != nullptr) {
+        std::unique_ptr<Letter> current{std::exchange(_pending, _pending->next)};
+        if (current->object.isNull()) {
+            current->task(aRuntime);
+        } else {
+            aRuntime.attachObject(std::move(current->object));
+        }
+        deliveredCount += 1;
+    }
+    return deliveredCount;
+}
+
+void QAO_Mailbox::_push(Letter* aLetter) {
+    aLetter->next = _head.load(std::memory_order_relaxed);
+    while (!_head.compare_exchange_weak(aLetter->next,
+                                        aLetter,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+        // `aLetter->next` was updated to the current head, try again
+    }
+}
+
+} // namespace qao_detail
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
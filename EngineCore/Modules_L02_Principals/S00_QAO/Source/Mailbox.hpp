@@ -0,0 +1,68 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_QAO_MAILBOX_HPP
+#define UHOBGOBLIN_QAO_MAILBOX_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/QAO/Handle.hpp>
+#include <Hobgoblin/Utility/No_copy_no_move.hpp>
+
+#include <atomic>
+#include <functional>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+class QAO_Runtime;
+
+namespace qao_detail {
+
+//! Queue of letters (tasks or objects) for a `QAO_Runtime`, which any number of threads can
+//! post to and which the thread running the runtime collects from.
+//!
+//! Posted letters are pushed onto a lock-free stack (a single CAS per letter), and the
+//! collecting thread takes the whole stack at once with an atomic exchange and then reverses
+//! it, so letters are delivered in order of posting (per posting thread).
+class QAO_Mailbox
+    : NO_COPY
+    , NO_MOVE {
+public:
+    using Task = std::function<void(QAO_Runtime&)>;
+
+    QAO_Mailbox() = default;
+    ~QAO_Mailbox();
+
+    void postTask(Task aTask);
+    void postObject(QAO_GenericHandle aHandle);
+
+    //! Delivers all letters posted before the call: tasks are invoked, and objects are attached to
+    //! the runtime. Letters posted during delivery are left for the next call.
+    //! If a letter throws, the letters after it stay in the mailbox.
+    //! \returns number of delivered letters.
+    PZInteger deliver(QAO_Runtime& aRuntime);
+
+private:
+    struct Letter {
+        Task              task;
+        QAO_GenericHandle object;
+        Letter*           next = nullptr;
+    };
+
+    std::atomic<Letter*> _head{nullptr};
+
+    //! Letters taken off the stack but not yet delivered (in order of delivery).
+    Letter* _pending = nullptr;
+
+    void _push(Letter* aLetter);
+};
+
+} // namespace qao_detail
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_QAO_MAILBOX_HPP
@@ -1,23 +1,234 @@
 // Copyright 2024 Jovan Batnozic. Released under MS-PL licence in Serbia.
 // See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
 
+#include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/QAO/Base.hpp>
 #include <Hobgoblin/QAO/Orderer.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
 HOBGOBLIN_NAMESPACE_BEGIN
 namespace qao {
 namespace qao_detail {
 
-bool QAO_OrdererComparator::operator()(const QAO_GenericHandle& a, const QAO_GenericHandle& b) const {
-    // If A.priority > B.priority, A precedes B
-    // For same priorities, we compare addresses
-    const int pri_a = a->getExecutionPriority();
-    const int pri_b = b->getExecutionPriority();
+QAO_Orderer::iterator QAO_Orderer::insert(QAO_GenericHandle aHandle) {
+    HG_VALIDATE_ARGUMENT(!aHandle.isNull() && !aHandle.isOwning());
+
+    const auto priority = aHandle->getExecutionPriority();
+    const auto execon   = aHandle->getExeconThreshold();
+    const auto index    = _acquireNode();
+
+    _nodes[ToSz(index)].handle = std::move(aHandle);
+    _link(index, priority, execon);
+    _size += 1;
+
+    return {this, index};
+}
+
+QAO_Orderer::iterator QAO_Orderer::erase(iterator aPosition) {
+    assert(aPosition._orderer == this && aPosition._index != NONE);
+
+    const auto index = aPosition._index;
+    const auto next  = _nodes[ToSz(index)].next;
+
+    _unlink(index);
+    _releaseNode(index);
+    _size -= 1;
+
+    return {this, next};
+}
+
+bool QAO_Orderer::reposition(iterator aPosition) {
+    assert(aPosition._orderer == this && aPosition._index != NONE);
+
+    const auto  index       = aPosition._index;
+    const auto& node        = _nodes[ToSz(index)];
+    const auto  newPriority = node.handle->getExecutionPriority();
+    const auto  newExecon   = node.handle->getExeconThreshold();
+    if (newPriority == node.priority && newExecon == node.execon) {
+        return false;
+    }
+
+    _unlink(index);
+    _link(index, newPriority, newExecon);
+    return true;
+}
+
+QAO_Orderer::iterator QAO_Orderer::nextPriority(iterator aPosition) const {
+    assert(aPosition._orderer == this && aPosition._index != NONE);
+
+    // Buckets are sorted in descending order of priority, so this finds the first
+    // bucket with priority lower than that of the object at `aPosition`.
+    const int  priority   = _nodes[ToSz(aPosition._index)].priority;
+    const auto bucketIter = std::partition_point(_buckets.begin(),
+                                                 _buckets.end(),
+                                                 [priority](const Bucket& aBucket) {
+                                                     return aBucket.priority >= priority;
+                                                 });
+    if (bucketIter == _buckets.end()) {
+        return end();
+    }
+    return {this, bucketIter->head};
+}
+
+void QAO_Orderer::clear() {
+    _nodes.clear();
+    _buckets.clear();
+    _head     = NONE;
+    _tail     = NONE;
+    _freeHead = NONE;
+    _size     = 0;
+}
+
+void QAO_Orderer::reserve(PZInteger aCapacity) {
+    _nodes.reserve(ToSz(aCapacity));
+}
+
+PZInteger QAO_Orderer::size() const {
+    return _size;
+}
+
+bool QAO_Orderer::empty() const {
+    return (_size == 0);
+}
+
+QAO_Orderer::iterator QAO_Orderer::begin() const {
+    return {this, _head};
+}
+
+QAO_Orderer::iterator QAO_Orderer::end() const {
+    return {this, NONE};
+}
+
+QAO_Orderer::reverse_iterator QAO_Orderer::rbegin() const {
+    return reverse_iterator{end()};
+}
+
+QAO_Orderer::reverse_iterator QAO_Orderer::rend() const {
+    return reverse_iterator{begin()};
+}
+
+QAO_Orderer::const_iterator QAO_Orderer::cbegin() const {
+    return begin();
+}
+
+QAO_Orderer::const_iterator QAO_Orderer::cend() const {
+    return end();
+}
+
+QAO_Orderer::const_reverse_iterator QAO_Orderer::crbegin() const {
+    return rbegin();
+}
+
+QAO_Orderer::const_reverse_iterator QAO_Orderer::crend() const {
+    return rend();
+}
+
+// MARK: Private
+
+std::int32_t QAO_Orderer::_acquireNode() {
+    if (_freeHead != NONE) {
+        const auto index = _freeHead;
+        _freeHead        = _nodes[ToSz(index)].next;
+        return index;
+    }
+    _nodes.emplace_back();
+    return static_cast<std::int32_t>(_nodes.size() - 1);
+}
+
+void QAO_Orderer::_releaseNode(std::int32_t aIndex) {
+    auto& node = _nodes[ToSz(aIndex)];
+    node       = Node{};
+    node.next  = _freeHead;
+    _freeHead  = aIndex;
+}
+
+void QAO_Orderer::_link(std::int32_t aIndex, int aPriority, QAO_ExeCon aExecon) {
+    auto& node    = _nodes[ToSz(aIndex)];
+    node.priority = aPriority;
+    node.execon   = aExecon;
+
+    auto bucketIter = _lowerBound(aPriority, aExecon);
+    if (bucketIter != _buckets.end() && bucketIter->priority == aPriority &&
+        bucketIter->execon == aExecon) {
+        // Bucket exists - append to its end
+        const auto prev = bucketIter->tail;
+        const auto next = _nodes[ToSz(prev)].next;
+
+        node.prev               = prev;
+        node.next               = next;
+        _nodes[ToSz(prev)].next = aIndex;
+        if (next != NONE) {
+            _nodes[ToSz(next)].prev = aIndex;
+        } else {
+            _tail = aIndex;
+        }
+        bucketIter->tail = aIndex;
+        return;
+    }
+
+    // New bucket - it goes right after the last node of the previous bucket, or at the very
+    // start if there is no such bucket
+    const auto prev = (bucketIter == _buckets.begin()) ? NONE : std::prev(bucketIter)->tail;
+    const auto next = (prev == NONE) ? _head : _nodes[ToSz(prev)].next;
+
+    node.prev = prev;
+    node.next = next;
+    if (prev != NONE) {
+        _nodes[ToSz(prev)].next = aIndex;
+    } else {
+        _head = aIndex;
+    }
+    if (next != NONE) {
+        _nodes[ToSz(next)].prev = aIndex;
+    } else {
+        _tail = aIndex;
+    }
+
+    _buckets.insert(bucketIter, Bucket{aPriority, aExecon, aIndex, aIndex});
+}
+
+void QAO_Orderer::_unlink(std::int32_t aIndex) {
+    auto& node = _nodes[ToSz(aIndex)];
+
+    auto bucketIter = _lowerBound(node.priority, node.execon);
+    assert(bucketIter != _buckets.end() && bucketIter->priority == node.priority &&
+           bucketIter->execon == node.execon);
+
+    if (bucketIter->head == aIndex && bucketIter->tail == aIndex) {
+        _buckets.erase(bucketIter);
+    } else if (bucketIter->head == aIndex) {
+        bucketIter->head = node.next;
+    } else if (bucketIter->tail == aIndex) {
+        bucketIter->tail = node.prev;
+    }
+
+    if (node.prev != NONE) {
+        _nodes[ToSz(node.prev)].next = node.next;
+    } else {
+        _head = node.next;
+    }
+    if (node.next != NONE) {
+        _nodes[ToSz(node.next)].prev = node.prev;
+    } else {
+        _tail = node.prev;
+    }
+
+    node.prev = NONE;
+    node.next = NONE;
+}
 
-    return (pri_a > pri_b) || ((pri_a == pri_b) && (reinterpret_cast<std::uintptr_t>(a.ptr()) <
-                                                    reinterpret_cast<std::uintptr_t>(b.ptr())));
+std::vector<QAO_Orderer::Bucket>::iterator QAO_Orderer::_lowerBound(int aPriority, QAO_ExeCon aExecon) {
+    // Buckets are sorted in descending order of priority and then in ascending order of execon,
+    // so this finds the first bucket which doesn't have to come before a bucket for
+    // (`aPriority`, `aExecon`).
+    return std::partition_point(_buckets.begin(), _buckets.end(), [=](const Bucket& aBucket) {
+        return aBucket.priority > aPriority ||
+               (aBucket.priority == aPriority && aBucket.execon < aExecon);
+    });
 }
 
 } // namespace qao_detail
@@ -0,0 +1,324 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <Hobgoblin/QAO/Pooled_allocation.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+namespace {
+static_assert(QAO_POOL_MAX_BLOCK_SIZE % QAO_POOL_SIZE_CLASS_STEP == 0);
+
+constexpr std::size_t SIZE_CLASS_COUNT = QAO_POOL_MAX_BLOCK_SIZE / QAO_POOL_SIZE_CLASS_STEP;
+
+//! Pools grow by chunks of (at least) this many bytes.
+constexpr std::size_t MIN_CHUNK_SIZE = 16 * 1024;
+
+//! Pools grow by chunks of (at least) this many blocks.
+constexpr std::size_t MIN_BLOCKS_PER_CHUNK = 16;
+
+//! Threads take blocks from the shared pools, and give them back, this many at a time.
+constexpr PZInteger BLOCKS_PER_TRANSFER = 32;
+
+//! Threads give blocks back to the shared pools once they have more than this many free ones
+//! (of a single size class).
+constexpr PZInteger MAX_CACHED_BLOCKS = 2 * BLOCKS_PER_TRANSFER;
+
+std::size_t GetSizeClass(std::size_t aSize) {
+    return (std::max(aSize, std::size_t{1}) - 1) / QAO_POOL_SIZE_CLASS_STEP;
+}
+
+std::size_t GetBlockSize(std::size_t aSizeClass) {
+    return (aSizeClass + 1) * QAO_POOL_SIZE_CLASS_STEP;
+}
+
+//! Singly linked list of free blocks (each free block holds the pointer to the next one), so
+//! both taking a block from it and putting one into it are O(1).
+class FreeList {
+public:
+    bool isEmpty() const {
+        return _head == nullptr;
+    }
+
+    PZInteger getLength() const {
+        return _length;
+    }
+
+    void push(void* aBlock) {
+        auto* block = static_cast<FreeBlock*>(aBlock);
+        block->next = _head;
+        _head       = block;
+        _length += 1;
+    }
+
+    void* pop() {
+        assert(!isEmpty());
+        auto* block = _head;
+        _head       = block->next;
+        _length -= 1;
+        return block;
+    }
+
+    //! Moves (up to) `aCount` blocks from the front of this list to `aOther`.
+    void moveTo(FreeList& aOther, PZInteger aCount) {
+        for (PZInteger i = 0; i < aCount && !isEmpty(); i += 1) {
+            aOther.push(pop());
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    FreeBlock* _head   = nullptr;
+    PZInteger  _length = 0;
+};
+
+//! Pool of fixed-size blocks shared by all threads. Threads don't allocate from it directly
+//! (see `ThreadCache`), but take and return blocks in batches, so its mutex is locked only once
+//! per `BLOCKS_PER_TRANSFER` allocations or deallocations.
+class Pool {
+public:
+    //! Moves (up to) `aCount` free blocks to `aList`, growing the pool if needed.
+    void takeBlocks(std::size_t aBlockSize, FreeList& aList, PZInteger aCount) {
+        std::lock_guard<std::mutex> lock{_mutex};
+
+        if (_freeBlocks.isEmpty()) {
+            _grow(aBlockSize);
+        }
+        _freeBlocks.moveTo(aList, aCount);
+    }
+
+    //! Moves (up to) `aCount` free blocks from `aList` back to the pool.
+    void returnBlocks(FreeList& aList, PZInteger aCount) {
+        std::lock_guard<std::mutex> lock{_mutex};
+        aList.moveTo(_freeBlocks, aCount);
+    }
+
+    //! Adds allocations and deallocations which aren't counted by any (live) thread cache.
+    void addToCounters(std::int64_t aAllocationCount, std::int64_t aBlocksInUse) {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _allocationCount += aAllocationCount;
+        _blocksInUse += aBlocksInUse;
+    }
+
+    //! Returns the stats of the pool, not including the counters of live thread caches.
+    QAO_PoolStats getStats() const {
+        std::lock_guard<std::mutex> lock{_mutex};
+
+        QAO_PoolStats stats;
+        stats.blocksInUse     = static_cast<PZInteger>(_blocksInUse);
+        stats.blocksTotal     = _blocksTotal;
+        stats.allocationCount = _allocationCount;
+        return stats;
+    }
+
+private:
+    mutable std::mutex _mutex;
+    FreeList           _freeBlocks;
+    PZInteger          _blocksTotal     = 0;
+    std::int64_t       _allocationCount = 0;
+    std::int64_t       _blocksInUse     = 0;
+
+    void _grow(std::size_t aBlockSize) {
+        const auto blockCount = std::max(MIN_CHUNK_SIZE / aBlockSize, MIN_BLOCKS_PER_CHUNK);
+
+        // Chunks are never freed; the blocks in them are recycled for the rest of the program
+        auto* chunk = static_cast<char*>(::operator new(blockCount * aBlockSize));
+
+        // Link the new blocks in order of their addresses so that consecutive allocations
+        // end up next to each other in memory
+        for (std::size_t i = blockCount; i > 0; i -= 1) {
+            _freeBlocks.push(chunk + (i - 1) * aBlockSize);
+        }
+
+        _blocksTotal += static_cast<PZInteger>(blockCount);
+    }
+};
+
+std::array<Pool, SIZE_CLASS_COUNT>& GetPools() {
+    // Intentionally never destroyed, so that objects which outlive static destruction of this
+    // translation unit can still be freed safely.
+    static auto* pools = new std::array<Pool, SIZE_CLASS_COUNT>{};
+    return *pools;
+}
+
+class ThreadCache;
+
+//! All live thread caches, so that their counters can be included in the stats.
+struct ThreadCacheRegistry {
+    std::mutex                mutex;
+    std::vector<ThreadCache*> caches;
+};
+
+ThreadCacheRegistry& GetThreadCacheRegistry() {
+    // Intentionally never destroyed (see `GetPools()`)
+    static auto* registry = new ThreadCacheRegistry{};
+    return *registry;
+}
+
+//! Free blocks of a single thread, so that allocating and freeing objects doesn't have to
+//! synchronize with other threads at all (except when blocks are moved to or from the shared
+//! pools). A block can be freed by a different thread than the one which allocated it.
+class ThreadCache {
+public:
+    ThreadCache() {
+        auto&                       registry = GetThreadCacheRegistry();
+        std::lock_guard<std::mutex> lock{registry.mutex};
+        registry.caches.push_back(this);
+    }
+
+    ~ThreadCache() {
+        auto&                       registry = GetThreadCacheRegistry();
+        std::lock_guard<std::mutex> lock{registry.mutex};
+
+        // Hand everything over to the shared pools (while the registry is locked, so that the
+        // counters are never counted twice or not at all)
+        for (std::size_t i = 0; i < SIZE_CLASS_COUNT; i += 1) {
+            auto& sizeClass = _sizeClasses[i];
+            auto& pool      = GetPools()[i];
+            pool.returnBlocks(sizeClass.freeBlocks, sizeClass.freeBlocks.getLength());
+            pool.addToCounters(sizeClass.allocationCount.load(std::memory_order_relaxed),
+                               sizeClass.blocksInUse.load(std::memory_order_relaxed));
+        }
+        registry.caches.erase(std::find(registry.caches.begin(), registry.caches.end(), this));
+    }
+
+    void* allocate(std::size_t aSizeClass) {
+        auto& sizeClass = _sizeClasses[aSizeClass];
+        if (sizeClass.freeBlocks.isEmpty()) {
+            GetPools()[aSizeClass].takeBlocks(GetBlockSize(aSizeClass),
+                                              sizeClass.freeBlocks,
+                                              BLOCKS_PER_TRANSFER);
+        }
+        _increment(sizeClass.allocationCount, 1);
+        _increment(sizeClass.blocksInUse, 1);
+        return sizeClass.freeBlocks.pop();
+    }
+
+    void deallocate(void* aPtr, std::size_t aSizeClass) {
+        auto& sizeClass = _sizeClasses[aSizeClass];
+        sizeClass.freeBlocks.push(aPtr);
+        _increment(sizeClass.blocksInUse, -1);
+        if (sizeClass.freeBlocks.getLength() > MAX_CACHED_BLOCKS) {
+            GetPools()[aSizeClass].returnBlocks(sizeClass.freeBlocks, BLOCKS_PER_TRANSFER);
+        }
+    }
+
+    //! Adds the counters of this cache to `aStats`.
+    //! \note can be called from any thread (as long as the registry is locked).
+    void addCountersTo(std::size_t aSizeClass, QAO_PoolStats& aStats) const {
+        const auto& sizeClass = _sizeClasses[aSizeClass];
+        aStats.allocationCount += sizeClass.allocationCount.load(std::memory_order_relaxed);
+        aStats.blocksInUse +=
+            static_cast<PZInteger>(sizeClass.blocksInUse.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct SizeClass {
+        FreeList freeBlocks;
+
+        // Written only by the owning thread (so no read-modify-write operations are needed), and
+        // atomic only so that the stats can be read from other threads.
+        std::atomic<std::int64_t> allocationCount{0};
+        std::atomic<std::int64_t> blocksInUse{0}; //!< Can be negative (if freed by another thread)
+    };
+
+    std::array<SizeClass, SIZE_CLASS_COUNT> _sizeClasses;
+
+    static void _increment(std::atomic<std::int64_t>& aCounter, std::int64_t aValue) {
+        aCounter.store(aCounter.load(std::memory_order_relaxed) + aValue, std::memory_order_relaxed);
+    }
+};
+
+//! Returns the cache of the calling thread, or null if it was already destroyed (which can
+//! happen when an object is freed from the destructor of a static or thread-local variable).
+ThreadCache* GetThreadCache() {
+    thread_local bool isDestroyed = false;
+    if (isDestroyed) {
+        return nullptr;
+    }
+
+    struct Holder {
+        ThreadCache cache;
+
+        ~Holder() {
+            isDestroyed = true;
+        }
+    };
+    thread_local Holder holder;
+    return &holder.cache;
+}
+} // namespace
+
+std::vector<QAO_PoolStats> QAO_GetPoolStats() {
+    auto&                       registry = GetThreadCacheRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    std::vector<QAO_PoolStats> result;
+    for (std::size_t i = 0; i < SIZE_CLASS_COUNT; i += 1) {
+        auto stats = GetPools()[i].getStats();
+        for (const auto* cache : registry.caches) {
+            cache->addCountersTo(i, stats);
+        }
+        if (stats.allocationCount > 0) {
+            stats.blockSize = GetBlockSize(i);
+            result.push_back(stats);
+        }
+    }
+    return result;
+}
+
+namespace qao_detail {
+
+void* QAO_PoolAllocate(std::size_t aSize) {
+    if (aSize > QAO_POOL_MAX_BLOCK_SIZE) {
+        return ::operator new(aSize);
+    }
+    const auto sizeClass = GetSizeClass(aSize);
+    if (auto* cache = GetThreadCache()) {
+        return cache->allocate(sizeClass);
+    }
+
+    FreeList list;
+    GetPools()[sizeClass].takeBlocks(GetBlockSize(sizeClass), list, 1);
+    GetPools()[sizeClass].addToCounters(1, 1);
+    return list.pop();
+}
+
+void QAO_PoolDeallocate(void* aPtr, std::size_t aSize) noexcept {
+    if (aPtr == nullptr) {
+        return;
+    }
+    if (aSize > QAO_POOL_MAX_BLOCK_SIZE) {
+        ::operator delete(aPtr);
+        return;
+    }
+    const auto sizeClass = GetSizeClass(aSize);
+    if (auto* cache = GetThreadCache()) {
+        cache->deallocate(aPtr, sizeClass);
+        return;
+    }
+
+    FreeList list;
+    list.push(aPtr);
+    GetPools()[sizeClass].returnBlocks(list, 1);
+    GetPools()[sizeClass].addToCounters(0, -1);
+}
+
+} // namespace qao_detail
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
@@ -4,6 +4,7 @@
 #include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/QAO/Priority_resolver2.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -13,93 +14,207 @@ namespace qao {
 
 QAO_PriorityResolver2::QAO_PriorityResolver2()
     : _initialPriority{0}
-    , _priorityStep{1} {}
+    , _priorityStep{1}
+    , _priorityCounter{0} {}
 
 QAO_PriorityResolver2::QAO_PriorityResolver2(int initialPriority, int priorityStep)
     : _initialPriority{initialPriority}
-    , _priorityStep{priorityStep} {}
-
-void QAO_PriorityResolver2::CategoryDefinition::reset() {
-    // dependencyCounter = 0;
-    dependencyFulfilledCounter = 0;
-    priority.reset();
-}
-
-bool QAO_PriorityResolver2::CategoryDefinition::priorityAssigned() const {
-    return priority.has_value();
-}
-
-bool QAO_PriorityResolver2::CategoryDefinition::dependenciesSatisfied() const {
-    return (dependencyFulfilledCounter == dependencyCounter);
-}
+    , _priorityStep{priorityStep}
+    , _priorityCounter{initialPriority} {}
 
 QAO_PriorityResolver2::DependencyInserter QAO_PriorityResolver2::category(int* category) {
+    defineCategory(category);
     return DependencyInserter(SELF, category);
 }
 
 void QAO_PriorityResolver2::resolveAll() {
+    std::vector<std::size_t> indices(_definitions.size());
+    for (std::size_t i = 0; i < indices.size(); i += 1) {
+        indices[i] = i;
+    }
+    const auto order = sortTopologically(indices);
+
     _priorityCounter = _initialPriority;
+    for (const auto index : order) {
+        _definitions[index].priority = _priorityCounter;
+        _priorityCounter -= _priorityStep;
+    }
 
-    // Reset all definitions:
-    for (auto& definition : _definitions) {
-        definition.second->reset();
+    writePriorities();
+}
+
+bool QAO_PriorityResolver2::resolveNew() {
+    std::vector<std::size_t> newIndices;
+    for (std::size_t i = 0; i < _definitions.size(); i += 1) {
+        if (!_definitions[i].priority.has_value()) {
+            newIndices.push_back(i);
+        }
     }
 
-    // Try to resolve all:
-    while (true) {
-        // Find definition with all dependencies satisfied:
-        DefinitionMap::iterator curr;
-        for (curr = _definitions.begin(); curr != _definitions.end(); curr = std::next(curr)) {
-            if ((*curr).second->priorityAssigned() == false && (*curr).second->dependenciesSatisfied()) {
-                break;
-            }
+    // Dependencies added between already resolved categories must already be satisfied
+    // (if there is a cycle among them, `resolveAll()` throws)
+    for (const auto& definition : _definitions) {
+        if (!definition.priority.has_value()) {
+            continue;
         }
-        if (curr == _definitions.end()) {
-            break;
+        for (const auto dependency : definition.dependencies) {
+            const auto& dependencyPriority = _definitions[dependency].priority;
+            if (dependencyPriority.has_value() && *dependencyPriority <= *definition.priority) {
+                resolveAll();
+                return false;
+            }
         }
+    }
 
-        for (auto& dependeeIter : (*curr).second->dependees) {
-            (*dependeeIter).second->dependencyFulfilledCounter += 1;
-        }
+    if (newIndices.empty()) {
+        return true;
+    }
 
-        (*curr).second->priority = _priorityCounter;
-        _priorityCounter -= _priorityStep;
+    const auto order = sortTopologically(newIndices);
+
+    // The priority of a new category must be lower than the priorities of all of its dependencies
+    // (upper bound), and higher than the priorities of all resolved categories which depend on it,
+    // directly or through other new categories (lower bound). Lower bounds are found by going
+    // through the new categories from the last to the first in the topological order. Along the
+    // way, the length of the longest chain of new categories which depend on each new category is
+    // found, so that the gaps can be divided evenly between the categories of a chain.
+    std::vector<std::optional<int>> lowerBounds(_definitions.size());
+    std::vector<int>                chainLengths(_definitions.size(), 0);
+    for (auto iter = order.rbegin(); iter != order.rend(); ++iter) {
+        auto& lowerBound = lowerBounds[*iter];
+        for (const auto dependee : _definitions[*iter].dependees) {
+            if (!_definitions[dependee].priority.has_value()) {
+                chainLengths[*iter] = std::max(chainLengths[*iter], chainLengths[dependee] + 1);
+            }
+            const auto& bound = _definitions[dependee].priority.has_value()
+                                    ? _definitions[dependee].priority
+                                    : lowerBounds[dependee];
+            if (bound.has_value()) {
+                lowerBound = std::max(lowerBound.value_or(*bound), *bound);
+            }
+        }
     }
 
-    // Verify & populate output:
-    for (auto& definitionIter : _definitions) {
-        if (!definitionIter.second->priorityAssigned()) {
-            HG_THROW_TRACED(TracedLogicError,
-                            0,
-                            "Cannot resolve priorities - impossible situation requested.");
+    std::vector<std::optional<int>> priorities(_definitions.size());
+    const auto getPriority = [&](std::size_t aIndex) {
+        return _definitions[aIndex].priority.has_value() ? _definitions[aIndex].priority
+                                                         : priorities[aIndex];
+    };
+
+    int priorityCounter = _priorityCounter;
+    for (const auto index : order) {
+        std::optional<int> upperBound;
+        for (const auto dependency : _definitions[index].dependencies) {
+            const auto bound = getPriority(dependency);
+            assert(bound.has_value());
+            upperBound = std::min(upperBound.value_or(*bound), *bound);
         }
+        const auto& lowerBound  = lowerBounds[index];
+        const int   chainLength = chainLengths[index];
+
+        if (upperBound.has_value() && lowerBound.has_value()) {
+            // Divide the gap evenly between this category and the chain after it (so a single
+            // category takes the middle), to leave room for categories which will come between
+            const int step = (*upperBound - *lowerBound) / (chainLength + 2);
+            if (step < 1) {
+                resolveAll();
+                return false;
+            }
+            priorities[index] = *upperBound - step;
+        } else if (upperBound.has_value()) {
+            priorities[index] = *upperBound - _priorityStep;
+        } else if (lowerBound.has_value()) {
+            priorities[index] = *lowerBound + _priorityStep * (chainLength + 1);
+        } else {
+            priorities[index] = priorityCounter;
+            priorityCounter -= _priorityStep;
+        }
+    }
 
-        int* categoryPriorityPtr = definitionIter.first;
-        *categoryPriorityPtr     = *(definitionIter.second->priority);
+    for (const auto index : order) {
+        _definitions[index].priority = priorities[index];
     }
+    _priorityCounter = priorityCounter;
+
+    writePriorities();
+    return true;
 }
 
 void QAO_PriorityResolver2::categoryDependsOn(int* category, int* dependency) {
-    auto dependeeIter = _definitions.find(category);
-    if (dependeeIter == _definitions.end()) {
-        dependeeIter =
-            _definitions.insert(std::make_pair(category, std::make_unique<CategoryDefinition>())).first;
-    }
-    (*dependeeIter).second->dependencyCounter += 1;
+    const auto dependeeIndex   = defineCategory(category);
+    const auto dependencyIndex = defineCategory(dependency);
 
-    auto dependencyIter = _definitions.find(dependency);
-    if (dependencyIter == _definitions.end()) {
-        dependencyIter =
-            _definitions.insert(std::make_pair(dependency, std::make_unique<CategoryDefinition>()))
-                .first;
-    }
-    (*dependencyIter).second->dependees.push_back(dependeeIter);
+    _definitions[dependeeIndex].dependencies.push_back(dependencyIndex);
+    _definitions[dependencyIndex].dependees.push_back(dependeeIndex);
 }
 
 void QAO_PriorityResolver2::categoryPrecedes(int* category, int* dependee) {
     categoryDependsOn(dependee, category);
 }
 
+std::size_t QAO_PriorityResolver2::defineCategory(int* category) {
+    const auto [iter, inserted] = _definitionIndices.emplace(category, _definitions.size());
+    if (inserted) {
+        _definitions.push_back({.category     = category,
+                                .dependencies = {},
+                                .dependees    = {},
+                                .priority     = std::nullopt});
+    }
+    return iter->second;
+}
+
+std::vector<std::size_t> QAO_PriorityResolver2::sortTopologically(
+    const std::vector<std::size_t>& indices) const //
+{
+    // Kahn's algorithm, considering only dependencies among the given definitions
+    constexpr int NOT_INCLUDED = -1;
+
+    std::vector<int> pendingCounts(_definitions.size(), NOT_INCLUDED);
+    for (const auto index : indices) {
+        pendingCounts[index] = 0;
+    }
+    for (const auto index : indices) {
+        for (const auto dependency : _definitions[index].dependencies) {
+            if (pendingCounts[dependency] != NOT_INCLUDED) {
+                pendingCounts[index] += 1;
+            }
+        }
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(indices.size());
+    for (const auto index : indices) {
+        if (pendingCounts[index] == 0) {
+            order.push_back(index);
+        }
+    }
+    for (std::size_t i = 0; i < order.size(); i += 1) {
+        for (const auto dependee : _definitions[order[i]].dependees) {
+            if (pendingCounts[dependee] == NOT_INCLUDED) {
+                continue;
+            }
+            pendingCounts[dependee] -= 1;
+            if (pendingCounts[dependee] == 0) {
+                order.push_back(dependee);
+            }
+        }
+    }
+
+    if (order.size() != indices.size()) {
+        HG_THROW_TRACED(TracedLogicError,
+                        0,
+                        "Cannot resolve priorities - impossible situation requested.");
+    }
+    return order;
+}
+
+void QAO_PriorityResolver2::writePriorities() {
+    for (const auto& definition : _definitions) {
+        assert(definition.priority.has_value());
+        *definition.category = *definition.priority;
+    }
+}
+
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
 
@@ -4,7 +4,9 @@
 #include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/QAO/Base.hpp>
 #include <Hobgoblin/QAO/Reflection.hpp>
+#include <Hobgoblin/QAO/Runtime.hpp>
 
+#include <atomic>
 #include <cassert>
 #include <deque>
 
@@ -83,6 +85,34 @@ std::span<const QAO_ClassMetadata* const> QAO_ClassMetadata::getChildClasses() c
     return _childClasses;
 }
 
+bool QAO_ClassMetadata::isSubclassOf(const QAO_ClassMetadata& aOther) const {
+    for (const auto* current = this; current != nullptr; current = current->_superclassMetadata) {
+        if (current == &aOther) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::int32_t QAO_ClassMetadata::getHandledEvents() const {
+    return _handledEvents;
+}
+
+QAO_ClassMetadata& QAO_ClassMetadata::setHandledEvents(std::int32_t aEventFlags) {
+    _handledEvents         = aEventFlags;
+    _handledEventsDeclared = true;
+    return SELF;
+}
+
+std::int32_t QAO_ClassMetadata::getParallelEvents() const {
+    return _parallelEvents;
+}
+
+QAO_ClassMetadata& QAO_ClassMetadata::setParallelEvents(std::int32_t aEventFlags) {
+    _parallelEvents = aEventFlags;
+    return SELF;
+}
+
 // MARK: Registering classes
 
 namespace qao_detail {
@@ -114,44 +144,26 @@ QAO_ClassMetadata& QAO_RegisterClass(const std::type_info& aTypeInfo, std::strin
 
 namespace qao_detail {
 
-bool QAO_SendMessage(QAO_MessageHandlerMap& aMessageHandlerMap,
-                     std::type_index        aMessageTypeIndex,
-                     QAO_Base&              aReceiverInstance,
-                     void*                  aMessagePayloadPtr,
-                     bool                   aConst) {
-    QAO_UntypedMessage untypedMessagePtr = nullptr;
-
-    const auto instTypeIdx = std::type_index{typeid(aReceiverInstance)};
-    aMessageHandlerMap.lazy_emplace_l(
-        instTypeIdx,
-        // --- CASE 1: Key already exists ---
-        // Called under a submap lock.
-        [&untypedMessagePtr](QAO_MessageHandlerMap::value_type& aPair) {
-            untypedMessagePtr = aPair.second; // Copy the existing value
-        },
-        // --- CASE 2: Key is missing ---
-        // Called under a submap lock.
-        [&untypedMessagePtr, &aMessageTypeIndex, &aReceiverInstance, instTypeIdx](
-            const QAO_MessageHandlerMap::constructor& aCtor) //
-        {
-            // Generate the value lazily
-            const auto* metadata = QAO_ClassMetadata::get(typeid(aReceiverInstance));
-            if (!metadata) {
-                aCtor(instTypeIdx, nullptr); // Atomically construct it in-place
-                return;
-            }
-
-            const auto iter = metadata->_messageHandlers.find(aMessageTypeIndex);
-            if (iter == metadata->_messageHandlers.end()) {
-                aCtor(instTypeIdx, nullptr); // Atomically construct it in-place
-                return;
-            }
+std::int32_t QAO_AllocateMessageId() {
+    static std::atomic<std::int32_t> nextId{0};
+    return nextId.fetch_add(1, std::memory_order_relaxed);
+}
 
-            untypedMessagePtr = iter->second;
+bool QAO_SendMessage(std::int32_t aMessageId,
+                     QAO_Base&    aReceiverInstance,
+                     void*        aMessagePayloadPtr,
+                     bool         aConst) {
+    const auto* metadata = aReceiverInstance.getClassMetadata();
+    if (metadata == nullptr) {
+        return false;
+    }
 
-            aCtor(instTypeIdx, untypedMessagePtr); // Atomically construct it in-place
-        });
+    const auto& handlers = metadata->_messageHandlers;
+    if (ToSz(aMessageId) >= handlers.size()) {
+        return false;
+    }
 
+    const auto untypedMessagePtr = handlers[ToSz(aMessageId)];
     if (!untypedMessagePtr) {
         return false;
     }
@@ -160,6 +172,19 @@ bool QAO_SendMessage(QAO_MessageHandlerMap& aMessageHandlerMap,
     return true;
 }
 
+PZInteger QAO_BroadcastMessage(std::int32_t             aMessageId,
+                               QAO_Runtime&             aRuntime,
+                               const QAO_ClassMetadata& aReceiverClass,
+                               void*                    aMessagePayloadPtr) {
+    PZInteger handledCount = 0;
+    aRuntime.forEachInstanceOf(aReceiverClass, [&](QAO_Base& aInstance) {
+        if (QAO_SendMessage(aMessageId, aInstance, aMessagePayloadPtr, false)) {
+            handledCount += 1;
+        }
+    });
+    return handledCount;
+}
+
 } // namespace qao_detail
 
 // MARK: Init
@@ -228,9 +253,22 @@ void QAO_InitializeMetadata() {
             ++visitedClassesCount;
 
             // Inherit message handlers which aren't overriden
-            auto& parent = *current->_superclassMetadata;
-            for (auto& [typeIndex, untypedMessage] : parent._messageHandlers) {
-                (void)current->_messageHandlers.try_emplace(typeIndex, untypedMessage);
+            auto& parent   = *current->_superclassMetadata;
+            auto& handlers = current->_messageHandlers;
+            if (handlers.size() < parent._messageHandlers.size()) {
+                handlers.resize(parent._messageHandlers.size());
+            }
+            for (std::size_t i = 0; i < parent._messageHandlers.size(); i += 1) {
+                if (handlers[i] == nullptr) {
+                    handlers[i] = parent._messageHandlers[i];
+                }
+            }
+
+            // Combine declared handled events with those of the superclass, which already contain
+            // the events of its own superclasses (a superclass which didn't declare them handles all
+            // events, as it could implement any of them - except for `QAO_Base`, which implements none)
+            if (current->_handledEventsDeclared && parent._superclassMetadata != nullptr) {
+                current->_handledEvents |= parent._handledEvents;
             }
 
             for (auto& child : current->_childClasses) {
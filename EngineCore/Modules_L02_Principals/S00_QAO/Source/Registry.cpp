@@ -23,11 +23,6 @@ QAO_GenericId QAO_Registry::insert(QAO_GenericHandle aHandle) {
     const auto index  = static_cast<QAO_Index>(_indexer.acquire());
     const auto serial = _nextSerial();
 
-    const auto didInsert = _serialToIndex.insert(std::make_pair(serial, index)).second;
-    if (!didInsert) {
-        HG_THROW_TRACED(TracedRuntimeError, 0, "Fatal serial number clash with value {}.", serial);
-    }
-
     _adjustSize();
 
     const auto id = QAO_GenericId{serial, index};
@@ -38,6 +33,8 @@ QAO_GenericId QAO_Registry::insert(QAO_GenericHandle aHandle) {
 }
 
 void QAO_Registry::insertWithId(QAO_GenericHandle aHandle, QAO_GenericId aId) {
+    HG_VALIDATE_ARGUMENT(!aId.isNull());
+
     if (!_indexer.tryAcquireSpecific(aId.getIndex())) {
         HG_THROW_TRACED(TracedLogicError,
                         0,
@@ -45,12 +42,10 @@ void QAO_Registry::insertWithId(QAO_GenericHandle aHandle, QAO_GenericId aId) {
                         aId.getIndex());
     }
 
-    const auto didInsert = _serialToIndex.insert(std::make_pair(aId.getSerial(), aId.getIndex())).second;
-    if (!didInsert) {
-        HG_THROW_TRACED(TracedRuntimeError,
-                        0,
-                        "Fatal serial number clash with value {}.",
-                        aId.getSerial());
+    // Make sure serials given out later are all greater than this one, so that stale IDs of
+    // objects which later end up with the same index can never be mistaken for this one
+    if (aId.getSerial() >= _serialCounter) {
+        _serialCounter = aId.getSerial() + 1;
     }
 
     _adjustSize();
@@ -66,37 +61,15 @@ QAO_GenericHandle QAO_Registry::remove(QAO_Index aIndex) {
 
     QAO_GenericHandle rv = std::move(elem.handle);
 
-    _serialToIndex.erase(elem.id.getSerial());
-
     elem = {};
     _indexer.free(aIndex);
 
     return rv;
 }
 
-QAO_GenericHandle QAO_Registry::findObjectWithIndex(QAO_Index aIndex) const {
-    const auto szIdx = ToSz(aIndex);
-    if (szIdx >= _elements.size()) {
-        return {};
-    }
-    return _elements[szIdx].handle;
-}
-
-QAO_GenericHandle QAO_Registry::findObjectWithSerial(QAO_Serial aSerial) const {
-    const auto iter = _serialToIndex.find(aSerial);
-    if (iter == _serialToIndex.end()) {
-        return {};
-    }
-
-    return _elements[ToSz(iter->second)].handle;
-}
-
-QAO_GenericHandle QAO_Registry::findObjectWithId(QAO_GenericId aId) const {
-    const auto szIdx = ToSz(aId.getIndex());
-    if (szIdx >= _elements.size()) {
-        return {};
-    }
-    return _elements[szIdx].handle;
+void QAO_Registry::reserve(PZInteger aCapacity) {
+    _indexer.reserve(aCapacity);
+    _elements.reserve(ToSz(aCapacity));
 }
 
 bool QAO_Registry::isObjectWithIndexOwned(QAO_Index aIndex) const {
@@ -6,13 +6,19 @@
 #include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/Logging.hpp>
 #include <Hobgoblin/QAO/Base.hpp>
+#include <Hobgoblin/QAO/Reflection.hpp>
 #include <Hobgoblin/QAO/Runtime.hpp>
 
+#include "Mailbox.hpp"
+#include "Worker_pool.hpp"
+
+#include <algorithm>
 #include <cassert>
-#include <cstring>
 #include <exception>
 #include <limits>
+#include <tuple>
 #include <typeinfo>
+#include <utility>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
@@ -22,6 +28,32 @@ namespace qao {
 namespace {
 constexpr auto         LOG_ID           = "Hobgoblin.QAO";
 constexpr std::int64_t MIN_STEP_ORDINAL = std::numeric_limits<std::int64_t>::min(); // TODO to config.hpp
+
+// Objects scheduled for destruction get this step ordinal, so that the check which prevents an
+// object's event from being executed twice in the same step also skips them.
+constexpr std::int64_t DESTRUCTION_PENDING_STEP_ORDINAL = std::numeric_limits<std::int64_t>::max();
+
+// Flags of all events that exist (`QAO_ALL_EVENT_FLAGS` has more bits set).
+constexpr std::int32_t EVERY_EVENT_FLAGS = (1 << QAO_Event::EVENT_COUNT) - 1;
+
+bool HandlesAllEvents(std::int32_t aEventFlags) {
+    return (aEventFlags & EVERY_EVENT_FLAGS) == EVERY_EVENT_FLAGS;
+}
+
+// Object whose event the current thread is executing as part of a parallel batch (if any).
+thread_local const QAO_Base* parallelEventObject = nullptr;
+
+//! Sets `parallelEventObject` for as long as it exists.
+class ParallelEventScope {
+public:
+    explicit ParallelEventScope(const QAO_Base& aObject) {
+        parallelEventObject = &aObject;
+    }
+
+    ~ParallelEventScope() {
+        parallelEventObject = nullptr;
+    }
+};
 } // namespace
 
 QAO_Runtime::QAO_Runtime()
@@ -36,9 +68,12 @@ QAO_Runtime::QAO_Runtime(const QAO_ExeCon* aExeconAddress)
 QAO_Runtime::QAO_Runtime(util::AnyPtr aUserData, const QAO_ExeCon* aExeconAddress)
     : _step_counter{MIN_STEP_ORDINAL + 1}
     , _currentEvent{QAO_Event::NONE}
-    , _step_orderer_iterator{_orderer.end()}
+    , _step_orderer_iterator{_allEventsOrderer.end()}
+    , _step_event_orderer_iterator{_eventOrderers[QAO_Event::PRE_UPDATE].end()}
+    , _step_orderer_iterator_advanced{false}
     , _userData{aUserData}
-    , _execon{aExeconAddress} {}
+    , _execon{aExeconAddress}
+    , _mailbox{std::make_unique<qao_detail::QAO_Mailbox>()} {}
 
 QAO_Runtime::~QAO_Runtime() {
     destroyAllOwnedObjects(NO_PROPAGATE_EXCEPTIONS);
@@ -51,114 +86,85 @@ QAO_RuntimeRef QAO_Runtime::nonOwning() {
 }
 
 void QAO_Runtime::attachObject(AvoidNull<QAO_GenericHandle> aHandle) {
-    if (HG_UNLIKELY_CONDITION((aHandle->_flags & QAO_Base::SET_UP_PROPERLY_BIT) == 0)) {
-        HG_UNLIKELY_BRANCH;
-        HG_THROW_TRACED(AssertionFailedError,
-                        0,
-                        "Object to attach ('{}' of type '{}') wasn't set up properly. Do all derived "
-                        "classes call the "
-                        "_setUp() method of their superclasses?",
-                        aHandle->getName(),
-                        typeid(*aHandle).name());
-    }
-
-    HG_VALIDATE_PRECONDITION(aHandle->getRuntime() == nullptr);
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't attach objects from a parallel event.");
+    _validateObjectToAttach(aHandle);
 
     QAO_Base* const objRaw = aHandle.underlying().ptr();
     const auto      id     = _registry.insert(std::move(aHandle));
 
-    auto ordererInsertionResult =
-        _orderer.insert(qao_detail::QAO_HandleFactory::createHandle(objRaw, false));
-    HG_HARD_ASSERT(ordererInsertionResult.second);
-
-    objRaw->_context = {.stepOrdinal     = MIN_STEP_ORDINAL,
-                        .id              = id,
-                        .ordererIterator = ordererInsertionResult.first,
-                        .runtime         = this};
-
-    objRaw->_didAttach(SELF);
-
-    if (HG_UNLIKELY_CONDITION((objRaw->_flags & QAO_Base::ATTACHED_PROPERLY_BIT) == 0)) {
-        HG_UNLIKELY_BRANCH;
-        HG_THROW_TRACED(AssertionFailedError,
-                        0,
-                        "Object to attach ('{}' of type '{}') wasn't attached properly. Do all derived "
-                        "classes call the "
-                        "_didAttach() method of their superclasses?",
-                        objRaw->getName(),
-                        typeid(*objRaw).name());
-    }
+    _insertObject(*objRaw, id);
+    _completeAttaching(*objRaw);
 }
 
 void QAO_Runtime::attachObject(AvoidNull<QAO_GenericHandle> aHandle, QAO_GenericId aSpecificId) {
-    if (HG_UNLIKELY_CONDITION((aHandle->_flags & QAO_Base::SET_UP_PROPERLY_BIT) == 0)) {
-        HG_UNLIKELY_BRANCH;
-        HG_THROW_TRACED(AssertionFailedError,
-                        0,
-                        "Object to attach ('{}' of type '{}') wasn't set up properly. Do all derived "
-                        "classes call the "
-                        "_setUp() method of their superclasses?",
-                        aHandle->getName(),
-                        typeid(*aHandle).name());
-    }
-
-    HG_VALIDATE_PRECONDITION(aHandle->getRuntime() == nullptr);
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't attach objects from a parallel event.");
+    _validateObjectToAttach(aHandle);
 
     QAO_Base* const objRaw = aHandle.underlying().ptr();
     _registry.insertWithId(std::move(aHandle), aSpecificId);
 
-    auto ordererInsertionResult =
-        _orderer.insert(qao_detail::QAO_HandleFactory::createHandle(objRaw, false));
-    HG_HARD_ASSERT(ordererInsertionResult.second);
+    _insertObject(*objRaw, aSpecificId);
+    _completeAttaching(*objRaw);
+}
 
-    objRaw->_context = {.stepOrdinal     = MIN_STEP_ORDINAL,
-                        .id              = aSpecificId,
-                        .ordererIterator = ordererInsertionResult.first,
-                        .runtime         = this};
+void QAO_Runtime::attachObjects(std::span<QAO_GenericHandle> aHandles) {
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't attach objects from a parallel event.");
+    std::vector<QAO_Base*> objects;
+    objects.reserve(aHandles.size());
 
-    objRaw->_didAttach(SELF);
+    for (const auto& handle : aHandles) {
+        HG_VALIDATE_ARGUMENT(!handle.isNull());
+        _validateObjectToAttach(handle);
+        objects.push_back(handle.ptr());
+    }
+    _checkForDuplicates(objects);
 
-    if (HG_UNLIKELY_CONDITION((aHandle->_flags & QAO_Base::ATTACHED_PROPERLY_BIT) == 0)) {
-        HG_UNLIKELY_BRANCH;
-        HG_THROW_TRACED(AssertionFailedError,
-                        0,
-                        "Object to attach ('{}' of type '{}') wasn't attached properly. Do all derived "
-                        "classes call the "
-                        "_didAttach() method of their superclasses?",
-                        aHandle->getName(),
-                        typeid(*aHandle).name());
+    const auto newObjectCount = getObjectCount() + stopz(aHandles.size());
+    _registry.reserve(newObjectCount);
+    _orderer.reserve(newObjectCount);
+    _objectData.reserve(ToSz(newObjectCount));
+
+    for (std::size_t i = 0; i < aHandles.size(); i += 1) {
+        const auto id = _registry.insert(std::move(aHandles[i]));
+        _insertObject(*objects[i], id);
+    }
+
+    // Callbacks are invoked only once all objects are attached
+    for (auto* object : objects) {
+        _completeAttaching(*object);
     }
 }
 
 AvoidNull<QAO_GenericHandle> QAO_Runtime::detachObject(QAO_GenericId aId) {
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't detach objects from a parallel event.");
+
     auto handle = _registry.findObjectWithId(aId);
     HG_VALIDATE_PRECONDITION(!handle.isNull() &&
                              "Object by given ID must exist attached to the Runtime.");
 
     handle->_willDetach(SELF);
-    if (HG_UNLIKELY_CONDITION((handle->_flags & QAO_Base::DETACHED_PROPERLY_BIT) == 0)) {
-        HG_UNLIKELY_BRANCH;
-        HG_THROW_TRACED(AssertionFailedError,
-                        0,
-                        "Object to detach ('{}' of type '{}') wasn't detached properly. Do all derived "
-                        "classes call the "
-                        "_willDetach() method of their superclasses?",
-                        handle->getName(),
-                        typeid(*handle).name());
-    }
-    handle->_context = QAO_Base::Context{};
+    _checkDetachedProperly(*handle);
 
-    const auto index = aId.getIndex();
+    return _removeObject(aId);
+}
 
-    auto rv = _registry.remove(index);
+void QAO_Runtime::scheduleObjectDestruction(QAO_Base& aObject) {
+    HG_VALIDATE_PRECONDITION(aObject.getRuntime() == this && ownsObject(aObject) &&
+                             "Object must be attached to and owned by this Runtime.");
+    HG_VALIDATE_PRECONDITION((!_parallelBatchInProgress || parallelEventObject == &aObject) &&
+                             "An object can only schedule its own destruction from a parallel event.");
 
-    // If current _step_orderer_iterator points to released object, advance it first
-    if (_step_orderer_iterator != _orderer.end() && _step_orderer_iterator->ptr() == handle.ptr()) {
-        _step_orderer_iterator = std::next(_step_orderer_iterator);
+    if (aObject._context.stepOrdinal == DESTRUCTION_PENDING_STEP_ORDINAL) {
+        return;
     }
-    _orderer.erase(qao_detail::QAO_HandleFactory::createHandle(handle.ptr(), false));
+    aObject._context.stepOrdinal = DESTRUCTION_PENDING_STEP_ORDINAL;
 
-    return rv;
+    if (_parallelBatchInProgress) {
+        std::lock_guard<std::mutex> lock{_deferredDestructionMutex};
+        _deferredDestructionQueue.push_back(aObject.getId());
+    } else {
+        _deferredDestructionQueue.push_back(aObject.getId());
+    }
 }
 
 AvoidNull<QAO_GenericHandle> QAO_Runtime::detachObject(QAO_Base& aObject) {
@@ -170,6 +176,52 @@ AvoidNull<QAO_GenericHandle> QAO_Runtime::detachObject(NeverNull<QAO_GenericHand
     return detachObject(*aObject);
 }
 
+std::vector<QAO_GenericHandle> QAO_Runtime::detachObjects(std::span<const QAO_GenericId> aIds) {
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't detach objects from a parallel event.");
+
+    std::vector<QAO_Base*> objects;
+    objects.reserve(aIds.size());
+
+    for (const auto& id : aIds) {
+        auto handle = _registry.findObjectWithId(id);
+        HG_VALIDATE_PRECONDITION(!handle.isNull() &&
+                                 "Objects by given IDs must exist attached to the Runtime.");
+        objects.push_back(handle.ptr());
+    }
+    _checkForDuplicates(objects);
+
+    // Callbacks are invoked while all objects are still attached
+    for (std::size_t i = 0; i < objects.size(); i += 1) {
+        try {
+            objects[i]->_willDetach(SELF);
+            _checkDetachedProperly(*objects[i]);
+        } catch (...) {
+            // Nothing is detached - tell the objects which were already told otherwise that
+            // they stay attached after all
+            for (std::size_t j = 0; j < i; j += 1) {
+                try {
+                    _completeAttaching(*objects[j]);
+                } catch (const std::exception& ex) {
+                    HG_LOG_ERROR(LOG_ID,
+                                 "detachObjects - Encountered an error while restoring object '{}' "
+                                 "after a failed detach. Details: {}",
+                                 objects[j]->getName(),
+                                 ex.what());
+                }
+            }
+            throw;
+        }
+    }
+
+    std::vector<QAO_GenericHandle> result;
+    result.reserve(aIds.size());
+    for (const auto& id : aIds) {
+        result.push_back(_removeObject(id));
+    }
+
+    return result;
+}
+
 void QAO_Runtime::destroyAllOwnedObjects(bool aPropagateExceptions) {
     std::vector<QAO_GenericId> objectsToErase;
     for (auto& object : SELF) {
@@ -215,64 +267,179 @@ void QAO_Runtime::destroyAllOwnedObjects(bool aPropagateExceptions) {
     }
 }
 
+std::span<QAO_Base* const> QAO_Runtime::getInstancesOf(const QAO_ClassMetadata& aClass) const {
+    const auto iter = _classInstances.find(&aClass);
+    if (iter == _classInstances.end()) {
+        return {};
+    }
+    return iter->second;
+}
+
+PZInteger QAO_Runtime::forEachInstanceOf(const QAO_ClassMetadata&               aClass,
+                                         const std::function<void(QAO_Base&)>& aFunc) {
+    // Work on a snapshot of IDs so that `aFunc` can freely attach and detach objects
+    std::vector<QAO_GenericId> ids;
+    _collectInstancesOf(aClass, ids);
+
+    PZInteger visitedCount = 0;
+    for (const auto& id : ids) {
+        auto handle = _registry.findObjectWithId(id);
+        if (handle.isNull()) {
+            continue;
+        }
+        aFunc(*handle);
+        visitedCount += 1;
+    }
+    return visitedCount;
+}
+
 void QAO_Runtime::updateExecutionPriorityForObject(QAO_Base& object, int newPriority) {
     assert(find(object.getId()).ptr() == &object);
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress &&
+                             "Can't change execution priorities from a parallel event.");
+
+    auto& objectData = _objectData[ToSz(object.getId().getIndex())];
+
+    // If a step orderer iterator points to the object being moved, advance it first
+    // (otherwise it would follow the object to its new position)
+    _advanceStepOrdererIteratorsIfAt(objectData);
 
-    _orderer.erase(qao_detail::QAO_HandleFactory::createHandle(&object, false));
     object._executionPriority = newPriority;
+    _repositionInOrderers(object);
+}
+
+void QAO_Runtime::updateExecutionPriorities(const std::function<int(const QAO_Base&)>& aGetNewPriority) {
+    HG_VALIDATE_PRECONDITION(_currentEvent == QAO_Event::NONE &&
+                             "Can't change execution priorities in bulk while a step is in progress.");
+
+    // Go through objects in their current order, so that a stable sort keeps the relative order
+    // of objects which end up in the same bucket
+    std::vector<QAO_Base*> objects;
+    objects.reserve(ToSz(getObjectCount()));
+    for (const auto& handle : _orderer) {
+        auto* object               = handle.ptr();
+        object->_executionPriority = aGetNewPriority(*object);
+        objects.push_back(object);
+    }
+    std::stable_sort(objects.begin(), objects.end(), [](const QAO_Base* aLhs, const QAO_Base* aRhs) {
+        if (aLhs->getExecutionPriority() != aRhs->getExecutionPriority()) {
+            return aLhs->getExecutionPriority() > aRhs->getExecutionPriority();
+        }
+        return aLhs->getExeconThreshold() < aRhs->getExeconThreshold();
+    });
+
+    // Rebuild the orderers; as objects are inserted in order, each one is appended to the last
+    // bucket (or a new one after it)
+    _orderer.clear();
+    _allEventsOrderer.clear();
+    for (auto& orderer : _eventOrderers) {
+        orderer.clear();
+    }
+    for (auto* object : objects) {
+        object->_context.ordererIterator = _insertIntoOrderers(*object, object->getId().getIndex());
+    }
+}
+
+void QAO_Runtime::updateExeconThresholdForObject(QAO_Base& aObject, QAO_ExeCon aNewThreshold) {
+    assert(find(aObject.getId()).ptr() == &aObject);
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress &&
+                             "Can't change execon thresholds from a parallel event.");
+
+    const auto& objectData = _objectData[ToSz(aObject.getId().getIndex())];
+
+    // Objects are ordered by their execon thresholds within the same priority, so the object
+    // can move just like when its priority changes
+    _advanceStepOrdererIteratorsIfAt(objectData);
 
-    const auto ord_pair = _orderer.insert(
-        qao_detail::QAO_HandleFactory::createHandle(&object,
-                                                    false)); // first = iterator, second = added_new
-    object._context.ordererIterator = ord_pair.first;
+    aObject._execonThreshold = aNewThreshold;
+    _repositionInOrderers(aObject);
+}
+
+void QAO_Runtime::updateNameForObject(QAO_Base& aObject, QAO_NameRef aNewName) {
+    assert(find(aObject.getId()).ptr() == &aObject);
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress && "Can't rename objects from a parallel event.");
+
+    const auto index = aObject.getId().getIndex();
+
+    _removeFromNameIndex(aObject, index);
+    try {
+        aObject._setName(aNewName);
+    } catch (...) {
+        _addToNameIndex(aObject, index);
+        throw;
+    }
+    _addToNameIndex(aObject, index);
 }
 
 // Execution
 
 void QAO_Runtime::startStep() {
-    _currentEvent          = QAO_Event::PRE_UPDATE;
-    _step_orderer_iterator = _orderer.begin();
+    _currentEvent = QAO_Event::PRE_UPDATE;
+    _resetStepOrdererIterators(QAO_Event::PRE_UPDATE);
 }
 
 void QAO_Runtime::advanceStep(bool& done, std::int32_t eventFlags) {
-    done                      = false;
-    QAO_OrdererIterator& curr = _step_orderer_iterator;
+    done = false;
 
     //-----------------------------------------//
     for (std::int32_t i = _currentEvent; i < QAO_Event::EVENT_COUNT; i += 1) {
         if ((eventFlags & (1 << i)) == 0) {
+            if (i + 1 < QAO_Event::EVENT_COUNT) {
+                _resetStepOrdererIterators(static_cast<QAO_Event::Enum>(i + 1));
+            }
             continue;
         }
 
         auto ev       = static_cast<QAO_Event::Enum>(i);
         _currentEvent = ev;
 
-        while (curr != _orderer.end()) {
-            auto* const instance = curr->ptr();
+        // Only objects which handle the event are in its orderer or in the all-events orderer
+        while (auto* const currPtr = _getNextStepOrdererIterator(ev)) {
+            QAO_OrdererIterator& curr     = *currPtr;
+            auto* const          instance = curr->ptr();
+
+            if (_workerPool != nullptr && _isParallel(*instance, ev)) {
+                _executeParallelBatch(ev);
+                continue;
+            }
 
-            char currBeforeEvent[sizeof(curr)];
-            std::memcpy(currBeforeEvent, &curr, sizeof(curr));
+            if (_execon && *_execon < instance->getExeconThreshold()) {
+                // Objects with the same priority are ordered by ascending execon threshold, so
+                // none of the remaining ones with this priority in the same orderer can execute
+                // either
+                const auto& orderer =
+                    (currPtr == &_step_orderer_iterator) ? _allEventsOrderer : _eventOrderers[ToSz(i)];
+                curr = orderer.nextPriority(curr);
+                continue;
+            }
 
-            if ((!_execon || (*_execon >= instance->getExeconThreshold())) &&
-                instance->_context.stepOrdinal < _step_counter) //
-            {
+            _step_orderer_iterator_advanced = false;
+
+            if (instance->_context.stepOrdinal < _step_counter) {
                 instance->_context.stepOrdinal = _step_counter;
-                instance->_callEvent(ev);
+                if (_profilingEnabled) {
+                    _callEventProfiled(*instance, ev);
+                } else {
+                    instance->_callEvent(ev);
+                }
                 // After calling _callEvent, the instance variable must no longer be used until
                 // reassigned, because an instance is allowed to delete itself inside of an event
                 // implementation
             }
             // If the step orderer iterator wasn't advanced by the _callEvent invocation (by the callee
-            // deleting itself), it must be advanced here. Raw memory compare is necessary because
-            // the iterator being compared then becomes invalid when deleting the list node.
-            const bool stepIteratorStayedTheSame =
-                (std::memcmp(currBeforeEvent, &curr, sizeof(curr)) == 0);
-            if (stepIteratorStayedTheSame && curr != _orderer.end()) {
+            // deleting itself or changing its priority), it must be advanced here.
+            if (!_step_orderer_iterator_advanced) {
                 curr = std::next(curr);
             }
         }
 
-        curr = _orderer.begin();
+        // The step orderer iterators stay at the ends of their orderers while deferred destructions
+        // are carried out, so if one of them throws, resuming the step will just carry out the rest
+        _destroyDeferredObjects();
+
+        if (i + 1 < QAO_Event::EVENT_COUNT) {
+            _resetStepOrdererIterators(static_cast<QAO_Event::Enum>(i + 1));
+        }
         _step_counter += 1;
     }
     //-----------------------------------------//
@@ -310,6 +477,24 @@ void QAO_Runtime::setUserData(std::nullptr_t) {
     _userData.reset(nullptr);
 }
 
+// Mailbox
+
+void QAO_Runtime::postTask(std::function<void(QAO_Runtime&)> aTask) {
+    _mailbox->postTask(std::move(aTask));
+}
+
+void QAO_Runtime::postObject(AvoidNull<QAO_GenericHandle> aHandle) {
+    _mailbox->postObject(MoveToUnderlying(std::move(aHandle)));
+}
+
+void QAO_Runtime::transferObject(QAO_Base& aObject, QAO_Runtime& aTargetRuntime) {
+    aTargetRuntime.postObject(detachObject(aObject));
+}
+
+PZInteger QAO_Runtime::deliverMail() {
+    return _mailbox->deliver(SELF);
+}
+
 // Execon
 
 void QAO_Runtime::setExeconAddress(const QAO_ExeCon* aExeconAddress) {
@@ -320,6 +505,63 @@ const QAO_ExeCon* QAO_Runtime::getExeconAddress() const {
     return _execon;
 }
 
+// Parallel execution
+
+void QAO_Runtime::setParallelWorkerCount(PZInteger aWorkerCount) {
+    HG_VALIDATE_ARGUMENT(aWorkerCount >= 0);
+    HG_VALIDATE_PRECONDITION(_currentEvent == QAO_Event::NONE &&
+                             "Can't change the worker count while a step is in progress.");
+
+    if (aWorkerCount == getParallelWorkerCount()) {
+        return;
+    }
+    _workerPool.reset();
+    if (aWorkerCount > 0) {
+        _workerPool = std::make_unique<qao_detail::QAO_WorkerPool>(aWorkerCount);
+    }
+}
+
+PZInteger QAO_Runtime::getParallelWorkerCount() const {
+    return (_workerPool != nullptr) ? _workerPool->getWorkerCount() : 0;
+}
+
+// Profiling
+
+void QAO_Runtime::setProfilingEnabled(bool aEnabled) {
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress &&
+                             "Can't toggle profiling from a parallel event.");
+    _profilingEnabled = aEnabled;
+}
+
+bool QAO_Runtime::isProfilingEnabled() const {
+    return _profilingEnabled;
+}
+
+std::vector<QAO_EventStats> QAO_Runtime::getProfilingStats() const {
+    std::vector<QAO_EventStats> result;
+    for (const auto& [klass, entry] : _profilingEntries) {
+        for (std::size_t i = 0; i < entry.callCounts.size(); i += 1) {
+            if (entry.callCounts[i] == 0) {
+                continue;
+            }
+            result.push_back({.classMetadata = klass,
+                              .event         = static_cast<QAO_Event::Enum>(i),
+                              .callCount     = entry.callCounts[i],
+                              .totalTime     = entry.totalTimes[i]});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const QAO_EventStats& aLhs, const QAO_EventStats& aRhs) {
+        return aLhs.totalTime > aRhs.totalTime;
+    });
+    return result;
+}
+
+void QAO_Runtime::resetProfilingStats() {
+    HG_VALIDATE_PRECONDITION(!_parallelBatchInProgress &&
+                             "Can't reset profiling stats from a parallel event.");
+    _profilingEntries.clear();
+}
+
 // Orderer/instance iterations
 
 QAO_OrdererIterator QAO_Runtime::begin() {
@@ -354,6 +596,467 @@ QAO_OrdererConstReverseIterator QAO_Runtime::crend() const {
     return _orderer.crend();
 }
 
+// MARK: Private
+
+void QAO_Runtime::_validateObjectToAttach(const QAO_GenericHandle& aHandle) {
+    if (HG_UNLIKELY_CONDITION((aHandle->_flags & QAO_Base::SET_UP_PROPERLY_BIT) == 0)) {
+        HG_UNLIKELY_BRANCH;
+        HG_THROW_TRACED(AssertionFailedError,
+                        0,
+                        "Object to attach ('{}' of type '{}') wasn't set up properly. Do all derived "
+                        "classes call the "
+                        "_setUp() method of their superclasses?",
+                        aHandle->getName(),
+                        typeid(*aHandle).name());
+    }
+
+    HG_VALIDATE_PRECONDITION(aHandle->getRuntime() == nullptr);
+}
+
+void QAO_Runtime::_insertObject(QAO_Base& aObject, QAO_GenericId aId) {
+    const auto ordererIter = _insertIntoOrderers(aObject, aId.getIndex());
+    _addToClassInstances(aObject, aId.getIndex());
+    _addToNameIndex(aObject, aId.getIndex());
+
+    aObject._context = {.stepOrdinal     = MIN_STEP_ORDINAL,
+                        .id              = aId,
+                        .ordererIterator = ordererIter,
+                        .runtime         = this};
+}
+
+void QAO_Runtime::_completeAttaching(QAO_Base& aObject) {
+    aObject._didAttach(SELF);
+
+    if (HG_UNLIKELY_CONDITION((aObject._flags & QAO_Base::ATTACHED_PROPERLY_BIT) == 0)) {
+        HG_UNLIKELY_BRANCH;
+        HG_THROW_TRACED(AssertionFailedError,
+                        0,
+                        "Object to attach ('{}' of type '{}') wasn't attached properly. Do all derived "
+                        "classes call the "
+                        "_didAttach() method of their superclasses?",
+                        aObject.getName(),
+                        typeid(aObject).name());
+    }
+}
+
+void QAO_Runtime::_checkForDuplicates(std::vector<QAO_Base*> aObjects) {
+    std::sort(aObjects.begin(), aObjects.end());
+    const auto iter = std::adjacent_find(aObjects.begin(), aObjects.end());
+    if (iter != aObjects.end()) {
+        HG_THROW_TRACED(InvalidArgumentError,
+                        0,
+                        "Object '{}' of type '{}' was passed more than once.",
+                        (*iter)->getName(),
+                        typeid(**iter).name());
+    }
+}
+
+void QAO_Runtime::_checkDetachedProperly(QAO_Base& aObject) {
+    if (HG_UNLIKELY_CONDITION((aObject._flags & QAO_Base::DETACHED_PROPERLY_BIT) == 0)) {
+        HG_UNLIKELY_BRANCH;
+        HG_THROW_TRACED(AssertionFailedError,
+                        0,
+                        "Object to detach ('{}' of type '{}') wasn't detached properly. Do all derived "
+                        "classes call the "
+                        "_willDetach() method of their superclasses?",
+                        aObject.getName(),
+                        typeid(aObject).name());
+    }
+}
+
+QAO_GenericHandle QAO_Runtime::_removeObject(QAO_GenericId aId) {
+    auto handle = _registry.findObjectWithId(aId);
+
+    const auto index = aId.getIndex();
+    _removeFromNameIndex(*handle, index);
+
+    const auto ordererIter = handle->_context.ordererIterator;
+    handle->_context       = QAO_Base::Context{};
+
+    _removeFromClassInstances(index);
+
+    auto rv = _registry.remove(index);
+
+    _eraseFromOrderers(ordererIter, index);
+
+    return rv;
+}
+
+QAO_OrdererIterator QAO_Runtime::_insertIntoOrderers(QAO_Base& aObject, QAO_Index aIndex) {
+    const auto handle = qao_detail::QAO_HandleFactory::createHandle(&aObject, false);
+
+    if (ToSz(aIndex) >= _objectData.size()) {
+        _objectData.resize(ToSz(aIndex) + 1);
+    }
+    auto& objectData = _objectData[ToSz(aIndex)];
+
+    const auto* metadata     = aObject.getClassMetadata();
+    objectData.classMetadata = metadata;
+    objectData.eventFlags    = metadata ? metadata->getHandledEvents() : QAO_ALL_EVENT_FLAGS;
+    objectData.parallelFlags = metadata ? metadata->getParallelEvents() : QAO_NO_EVENT_FLAGS;
+
+    _ordererSequence += 1;
+    objectData.ordererSequence = _ordererSequence;
+
+    objectData.iterators.fill({});
+    if (HandlesAllEvents(objectData.eventFlags)) {
+        // Fast path (it's the same orderer for every event)
+        objectData.allEventsIterator = _allEventsOrderer.insert(handle);
+    } else {
+        objectData.allEventsIterator = {};
+        for (std::size_t i = 0; i < objectData.iterators.size(); i += 1) {
+            if ((objectData.eventFlags & QAO_EventFlag(static_cast<QAO_Event::Enum>(i))) != 0) {
+                objectData.iterators[i] = _eventOrderers[i].insert(handle);
+            }
+        }
+    }
+
+    return _orderer.insert(handle);
+}
+
+void QAO_Runtime::_eraseFromOrderers(QAO_OrdererIterator aOrdererIterator, QAO_Index aIndex) {
+    auto& objectData = _objectData[ToSz(aIndex)];
+
+    // If a step orderer iterator points to the released object, advance it first
+    _advanceStepOrdererIteratorsIfAt(objectData);
+
+    if (HandlesAllEvents(objectData.eventFlags)) {
+        _allEventsOrderer.erase(objectData.allEventsIterator);
+    } else {
+        for (std::size_t i = 0; i < objectData.iterators.size(); i += 1) {
+            if ((objectData.eventFlags & QAO_EventFlag(static_cast<QAO_Event::Enum>(i))) != 0) {
+                _eventOrderers[i].erase(objectData.iterators[i]);
+            }
+        }
+    }
+    objectData = {};
+
+    _orderer.erase(aOrdererIterator);
+}
+
+void QAO_Runtime::_repositionInOrderers(QAO_Base& aObject) {
+    auto& objectData = _objectData[ToSz(aObject.getId().getIndex())];
+
+    if (!_orderer.reposition(aObject._context.ordererIterator)) {
+        return; // Still in the same bucket (in all orderers)
+    }
+    // Appended to its new bucket, so it comes after all objects which are already there
+    _ordererSequence += 1;
+    objectData.ordererSequence = _ordererSequence;
+
+    if (HandlesAllEvents(objectData.eventFlags)) {
+        _allEventsOrderer.reposition(objectData.allEventsIterator);
+        return;
+    }
+    for (std::size_t i = 0; i < objectData.iterators.size(); i += 1) {
+        if ((objectData.eventFlags & QAO_EventFlag(static_cast<QAO_Event::Enum>(i))) != 0) {
+            _eventOrderers[i].reposition(objectData.iterators[i]);
+        }
+    }
+}
+
+bool QAO_Runtime::_isParallel(const QAO_Base& aObject, QAO_Event::Enum aEvent) const {
+    const auto& objectData = _objectData[ToSz(aObject.getId().getIndex())];
+    return (objectData.parallelFlags & QAO_EventFlag(aEvent)) != 0;
+}
+
+void QAO_Runtime::_executeParallelBatch(QAO_Event::Enum aEvent) {
+    const auto batchBegin = std::make_pair(_step_orderer_iterator, _step_event_orderer_iterator);
+
+    // The batch consists of all consecutive objects with the same priority which are parallel
+    // for this event (objects with a different priority must run before/after all of them)
+    const int priority = (*_getNextStepOrdererIterator(aEvent))->ptr()->getExecutionPriority();
+
+    _parallelBatch.clear();
+    while (auto* const curr = _getNextStepOrdererIterator(aEvent)) {
+        auto* const instance = (*curr)->ptr();
+        if (instance->getExecutionPriority() != priority || !_isParallel(*instance, aEvent)) {
+            break;
+        }
+        if ((!_execon || (*_execon >= instance->getExeconThreshold())) &&
+            instance->_context.stepOrdinal < _step_counter) //
+        {
+            _parallelBatch.push_back(instance);
+        }
+        ++(*curr);
+    }
+    const auto batchEnd = std::make_pair(_step_orderer_iterator, _step_event_orderer_iterator);
+
+    // Objects can't be attached, detached or moved while the batch is executing (this is
+    // enforced), so `batchEnd` stays valid. If an object throws, the step orderer iterators stay
+    // at the start of the batch; objects which already executed the event will be skipped when
+    // the step is resumed because their step ordinals were updated.
+    std::tie(_step_orderer_iterator, _step_event_orderer_iterator) = batchBegin;
+    _parallelBatchInProgress                                       = true;
+    try {
+        _workerPool->run(stopz(_parallelBatch.size()), [this, aEvent](PZInteger aBegin, PZInteger aEnd) {
+            if (!_profilingEnabled) {
+                for (PZInteger i = aBegin; i < aEnd; i += 1) {
+                    auto* const        instance    = _parallelBatch[pztos(i)];
+                    ParallelEventScope scope{*instance};
+                    instance->_context.stepOrdinal = _step_counter;
+                    instance->_callEvent(aEvent);
+                }
+                return;
+            }
+
+            // Samples are summed up locally for as long as consecutive objects are of the same
+            // class (which they mostly are in a batch), and added to the stats only then, so
+            // that the threads don't contend over `_profilingMutex` for every object
+            const QAO_ClassMetadata* currentClass = nullptr;
+            std::int64_t             callCount    = 0;
+            std::chrono::nanoseconds time{0};
+
+            const auto flush = [&]() {
+                if (callCount > 0) {
+                    std::lock_guard<std::mutex> lock{_profilingMutex};
+                    _addProfilingSample(currentClass, aEvent, callCount, time);
+                }
+            };
+
+            for (PZInteger i = aBegin; i < aEnd; i += 1) {
+                auto* const instance = _parallelBatch[pztos(i)];
+                const auto* klass    = _objectData[ToSz(instance->getId().getIndex())].classMetadata;
+                if (klass != currentClass) {
+                    flush();
+                    currentClass = klass;
+                    callCount    = 0;
+                    time         = std::chrono::nanoseconds{0};
+                }
+
+                instance->_context.stepOrdinal = _step_counter;
+                const auto start               = std::chrono::steady_clock::now();
+                {
+                    ParallelEventScope scope{*instance};
+                    instance->_callEvent(aEvent);
+                }
+                callCount += 1;
+                time += std::chrono::steady_clock::now() - start;
+            }
+            flush();
+        });
+    } catch (...) {
+        _parallelBatchInProgress = false;
+        throw;
+    }
+    _parallelBatchInProgress = false;
+
+    std::tie(_step_orderer_iterator, _step_event_orderer_iterator) = batchEnd;
+}
+
+void QAO_Runtime::_callEventProfiled(QAO_Base& aObject, QAO_Event::Enum aEvent) {
+    // The object is allowed to delete itself in the event, so get its class beforehand
+    const auto* klass = _objectData[ToSz(aObject.getId().getIndex())].classMetadata;
+
+    const auto start = std::chrono::steady_clock::now();
+    aObject._callEvent(aEvent);
+    _addProfilingSample(klass, aEvent, 1, std::chrono::steady_clock::now() - start);
+}
+
+void QAO_Runtime::_addProfilingSample(const QAO_ClassMetadata* aClass,
+                                      QAO_Event::Enum          aEvent,
+                                      std::int64_t             aCallCount,
+                                      std::chrono::nanoseconds aTime) {
+    auto& entry = _profilingEntries[aClass];
+    entry.callCounts[ToSz(aEvent)] += aCallCount;
+    entry.totalTimes[ToSz(aEvent)] += aTime;
+}
+
+void QAO_Runtime::_addToNameIndex(QAO_Base& aObject, QAO_Index aIndex) {
+    const auto name = aObject.getName();
+
+    auto iter = _nameIndex.find(name);
+    if (iter == _nameIndex.end()) {
+        iter = _nameIndex.emplace(std::string{name}, std::vector<QAO_Base*>{}).first;
+    }
+    auto& objects = iter->second;
+    _objectData[ToSz(aIndex)].nameIndexPosition = static_cast<std::int32_t>(objects.size());
+    objects.push_back(&aObject);
+}
+
+void QAO_Runtime::_destroyDeferredObjects() {
+    // Objects can schedule more destructions while they're being destroyed (from `_willDetach()`
+    // or `_tearDown()`), so keep going until the queue is empty
+    while (!_deferredDestructionQueue.empty()) {
+        auto& batch = _deferredDestructionBatch;
+        std::swap(batch, _deferredDestructionQueue);
+
+        for (std::size_t i = 0; i < batch.size(); i += 1) {
+            // The object could have been destroyed or detached in the meantime
+            if (_registry.findObjectWithId(batch[i]).isNull()) {
+                continue;
+            }
+            try {
+                MoveToUnderlying(detachObject(batch[i])).reset();
+            } catch (...) {
+                // Keep the rest for when the step is resumed
+                _deferredDestructionQueue.insert(_deferredDestructionQueue.begin(),
+                                                 batch.begin() + static_cast<std::ptrdiff_t>(i + 1),
+                                                 batch.end());
+                batch.clear();
+                throw;
+            }
+        }
+        batch.clear();
+    }
+}
+
+void QAO_Runtime::_addToClassInstances(QAO_Base& aObject, QAO_Index aIndex) {
+    auto& objectData = _objectData[ToSz(aIndex)];
+    if (objectData.classMetadata == nullptr) {
+        return;
+    }
+    auto& instances               = _classInstances[objectData.classMetadata];
+    objectData.classInstanceIndex = static_cast<std::int32_t>(instances.size());
+    instances.push_back(&aObject);
+}
+
+void QAO_Runtime::_removeFromClassInstances(QAO_Index aIndex) {
+    auto& objectData = _objectData[ToSz(aIndex)];
+    if (objectData.classMetadata == nullptr) {
+        return;
+    }
+    auto&      instances = _classInstances[objectData.classMetadata];
+    const auto pos       = ToSz(objectData.classInstanceIndex);
+    assert(pos < instances.size());
+
+    // Swap with the last instance and pop, so that removal is O(1)
+    if (pos + 1 < instances.size()) {
+        auto* last     = instances.back();
+        instances[pos] = last;
+
+        auto& lastData              = _objectData[ToSz(last->getId().getIndex())];
+        lastData.classInstanceIndex = objectData.classInstanceIndex;
+    }
+    instances.pop_back();
+    objectData.classInstanceIndex = -1;
+}
+
+void QAO_Runtime::_collectInstancesOf(const QAO_ClassMetadata&    aClass,
+                                      std::vector<QAO_GenericId>& aIds) const {
+    for (const auto* instance : getInstancesOf(aClass)) {
+        aIds.push_back(instance->getId());
+    }
+    for (const auto* childClass : aClass.getChildClasses()) {
+        _collectInstancesOf(*childClass, aIds);
+    }
+}
+
+void QAO_Runtime::_removeFromNameIndex(QAO_Base& aObject, QAO_Index aIndex) {
+    const auto iter = _nameIndex.find(aObject.getName());
+    assert(iter != _nameIndex.end());
+
+    auto&      objectData = _objectData[ToSz(aIndex)];
+    auto&      objects    = iter->second;
+    const auto pos        = ToSz(objectData.nameIndexPosition);
+    assert(pos < objects.size() && objects[pos] == &aObject);
+    objectData.nameIndexPosition = -1;
+
+    if (objects.size() == 1) {
+        _nameIndex.erase(iter);
+        return;
+    }
+
+    // Swap with the last object and pop, so that removal is O(1) (most objects share the default
+    // name, so the vectors can get long)
+    if (pos + 1 < objects.size()) {
+        auto* last   = objects.back();
+        objects[pos] = last;
+
+        auto& lastData             = _objectData[ToSz(last->getId().getIndex())];
+        lastData.nameIndexPosition = static_cast<std::int32_t>(pos);
+    }
+    objects.pop_back();
+}
+
+QAO_Base* QAO_Runtime::_findByName(std::string_view      aName,
+                                   const std::type_info& aTypeInfo,
+                                   InstanceOfPredicate   aIsInstanceOf) const {
+    const auto iter = _nameIndex.find(aName);
+    if (iter == _nameIndex.end()) {
+        return nullptr;
+    }
+
+    const bool  anyType   = (aTypeInfo == typeid(QAO_Base));
+    const auto* typeClass = anyType ? nullptr : QAO_ClassMetadata::get(aTypeInfo);
+    QAO_Base*   result    = nullptr;
+
+    for (auto* object : iter->second) {
+        if (result != nullptr && object->getExecutionPriority() <= result->getExecutionPriority()) {
+            continue;
+        }
+        if (!anyType) {
+            // `dynamic_cast` is needed only if either class isn't registered (or the superclasses
+            // weren't resolved yet - see `QAO_InitializeMetadata()`)
+            const auto* objectClass = _objectData[ToSz(object->getId().getIndex())].classMetadata;
+            const bool  isInstance  = (typeClass != nullptr && objectClass != nullptr &&
+                                      objectClass->getSuperclass() != nullptr)
+                                          ? objectClass->isSubclassOf(*typeClass)
+                                          : aIsInstanceOf(*object);
+            if (!isInstance) {
+                continue;
+            }
+        }
+        result = object;
+    }
+
+    return result;
+}
+
+void QAO_Runtime::_advanceStepOrdererIteratorIfAt(QAO_OrdererIterator aIterator) {
+    if (aIterator == QAO_OrdererIterator{}) {
+        return;
+    }
+
+    // Iterators into different orderers never compare equal, so this can only match an iterator
+    // into the all-events orderer or into the orderer of the current event
+    if (_step_orderer_iterator == aIterator) {
+        _step_orderer_iterator          = std::next(_step_orderer_iterator);
+        _step_orderer_iterator_advanced = true;
+    } else if (_step_event_orderer_iterator == aIterator) {
+        _step_event_orderer_iterator    = std::next(_step_event_orderer_iterator);
+        _step_orderer_iterator_advanced = true;
+    }
+}
+
+void QAO_Runtime::_advanceStepOrdererIteratorsIfAt(const ObjectData& aObjectData) {
+    _advanceStepOrdererIteratorIfAt(aObjectData.allEventsIterator);
+    for (const auto& iter : aObjectData.iterators) {
+        _advanceStepOrdererIteratorIfAt(iter);
+    }
+}
+
+void QAO_Runtime::_resetStepOrdererIterators(QAO_Event::Enum aEvent) {
+    _step_orderer_iterator       = _allEventsOrderer.begin();
+    _step_event_orderer_iterator = _eventOrderers[ToSz(aEvent)].begin();
+}
+
+QAO_OrdererIterator* QAO_Runtime::_getNextStepOrdererIterator(QAO_Event::Enum aEvent) {
+    // Both orderers are in the order of execution, so this merges them
+    const bool allEventsDone = (_step_orderer_iterator == _allEventsOrderer.end());
+    const bool eventDone     = (_step_event_orderer_iterator == _eventOrderers[ToSz(aEvent)].end());
+    if (allEventsDone) {
+        return eventDone ? nullptr : &_step_event_orderer_iterator;
+    }
+    if (eventDone) {
+        return &_step_orderer_iterator;
+    }
+    return _executesBefore(*_step_event_orderer_iterator->ptr(), *_step_orderer_iterator->ptr())
+               ? &_step_event_orderer_iterator
+               : &_step_orderer_iterator;
+}
+
+bool QAO_Runtime::_executesBefore(const QAO_Base& aLhs, const QAO_Base& aRhs) const {
+    if (aLhs.getExecutionPriority() != aRhs.getExecutionPriority()) {
+        return aLhs.getExecutionPriority() > aRhs.getExecutionPriority();
+    }
+    if (aLhs.getExeconThreshold() != aRhs.getExeconThreshold()) {
+        return aLhs.getExeconThreshold() < aRhs.getExeconThreshold();
+    }
+    return _objectData[ToSz(aLhs.getId().getIndex())].ordererSequence <
+           _objectData[ToSz(aRhs.getId().getIndex())].ordererSequence;
+}
+
 } // namespace qao
 HOBGOBLIN_NAMESPACE_END
 
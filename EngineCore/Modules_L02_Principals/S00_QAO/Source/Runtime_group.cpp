@@ -0,0 +1,76 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <Hobgoblin/HGExcept.hpp>
+#include <Hobgoblin/QAO/Runtime.hpp>
+#include <Hobgoblin/QAO/Runtime_group.hpp>
+
+#include "Worker_pool.hpp"
+
+#include <algorithm>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+
+QAO_RuntimeGroup::QAO_RuntimeGroup(PZInteger aWorkerCount) {
+    HG_VALIDATE_ARGUMENT(aWorkerCount >= 0);
+    if (aWorkerCount > 0) {
+        _workerPool = std::make_unique<qao_detail::QAO_WorkerPool>(aWorkerCount);
+    }
+}
+
+QAO_RuntimeGroup::~QAO_RuntimeGroup() = default;
+
+void QAO_RuntimeGroup::addRuntime(QAO_Runtime& aRuntime) {
+    HG_VALIDATE_PRECONDITION(std::find(_runtimes.begin(), _runtimes.end(), &aRuntime) ==
+                                 _runtimes.end() &&
+                             "Runtime is already in the group.");
+    _runtimes.push_back(&aRuntime);
+}
+
+void QAO_RuntimeGroup::removeRuntime(QAO_Runtime& aRuntime) {
+    const auto iter = std::find(_runtimes.begin(), _runtimes.end(), &aRuntime);
+    HG_VALIDATE_PRECONDITION(iter != _runtimes.end() && "Runtime is not in the group.");
+    _runtimes.erase(iter);
+}
+
+PZInteger QAO_RuntimeGroup::getRuntimeCount() const {
+    return stopz(_runtimes.size());
+}
+
+void QAO_RuntimeGroup::step(std::int32_t aEventFlags) {
+    // Mail is delivered to all runtimes before any of them starts its step, so that everything
+    // posted during a step is delivered at the start of the next one, no matter in which order
+    // the runtimes happen to be stepped
+    _forEachRuntime([](QAO_Runtime& aRuntime) {
+        aRuntime.deliverMail();
+    });
+    _forEachRuntime([aEventFlags](QAO_Runtime& aRuntime) {
+        aRuntime.startStep();
+        bool done = false;
+        aRuntime.advanceStep(done, aEventFlags);
+    });
+}
+
+// MARK: Private
+
+void QAO_RuntimeGroup::_forEachRuntime(const std::function<void(QAO_Runtime&)>& aFunc) {
+    const auto job = [this, &aFunc](PZInteger aBegin, PZInteger aEnd) {
+        for (PZInteger i = aBegin; i < aEnd; i += 1) {
+            aFunc(*_runtimes[pztos(i)]);
+        }
+    };
+
+    if (_workerPool == nullptr) {
+        job(0, getRuntimeCount());
+    } else {
+        _workerPool->run(getRuntimeCount(), job);
+    }
+}
+
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
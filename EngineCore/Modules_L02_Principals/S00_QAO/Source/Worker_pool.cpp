@@ -0,0 +1,138 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Worker_pool.hpp"
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <algorithm>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+namespace qao_detail {
+
+namespace {
+// Items are handed out in chunks so that threads don't contend over `_nextItem` too much
+// when individual items are cheap; with this many chunks per thread the load still evens
+// out when they aren't.
+constexpr PZInteger CHUNKS_PER_THREAD = 8;
+} // namespace
+
+QAO_WorkerPool::QAO_WorkerPool(PZInteger aWorkerCount) {
+    HG_VALIDATE_ARGUMENT(aWorkerCount > 0);
+
+    _workers.reserve(pztos(aWorkerCount));
+    for (PZInteger i = 0; i < aWorkerCount; i += 1) {
+        _workers.emplace_back(&QAO_WorkerPool::_workerBody, this);
+    }
+}
+
+QAO_WorkerPool::~QAO_WorkerPool() {
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _stopped = true;
+    }
+    _cv_start.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+PZInteger QAO_WorkerPool::getWorkerCount() const {
+    return stopz(_workers.size());
+}
+
+void QAO_WorkerPool::run(PZInteger aItemCount, const Job& aJob) {
+    if (aItemCount <= 0) {
+        return;
+    }
+    if (aItemCount == 1) {
+        aJob(0, 1);
+        return;
+    }
+
+    const PZInteger threadCount = getWorkerCount() + 1;
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _job       = &aJob;
+        _itemCount = aItemCount;
+        _chunkSize = std::max(aItemCount / (threadCount * CHUNKS_PER_THREAD), PZInteger{1});
+        _nextItem.store(0, std::memory_order_relaxed);
+        _exception   = nullptr;
+        _busyWorkers = getWorkerCount();
+        _generation += 1;
+    }
+    _cv_start.notify_all();
+
+    _work();
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _cv_done.wait(lock, [this]() {
+            return _busyWorkers == 0;
+        });
+        _job = nullptr;
+        std::swap(exception, _exception);
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void QAO_WorkerPool::_workerBody() {
+    std::uint64_t lastGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _cv_start.wait(lock, [&]() {
+                return _stopped || _generation != lastGeneration;
+            });
+            if (_stopped) {
+                return;
+            }
+            lastGeneration = _generation;
+        }
+
+        _work();
+
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _busyWorkers -= 1;
+            if (_busyWorkers == 0) {
+                _cv_done.notify_one();
+            }
+        }
+    }
+}
+
+void QAO_WorkerPool::_work() {
+    while (true) {
+        const auto begin = _nextItem.fetch_add(_chunkSize, std::memory_order_relaxed);
+        if (begin >= _itemCount) {
+            return;
+        }
+        const auto end = std::min(begin + _chunkSize, _itemCount);
+
+        try {
+            (*_job)(begin, end);
+        } catch (...) {
+            // Stop handing out items and remember the first exception
+            _nextItem.store(_itemCount, std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock{_mutex};
+            if (!_exception) {
+                _exception = std::current_exception();
+            }
+            return;
+        }
+    }
+}
+
+} // namespace qao_detail
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
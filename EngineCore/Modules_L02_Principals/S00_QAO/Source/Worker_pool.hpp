@@ -0,0 +1,72 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_QAO_WORKER_POOL_HPP
+#define UHOBGOBLIN_QAO_WORKER_POOL_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/No_copy_no_move.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace qao {
+namespace qao_detail {
+
+//! A fixed set of threads which execute jobs for a `QAO_Runtime` in parallel.
+//! The thread which calls `run()` takes part in the job as well, and `run()` doesn't return
+//! until the whole job is done (so each call to `run()` acts as a barrier).
+class QAO_WorkerPool
+    : NO_COPY
+    , NO_MOVE {
+public:
+    //! Function which processes items [aBegin, aEnd) of a job.
+    using Job = std::function<void(PZInteger aBegin, PZInteger aEnd)>;
+
+    explicit QAO_WorkerPool(PZInteger aWorkerCount);
+    ~QAO_WorkerPool();
+
+    PZInteger getWorkerCount() const;
+
+    //! Processes `aItemCount` items with `aJob`, spread across the workers and the calling thread.
+    //! If the job throws, no new items are handed out and the first exception thrown is rethrown
+    //! from here once all threads have stopped working on the job.
+    void run(PZInteger aItemCount, const Job& aJob);
+
+private:
+    std::vector<std::thread> _workers;
+
+    std::mutex              _mutex; // Protects: _generation, _stopped, _busyWorkers, _exception
+    std::condition_variable _cv_start;
+    std::condition_variable _cv_done;
+    std::uint64_t           _generation  = 0;
+    bool                    _stopped     = false;
+    PZInteger               _busyWorkers = 0;
+    std::exception_ptr      _exception;
+
+    // Current job
+    const Job*             _job       = nullptr;
+    PZInteger              _itemCount = 0;
+    PZInteger              _chunkSize = 1;
+    std::atomic<PZInteger> _nextItem{0};
+
+    void _workerBody();
+    void _work();
+};
+
+} // namespace qao_detail
+} // namespace qao
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_QAO_WORKER_POOL_HPP
@@ -0,0 +1,161 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/QAO.hpp>
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <vector>
+
+using namespace hg::qao;
+using hg::qao::qao_detail::QAO_HandleFactory;
+using hg::qao::qao_detail::QAO_Orderer;
+
+namespace {
+class Derived : public QAO_Base {
+    using QAO_Base::QAO_Base;
+};
+
+class QAO_OrdererTest : public ::testing::Test {
+protected:
+    QAO_Base* _makeObject(int aPriority, QAO_ExeCon aExecon = QAO_ExeCon::META_EXECUTE_ALL) {
+        _objects.push_back(QAO_Create<Derived>(nullptr, aExecon, aPriority, ""));
+        return _objects.back().ptr();
+    }
+
+    QAO_OrdererIterator _insert(QAO_Base* aObject) {
+        return _orderer.insert(QAO_HandleFactory::createHandle(aObject, false));
+    }
+
+    std::vector<QAO_Base*> _collect() const {
+        std::vector<QAO_Base*> result;
+        for (const auto& handle : _orderer) {
+            result.push_back(handle.ptr());
+        }
+        return result;
+    }
+
+    std::vector<QAO_GenericHandle> _objects;
+    QAO_Orderer                    _orderer;
+};
+} // namespace
+
+TEST_F(QAO_OrdererTest, EmptyOrderer) {
+    EXPECT_TRUE(_orderer.empty());
+    EXPECT_EQ(_orderer.size(), 0);
+    EXPECT_EQ(_orderer.begin(), _orderer.end());
+    EXPECT_EQ(_orderer.rbegin(), _orderer.rend());
+}
+
+TEST_F(QAO_OrdererTest, OrdersByDescendingPriorityThenByInsertion) {
+    auto* a = _makeObject(10);
+    auto* b = _makeObject(30);
+    auto* c = _makeObject(20);
+    auto* d = _makeObject(30);
+    auto* e = _makeObject(-5);
+    auto* f = _makeObject(20);
+
+    for (auto* obj : {a, b, c, d, e, f}) {
+        _insert(obj);
+    }
+
+    EXPECT_EQ(_orderer.size(), 6);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{b, d, c, f, a, e}));
+}
+
+TEST_F(QAO_OrdererTest, ReverseIteration) {
+    auto* a = _makeObject(1);
+    auto* b = _makeObject(2);
+    auto* c = _makeObject(3);
+
+    for (auto* obj : {a, b, c}) {
+        _insert(obj);
+    }
+
+    std::vector<QAO_Base*> result;
+    for (auto iter = _orderer.rbegin(); iter != _orderer.rend(); ++iter) {
+        result.push_back(iter->ptr());
+    }
+    EXPECT_EQ(result, (std::vector<QAO_Base*>{a, b, c}));
+    EXPECT_EQ(std::prev(_orderer.end())->ptr(), a);
+}
+
+TEST_F(QAO_OrdererTest, EraseReturnsNextAndKeepsOtherIteratorsValid) {
+    auto* a = _makeObject(3);
+    auto* b = _makeObject(2);
+    auto* c = _makeObject(2);
+    auto* d = _makeObject(1);
+
+    const auto iterA = _insert(a);
+    const auto iterB = _insert(b);
+    const auto iterC = _insert(c);
+    const auto iterD = _insert(d);
+
+    auto next = _orderer.erase(iterB);
+    EXPECT_EQ(next, iterC);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{a, c, d}));
+
+    next = _orderer.erase(iterC); // Bucket for priority 2 becomes empty
+    EXPECT_EQ(next, iterD);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{a, d}));
+
+    next = _orderer.erase(iterD);
+    EXPECT_EQ(next, _orderer.end());
+    EXPECT_EQ(iterA->ptr(), a);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{a}));
+
+    // Re-inserting into a removed bucket works and reuses freed nodes
+    _insert(c);
+    _insert(b);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{a, c, b}));
+    EXPECT_EQ(_orderer.size(), 3);
+}
+
+TEST_F(QAO_OrdererTest, Reposition) {
+    auto* a = _makeObject(3);
+    auto* b = _makeObject(2);
+    auto* c = _makeObject(1);
+
+    const auto iterA = _insert(a);
+    _insert(b);
+    _insert(c);
+
+    a->setExecutionPriority(0);
+    EXPECT_TRUE(_orderer.reposition(iterA));
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{b, c, a}));
+    EXPECT_EQ(iterA->ptr(), a);
+
+    a->setExecutionPriority(2);
+    EXPECT_TRUE(_orderer.reposition(iterA));
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{b, a, c}));
+
+    // Already in the right bucket, so it keeps its place
+    EXPECT_FALSE(_orderer.reposition(iterA));
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{b, a, c}));
+}
+
+TEST_F(QAO_OrdererTest, OrdersByAscendingExeconWithinPriority) {
+    auto* a = _makeObject(2, QAO_ExeCon::GAMEPLAY);
+    auto* b = _makeObject(2, QAO_ExeCon::ESSENTIAL);
+    auto* c = _makeObject(1, QAO_ExeCon::EXTRAS);
+    auto* d = _makeObject(2, QAO_ExeCon::GAMEPLAY);
+    auto* e = _makeObject(1, QAO_ExeCon::INTERACTIVITY);
+
+    const auto iterA = _insert(a);
+    const auto iterB = _insert(b);
+    const auto iterC = _insert(c);
+    _insert(d);
+    const auto iterE = _insert(e);
+
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{b, a, d, e, c}));
+
+    EXPECT_EQ(_orderer.nextPriority(iterB), iterE);
+    EXPECT_EQ(_orderer.nextPriority(iterA), iterE);
+    EXPECT_EQ(_orderer.nextPriority(iterC), _orderer.end());
+
+    b->setExeconThreshold(QAO_ExeCon::EXTRAS);
+    _orderer.reposition(iterB);
+    EXPECT_EQ(_collect(), (std::vector<QAO_Base*>{a, d, b, e, c}));
+}
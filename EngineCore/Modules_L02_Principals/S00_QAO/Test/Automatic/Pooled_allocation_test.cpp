@@ -0,0 +1,130 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/QAO.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace hg::qao;
+
+namespace {
+class PooledObject : public QAO_Base {
+public:
+    QAO_POOLED_ALLOCATION;
+
+    PooledObject(QAO_InstGuard aInstGuard)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, QAO_STATIC_NAME("PooledObject")} {}
+
+    char payload[200] = {};
+};
+
+// Inherits pooled allocation, but lands in a different size class
+class BiggerPooledObject : public PooledObject {
+public:
+    using PooledObject::PooledObject;
+
+    char morePayload[300] = {};
+};
+
+class alignas(64) OverAlignedPooledObject : public QAO_Base {
+public:
+    QAO_POOLED_ALLOCATION;
+
+    OverAlignedPooledObject(QAO_InstGuard aInstGuard)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, QAO_STATIC_NAME("OverAligned")} {}
+};
+
+std::optional<QAO_PoolStats> GetStatsForSize(std::size_t aSize) {
+    const auto blockSize =
+        ((aSize + QAO_POOL_SIZE_CLASS_STEP - 1) / QAO_POOL_SIZE_CLASS_STEP) * QAO_POOL_SIZE_CLASS_STEP;
+    for (const auto& stats : QAO_GetPoolStats()) {
+        if (stats.blockSize == blockSize) {
+            return stats;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace
+
+TEST(QAO_PooledAllocationTest, ObjectsAreAllocatedFromPoolsAndRecycled) {
+    constexpr int COUNT = 100;
+
+    std::vector<QAO_Handle<PooledObject>> objects;
+    for (int i = 0; i < COUNT; i += 1) {
+        objects.push_back(QAO_Create<PooledObject>(nullptr));
+    }
+
+    const auto statsBefore = GetStatsForSize(sizeof(PooledObject));
+    ASSERT_TRUE(statsBefore.has_value());
+    EXPECT_GE(statsBefore->blocksInUse, COUNT);
+    EXPECT_GE(statsBefore->blocksTotal, statsBefore->blocksInUse);
+
+    auto* const firstAddress = objects.front().ptr();
+    objects.front().reset();
+    EXPECT_EQ(GetStatsForSize(sizeof(PooledObject))->blocksInUse, statsBefore->blocksInUse - 1);
+
+    // The freed block is reused by the next allocation of the same size class
+    objects.front() = QAO_Create<PooledObject>(nullptr);
+    EXPECT_EQ(objects.front().ptr(), firstAddress);
+
+    objects.clear();
+    const auto statsAfter = GetStatsForSize(sizeof(PooledObject));
+    EXPECT_EQ(statsAfter->blocksInUse, statsBefore->blocksInUse - COUNT);
+    EXPECT_EQ(statsAfter->blocksTotal, statsBefore->blocksTotal);
+}
+
+TEST(QAO_PooledAllocationTest, SubclassesUseTheirOwnSizeClass) {
+    QAO_Runtime runtime;
+
+    auto       object = QAO_Create<BiggerPooledObject>(&runtime);
+    const auto stats  = GetStatsForSize(sizeof(BiggerPooledObject));
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_GE(stats->blocksInUse, 1);
+
+    const auto inUse = stats->blocksInUse;
+    QAO_Destroy(object);
+    EXPECT_EQ(GetStatsForSize(sizeof(BiggerPooledObject))->blocksInUse, inUse - 1);
+}
+
+TEST(QAO_PooledAllocationTest, ObjectsCanBeCreatedAndFreedFromManyThreads) {
+    constexpr int THREAD_COUNT = 4;
+    constexpr int COUNT        = 1000;
+
+    const auto inUseBefore = GetStatsForSize(sizeof(PooledObject)).value_or(QAO_PoolStats{}).blocksInUse;
+
+    // Each thread frees the objects created by the previous one (and its own)
+    std::vector<std::vector<QAO_Handle<PooledObject>>> objects(THREAD_COUNT);
+    for (auto& vec : objects) {
+        for (int i = 0; i < COUNT; i += 1) {
+            vec.push_back(QAO_Create<PooledObject>(nullptr));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREAD_COUNT; t += 1) {
+        threads.emplace_back([&objects, t]() {
+            std::vector<QAO_Handle<PooledObject>> own;
+            for (int i = 0; i < COUNT; i += 1) {
+                own.push_back(QAO_Create<PooledObject>(nullptr));
+            }
+            objects[hg::pztos(t)].clear();
+            own.clear();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(GetStatsForSize(sizeof(PooledObject))->blocksInUse, inUseBefore);
+}
+
+TEST(QAO_PooledAllocationTest, OverAlignedObjectsAreAllocatedNormally) {
+    auto object = QAO_Create<OverAlignedPooledObject>(nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(object.ptr()) % 64, 0u);
+}
@@ -226,3 +226,75 @@ TEST(QAO_PriorityResolver2Test, PrecedesMethod) {
     ASSERT_GT(C, A); // C before A
     ASSERT_GT(A, D); // A before D
 }
+
+TEST(QAO_PriorityResolver2Test, ResolveNewKeepsExistingPriorities) {
+    int A = 1000, B = 1000, C = 1000, D = 1000, E = 1000;
+
+    QAO_PriorityResolver2 resolver{1000, 100};
+    resolver.category(&B).dependsOn(&A);
+    resolver.resolveAll();
+    ASSERT_EQ(A, 1000);
+    ASSERT_EQ(B, 900);
+
+    // C and D go between A and B, E goes after B
+    resolver.category(&C).dependsOn(&A).precedes(&B);
+    resolver.category(&D).dependsOn(&C).precedes(&B);
+    resolver.category(&E).dependsOn(&B);
+    ASSERT_TRUE(resolver.resolveNew());
+
+    EXPECT_EQ(A, 1000);
+    EXPECT_EQ(B, 900);
+    EXPECT_GT(A, C);
+    EXPECT_GT(C, D);
+    EXPECT_GT(D, B);
+    EXPECT_GT(B, E);
+}
+
+TEST(QAO_PriorityResolver2Test, ResolveNewFitsChainsOfNewCategoriesIntoGaps) {
+    constexpr int CHAIN_LENGTH = 20;
+
+    int A = 1000, B = 1000;
+    int chain[CHAIN_LENGTH];
+
+    QAO_PriorityResolver2 resolver{1000, 100};
+    resolver.category(&B).dependsOn(&A);
+    resolver.resolveAll();
+
+    // Each category of the chain depends on the previous one, and all of them go between A and B
+    resolver.category(&chain[0]).dependsOn(&A);
+    for (int i = 1; i < CHAIN_LENGTH; i += 1) {
+        resolver.category(&chain[i]).dependsOn(&chain[i - 1]);
+    }
+    resolver.category(&B).dependsOn(&chain[CHAIN_LENGTH - 1]);
+    ASSERT_TRUE(resolver.resolveNew());
+
+    EXPECT_EQ(A, 1000);
+    EXPECT_EQ(B, 900);
+    EXPECT_GT(A, chain[0]);
+    for (int i = 1; i < CHAIN_LENGTH; i += 1) {
+        EXPECT_GT(chain[i - 1], chain[i]);
+    }
+    EXPECT_GT(chain[CHAIN_LENGTH - 1], B);
+}
+
+TEST(QAO_PriorityResolver2Test, ResolveNewRenumbersAllWhenExistingPrioritiesWouldHaveToChange) {
+    int A = 1000, B = 1000, C = 1000;
+
+    QAO_PriorityResolver2 resolver; // Step of 1 leaves no room between categories
+    resolver.category(&B).dependsOn(&A);
+    resolver.resolveAll();
+
+    resolver.category(&C).dependsOn(&A).precedes(&B);
+    ASSERT_FALSE(resolver.resolveNew());
+    EXPECT_GT(A, C);
+    EXPECT_GT(C, B);
+    ASSERT_TRUE(resolver.resolveNew()); // Nothing new
+
+    // New dependency between already resolved categories (which here creates a cycle)
+    resolver.category(&A).dependsOn(&B);
+    const int a = A, b = B, c = C;
+    ASSERT_THROW(resolver.resolveNew(), hg::TracedLogicError);
+    EXPECT_EQ(A, a); // Nothing changed
+    EXPECT_EQ(B, b);
+    EXPECT_EQ(C, c);
+}
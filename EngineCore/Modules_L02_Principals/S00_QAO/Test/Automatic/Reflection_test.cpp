@@ -9,6 +9,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace hg::qao;
 
 namespace test {
@@ -23,7 +25,11 @@ private:
 };
 
 TEST_F(QAO_ReflectionTest, RegisteredClassCount) {
-    EXPECT_EQ(QAO_ClassMetadata::getClassCount(), 3); // Two testers and QAO_Base
+    // Other tests in the same binary register classes of their own, so only the ones from this
+    // test are checked for
+    EXPECT_NE(QAO_ClassMetadata::get(typeid(RMTesterBase)), nullptr);
+    EXPECT_NE(QAO_ClassMetadata::get(typeid(RMTesterDerived)), nullptr);
+    EXPECT_GE(QAO_ClassMetadata::getClassCount(), 3); // Two testers and QAO_Base
 }
 
 TEST_F(QAO_ReflectionTest, CheckQAO_BaseMetadata) {
@@ -36,7 +42,10 @@ TEST_F(QAO_ReflectionTest, CheckQAO_BaseMetadata) {
     EXPECT_EQ(metadata->getUniqueName(), "UHOBGOBLIN_QAO_Base");
     EXPECT_EQ(metadata->getTypeInfo(), typeid(QAO_Base));
     EXPECT_EQ(metadata->getSuperclass(), nullptr);
-    EXPECT_EQ(metadata->getChildClasses().size(), 1);
+
+    const auto children = metadata->getChildClasses();
+    EXPECT_EQ(std::count(children.begin(), children.end(), QAO_ClassMetadata::get(typeid(RMTesterBase))),
+              1);
 }
 
 TEST_F(QAO_ReflectionTest, CheckBaseClassMetadata) {
@@ -65,6 +74,21 @@ TEST_F(QAO_ReflectionTest, CheckDerivedClassMetadata) {
     EXPECT_EQ(metadata->getChildClasses().size(), 0);
 }
 
+TEST_F(QAO_ReflectionTest, HandledEventsDefaultToAllEvents) {
+    EXPECT_EQ(QAO_ClassMetadata::get(typeid(QAO_Base))->getHandledEvents(), QAO_ALL_EVENT_FLAGS);
+    EXPECT_EQ(QAO_ClassMetadata::get(typeid(RMTesterBase))->getHandledEvents(), QAO_ALL_EVENT_FLAGS);
+    EXPECT_EQ(QAO_ClassMetadata::get(typeid(RMTesterDerived))->getHandledEvents(), QAO_ALL_EVENT_FLAGS);
+}
+
+TEST_F(QAO_ReflectionTest, InstancesKnowTheirClassMetadata) {
+    auto base    = QAO_Create<RMTesterBase>(nullptr);
+    auto derived = QAO_Create<RMTesterDerived>(nullptr);
+
+    EXPECT_EQ(base->getClassMetadata(), QAO_ClassMetadata::get(typeid(RMTesterBase)));
+    EXPECT_EQ(derived->getClassMetadata(), QAO_ClassMetadata::get(typeid(RMTesterDerived)));
+    EXPECT_EQ(((QAO_Base&)*derived).getClassMetadata(), derived->getClassMetadata());
+}
+
 TEST_F(QAO_ReflectionTest, SendMessagesToBaseInstance) {
     auto inst = QAO_Create<RMTesterBase>(nullptr);
 
@@ -121,6 +145,49 @@ TEST_F(QAO_ReflectionTest, SendMessagesToDerivedInstance) {
     }
 }
 
+TEST_F(QAO_ReflectionTest, RuntimeTracksInstancesOfClasses) {
+    const auto& baseClass    = *QAO_ClassMetadata::get(typeid(RMTesterBase));
+    const auto& derivedClass = *QAO_ClassMetadata::get(typeid(RMTesterDerived));
+
+    QAO_Runtime runtime;
+    auto        base1   = QAO_Create<RMTesterBase>(runtime.nonOwning());
+    auto        base2   = QAO_Create<RMTesterBase>(runtime.nonOwning());
+    auto        derived = QAO_Create<RMTesterDerived>(runtime.nonOwning());
+
+    EXPECT_EQ(runtime.getInstancesOf(baseClass).size(), 2);
+    EXPECT_EQ(runtime.getInstancesOf(derivedClass).size(), 1);
+    EXPECT_EQ(runtime.forEachInstanceOf(baseClass, [](QAO_Base&) {}), 3);
+    EXPECT_EQ(runtime.forEachInstanceOf(derivedClass, [](QAO_Base&) {}), 1);
+
+    runtime.detachObject(*base1);
+    ASSERT_EQ(runtime.getInstancesOf(baseClass).size(), 1);
+    EXPECT_EQ(runtime.getInstancesOf(baseClass)[0], base2.ptr());
+    EXPECT_EQ(runtime.forEachInstanceOf(baseClass, [](QAO_Base&) {}), 2);
+}
+
+TEST_F(QAO_ReflectionTest, BroadcastMessage) {
+    const auto& baseClass    = *QAO_ClassMetadata::get(typeid(RMTesterBase));
+    const auto& derivedClass = *QAO_ClassMetadata::get(typeid(RMTesterDerived));
+
+    QAO_Runtime runtime;
+    auto        base       = QAO_Create<RMTesterBase>(runtime.nonOwning());
+    auto        derived    = QAO_Create<RMTesterDerived>(runtime.nonOwning());
+    auto        unattached = QAO_Create<RMTesterBase>(nullptr);
+
+    const double power = 5.0;
+    EXPECT_EQ(QAO_BroadcastMessage<SetPower>(runtime, baseClass, &power), 2);
+    EXPECT_EQ(base->power, power);
+    EXPECT_NEAR(derived->power, power * 2.0, 0.0001);
+    EXPECT_EQ(unattached->power, 0.0);
+
+    const double newPower = 3.0;
+    EXPECT_EQ(QAO_BroadcastMessage<SetPower>(runtime, derivedClass, &newPower), 1);
+    EXPECT_EQ(base->power, power);
+    EXPECT_NEAR(derived->power, newPower * 2.0, 0.0001);
+
+    EXPECT_EQ(QAO_BroadcastMessage<UnusedMessage>(runtime, baseClass, nullptr), 0);
+}
+
 TEST_F(QAO_ReflectionTest, SendClassMessageToBaseClass) {
     const auto* klass = QAO_ClassMetadata::get("QAO_AutomaticTest_RMTesterBase");
     ASSERT_NE(klass, nullptr);
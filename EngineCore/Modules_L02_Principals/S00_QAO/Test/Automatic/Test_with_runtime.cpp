@@ -6,7 +6,11 @@
 #include <Hobgoblin/QAO.hpp>
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 using namespace hg::qao;
@@ -166,6 +170,108 @@ TEST_F(QAO_TestWithRuntime, DetachingObjectsReturnsNonOwningHandleWhenObjectIsNo
     ASSERT_EQ(_runtime.getObjectCount(), 0);
 }
 
+TEST_F(QAO_TestWithRuntime, AttachAndDetachObjectsInBulk) {
+    std::vector<QAO_GenericHandle> handles;
+    std::vector<QAO_GenericId>     ids;
+    for (int i = 0; i < 10; i += 1) {
+        handles.push_back(QAO_Create<SimpleActiveObject>(nullptr, _numbers, i));
+    }
+    _runtime.attachObjects(handles);
+    ASSERT_EQ(_runtime.getObjectCount(), 10);
+
+    for (const auto& handle : handles) {
+        ASSERT_TRUE(handle.isNull()); // Moved from
+    }
+    for (const auto& object : _runtime) {
+        ids.push_back(object->getId());
+    }
+
+    performStep();
+    EXPECT_EQ(_numbers, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    auto detached = _runtime.detachObjects(ids);
+    ASSERT_EQ(_runtime.getObjectCount(), 0);
+    ASSERT_EQ(detached.size(), 10);
+    for (std::size_t i = 0; i < detached.size(); i += 1) {
+        ASSERT_TRUE(detached[i].isOwning());
+        EXPECT_EQ(detached[i]->getRuntime(), nullptr);
+        EXPECT_EQ(detached[i]->getId(), QAO_GenericId{});
+    }
+}
+
+TEST_F(QAO_TestWithRuntime, BulkAttachFailsWithoutSideEffects) {
+    auto attached = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 0);
+
+    std::vector<QAO_GenericHandle> handles;
+    handles.push_back(QAO_Create<SimpleActiveObject>(nullptr, _numbers, 1));
+    handles.push_back(attached); // Already attached
+
+    EXPECT_THROW(_runtime.attachObjects(handles), hg::PreconditionNotMetError);
+    EXPECT_EQ(_runtime.getObjectCount(), 1);
+    EXPECT_FALSE(handles[0].isNull());
+
+    const QAO_GenericId ids[] = {attached->getId(), QAO_GenericId{}};
+    EXPECT_THROW(_runtime.detachObjects(ids), hg::PreconditionNotMetError);
+    EXPECT_EQ(_runtime.getObjectCount(), 1);
+}
+
+TEST_F(QAO_TestWithRuntime, BulkAttachAndDetachRejectDuplicates) {
+    std::vector<QAO_GenericHandle> handles;
+    handles.push_back(QAO_Create<SimpleActiveObject>(nullptr, _numbers, 1));
+    handles.push_back(handles[0]); // Non-owning copy
+
+    EXPECT_THROW(_runtime.attachObjects(handles), hg::InvalidArgumentError);
+    EXPECT_EQ(_runtime.getObjectCount(), 0);
+    EXPECT_FALSE(handles[0].isNull());
+
+    auto                attached = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 0);
+    const QAO_GenericId ids[]    = {attached->getId(), attached->getId()};
+    EXPECT_THROW(_runtime.detachObjects(ids), hg::InvalidArgumentError);
+    EXPECT_EQ(_runtime.getObjectCount(), 1);
+}
+
+namespace {
+class ObjectWhichCanFailToDetach : public QAO_Base {
+public:
+    ObjectWhichCanFailToDetach(QAO_InstGuard aInstGuard)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, "ObjectWhichCanFailToDetach"} {}
+
+    bool throwOnDetach = false;
+    int  attachCount   = 0;
+
+protected:
+    void _didAttach(QAO_Runtime& aRuntime) override {
+        QAO_Base::_didAttach(aRuntime);
+        attachCount += 1;
+    }
+
+    void _willDetach(QAO_Runtime& aRuntime) override {
+        if (throwOnDetach) {
+            throw std::runtime_error{"ObjectWhichCanFailToDetach"};
+        }
+        QAO_Base::_willDetach(aRuntime);
+    }
+};
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, BulkDetachFailsWithoutDetachingAnything) {
+    auto obj1 = QAO_Create<ObjectWhichCanFailToDetach>(&_runtime);
+    auto obj2 = QAO_Create<ObjectWhichCanFailToDetach>(&_runtime);
+    auto obj3 = QAO_Create<ObjectWhichCanFailToDetach>(&_runtime);
+    obj2->throwOnDetach = true;
+
+    const QAO_GenericId ids[] = {obj1->getId(), obj2->getId(), obj3->getId()};
+    EXPECT_THROW(_runtime.detachObjects(ids), std::runtime_error);
+    EXPECT_EQ(_runtime.getObjectCount(), 3);
+    EXPECT_EQ(obj1->attachCount, 2); // Told again that it's attached
+    EXPECT_EQ(obj3->attachCount, 1);
+
+    // The objects are still usable normally
+    obj2->throwOnDetach = false;
+    EXPECT_EQ(_runtime.detachObjects(ids).size(), 3u);
+    EXPECT_EQ(_runtime.getObjectCount(), 0);
+}
+
 TEST_F(QAO_TestWithRuntime, ObjectCount_WithQAO_Destroy_NonOwningHandle) {
     auto handle = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 0);
     EXPECT_FALSE(handle.isOwning());
@@ -287,6 +393,35 @@ TEST_F(QAO_TestWithRuntime, Execon) {
     ASSERT_EQ(_numbers[0], VALUE_0);
 }
 
+TEST_F(QAO_TestWithRuntime, ExeconSkipsObjectsWithSamePriority) {
+    auto execon = QAO_ExeCon::META_EXECUTE_ALL;
+    _runtime.setExeconAddress(&execon);
+
+    auto gameplay1 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 1);
+    gameplay1->setExeconThreshold(QAO_ExeCon::GAMEPLAY);
+    auto essential = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+    auto gameplay2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 3);
+    gameplay2->setExeconThreshold(QAO_ExeCon::GAMEPLAY);
+    auto lowerPriority = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 4);
+    lowerPriority->setExecutionPriority(-1);
+
+    // Within the same priority, objects run in order of ascending execon threshold
+    performStep();
+    EXPECT_EQ(_numbers, (std::vector<int>{2, 1, 3, 4}));
+    _numbers.clear();
+
+    execon = QAO_ExeCon::INTERACTIVITY;
+    performStep();
+    EXPECT_EQ(_numbers, (std::vector<int>{2, 4}));
+    _numbers.clear();
+
+    // Changing the threshold of an attached object takes effect immediately
+    gameplay2->setExeconThreshold(QAO_ExeCon::ESSENTIAL);
+    essential->setExeconThreshold(QAO_ExeCon::EXTRAS);
+    performStep();
+    EXPECT_EQ(_numbers, (std::vector<int>{3, 4}));
+}
+
 namespace {
 class SimpleActiveObjectWhichDeletesItself : public QAO_Base {
 public:
@@ -319,6 +454,621 @@ TEST_F(QAO_TestWithRuntime, ObjectsDeleteThemselves) {
     performStep();
 }
 
+namespace {
+class ObjectWhichDefersDestruction : public QAO_Base {
+public:
+    ObjectWhichDefersDestruction(QAO_InstGuard aInstGuard, std::vector<int>& vec, QAO_Base* aOther)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, "ObjectWhichDefersDestruction"}
+        , _myVec{vec}
+        , _other{aOther} {}
+
+    using QAO_Base::setExecutionPriority;
+
+    void _eventUpdate1() override {
+        QAO_DestroyDeferred(this);
+        QAO_DestroyDeferred(this); // Scheduling twice is harmless
+        QAO_DestroyDeferred(_other);
+        _myVec.push_back(getRuntime()->getObjectCount());
+    }
+
+    void _eventUpdate2() override {
+        _myVec.push_back(-1); // Should never be called
+    }
+
+private:
+    std::vector<int>& _myVec;
+    QAO_Base*         _other;
+};
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, ObjectsDeferDestruction) {
+    auto  victim    = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 100);
+    auto* victimPtr = _getObjectPtr(victim);
+    auto  destroyer = QAO_Create<ObjectWhichDefersDestruction>(&_runtime, _numbers, victimPtr);
+    auto  control   = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 200);
+    destroyer->setExecutionPriority(10);
+    victim->setExecutionPriority(5);
+    control->setExecutionPriority(0);
+
+    performStep();
+
+    // Objects are still attached during the event, but the victim doesn't get to execute it
+    EXPECT_EQ(_numbers, (std::vector<int>{3, 200}));
+    EXPECT_EQ(_runtime.getObjectCount(), 1);
+    EXPECT_EQ(_runtime.find(control->getId()).ptr(), _getObjectPtr(control));
+}
+
+TEST_F(QAO_TestWithRuntime, DeferredDestructionRequiresRuntimeOwnership) {
+    auto unattached = QAO_Create<SimpleActiveObject>(nullptr, _numbers, 0);
+    EXPECT_THROW(QAO_DestroyDeferred(_getObjectPtr(unattached)), hg::PreconditionNotMetError);
+
+    auto notOwned = QAO_Create<SimpleActiveObject>(_runtime.nonOwning(), _numbers, 0);
+    EXPECT_THROW(QAO_DestroyDeferred(_getObjectPtr(notOwned)), hg::PreconditionNotMetError);
+}
+
+namespace {
+class SimpleActiveObjectWhichLowersItsPriority : public QAO_Base {
+public:
+    SimpleActiveObjectWhichLowersItsPriority(QAO_InstGuard aInstGuard, std::vector<int>& vec, int number)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, "SimpleActiveObjectWhichLowersItsPriority"}
+        , _myVec{vec}
+        , _myNumber{number} {}
+
+    void _eventUpdate1() override {
+        _myVec.push_back(_myNumber);
+        setExecutionPriority(getExecutionPriority() - 100);
+    }
+
+private:
+    std::vector<int>& _myVec;
+    int               _myNumber;
+};
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, ObjectsChangeTheirPriorityDuringEvent) {
+    auto obj0 = QAO_Create<SimpleActiveObjectWhichLowersItsPriority>(&_runtime, _numbers, 0);
+    auto obj1 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 1);
+    auto obj2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+    obj0->setExecutionPriority(30);
+    obj1->setExecutionPriority(20);
+    obj2->setExecutionPriority(-500);
+
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(obj0->getExecutionPriority(), -70);
+
+    _numbers.clear();
+
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{1, 0, 2}));
+}
+
+TEST_F(QAO_TestWithRuntime, UpdateExecutionPrioritiesInBulk) {
+    std::vector<QAO_Handle<SimpleActiveObject>> objects;
+    for (int i = 0; i < 6; i += 1) {
+        objects.push_back(QAO_Create<SimpleActiveObject>(&_runtime, _numbers, i));
+        objects.back()->setExecutionPriority(i);
+    }
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{5, 4, 3, 2, 1, 0}));
+
+    // Even numbers go first; objects with the same new priority keep their relative order
+    _runtime.updateExecutionPriorities([](const QAO_Base& aObject) {
+        return (aObject.getExecutionPriority() % 2 == 0) ? 100 : -100;
+    });
+    EXPECT_EQ(objects[2]->getExecutionPriority(), 100);
+    EXPECT_EQ(objects[3]->getExecutionPriority(), -100);
+
+    _numbers.clear();
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{4, 2, 0, 5, 3, 1}));
+
+    // Objects can still be moved and detached individually afterwards
+    objects[1]->setExecutionPriority(1000);
+    QAO_Destroy(objects[4]);
+    _numbers.clear();
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{1, 2, 0, 5, 3}));
+}
+
+// MARK: Handled events tests
+
+namespace {
+class ObjectWhichHandlesOnlyUpdate1 : public QAO_Base {
+public:
+    ObjectWhichHandlesOnlyUpdate1(QAO_InstGuard aInstGuard, std::vector<int>& vec, int number)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, "ObjectWhichHandlesOnlyUpdate1"}
+        , _myVec{vec}
+        , _myNumber{number} {}
+
+    using QAO_Base::setExecutionPriority;
+
+    void _eventUpdate1() override {
+        _myVec.push_back(_myNumber);
+    }
+
+    void _eventDraw1() override {
+        _myVec.push_back(-_myNumber); // Should never be called
+    }
+
+private:
+    std::vector<int>& _myVec;
+    int               _myNumber;
+};
+
+QAO_REGISTER_CLASS(ObjectWhichHandlesOnlyUpdate1, QAO_AutomaticTest_ObjectWhichHandlesOnlyUpdate1) {
+    QAO_LOCAL_ALIAS(C, klass);
+    klass.setSuperclass<QAO_Base>().setHandledEvents(QAO_EventFlag(QAO_Event::UPDATE_1));
+}
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, ObjectsAreCalledOnlyForEventsTheyHandle) {
+    auto obj1 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 1);
+    auto obj2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+    auto obj3 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 3);
+    obj1->setExecutionPriority(10);
+    obj2->setExecutionPriority(20);
+    obj3->setExecutionPriority(30);
+
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{3, 2, 1}));
+
+    // Objects which don't handle an event are still iterable and findable through the runtime
+    EXPECT_EQ(_runtime.getObjectCount(), 3);
+    EXPECT_EQ(_runtime.find(obj1->getId()).ptr(), _getObjectPtr(obj1));
+
+    _numbers.clear();
+    QAO_Destroy(obj3);
+
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{2, 1}));
+}
+
+TEST_F(QAO_TestWithRuntime, ObjectsWhichHandleAllEventsInterleaveWithOthersInOrder) {
+    // Objects which handle all events and those which don't are kept apart, but they must still
+    // execute in the order of priority, and of insertion among those with the same priority
+    auto obj1 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 1);
+    auto obj2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+    auto obj3 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 3);
+    auto obj4 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 4);
+    auto obj5 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 5);
+    auto obj6 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 6);
+    obj5->setExecutionPriority(10);
+    obj6->setExecutionPriority(-10);
+
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{5, 1, 2, 3, 4, 6}));
+
+    // Moving to another priority and back puts an object at the end of its priority
+    obj1->setExecutionPriority(-5);
+    obj1->setExecutionPriority(0);
+    obj2->setExecutionPriority(0); // Doesn't move
+    _numbers.clear();
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{5, 2, 3, 4, 1, 6}));
+
+    // The same after rebuilding the orderers
+    _runtime.updateExecutionPriorities([](const QAO_Base& aObject) {
+        return aObject.getExecutionPriority();
+    });
+    _numbers.clear();
+    performStep();
+    ASSERT_EQ(_numbers, (std::vector<int>{5, 2, 3, 4, 1, 6}));
+}
+
+namespace {
+//! Doesn't declare its handled events, so it's treated as if it handled all of them.
+class ObjectWhichAlsoHandlesDraw2 : public ObjectWhichHandlesOnlyUpdate1 {
+public:
+    using ObjectWhichHandlesOnlyUpdate1::ObjectWhichHandlesOnlyUpdate1;
+
+    void _eventDraw2() override {
+        _draw2Count += 1;
+    }
+
+    int getDraw2Count() const {
+        return _draw2Count;
+    }
+
+private:
+    int _draw2Count = 0;
+};
+
+QAO_REGISTER_CLASS(ObjectWhichAlsoHandlesDraw2, QAO_AutomaticTest_ObjectWhichAlsoHandlesDraw2) {
+    QAO_LOCAL_ALIAS(C, klass);
+    klass.setSuperclass<ObjectWhichHandlesOnlyUpdate1>();
+}
+
+class ObjectWhichAlsoHandlesUpdate2 : public ObjectWhichAlsoHandlesDraw2 {
+public:
+    using ObjectWhichAlsoHandlesDraw2::ObjectWhichAlsoHandlesDraw2;
+};
+
+QAO_REGISTER_CLASS(ObjectWhichAlsoHandlesUpdate2, QAO_AutomaticTest_ObjectWhichAlsoHandlesUpdate2) {
+    QAO_LOCAL_ALIAS(C, klass);
+    klass.setSuperclass<ObjectWhichAlsoHandlesDraw2>().setHandledEvents(
+        QAO_EventFlag(QAO_Event::UPDATE_2));
+}
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, HandledEventsOfSuperclassesWhichDidNotDeclareThemAreKept) {
+    hg::QAO_InitializeMetadata();
+
+    const auto* metadata = QAO_ClassMetadata::get(typeid(ObjectWhichAlsoHandlesUpdate2));
+    ASSERT_NE(metadata, nullptr);
+    EXPECT_EQ(metadata->getHandledEvents(), QAO_ALL_EVENT_FLAGS);
+
+    auto obj = QAO_Create<ObjectWhichAlsoHandlesUpdate2>(&_runtime, _numbers, 1);
+    performStep();
+    EXPECT_EQ(obj->getDraw2Count(), 1);
+}
+
+// MARK: Parallel execution tests
+
+namespace {
+class ParallelObject : public QAO_Base {
+public:
+    ParallelObject(QAO_InstGuard aInstGuard, std::atomic<int>& aCounter, int aPriority)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, aPriority, "ParallelObject"}
+        , _counter{aCounter} {}
+
+    void _eventUpdate1() override {
+        if (throwOnUpdate) {
+            throwOnUpdate = false;
+            throw std::runtime_error{"ParallelObject"};
+        }
+        if (destroyOnUpdate != nullptr) {
+            getRuntime()->scheduleObjectDestruction(*destroyOnUpdate);
+        }
+        updateCount += 1;
+        _counter.fetch_add(1);
+    }
+
+    int       updateCount     = 0;
+    bool      throwOnUpdate   = false;
+    QAO_Base* destroyOnUpdate = nullptr;
+
+private:
+    std::atomic<int>& _counter;
+};
+
+QAO_REGISTER_CLASS(ParallelObject, QAO_AutomaticTest_ParallelObject) {
+    QAO_LOCAL_ALIAS(C, klass);
+    klass.setSuperclass<QAO_Base>()
+        .setHandledEvents(QAO_EventFlag(QAO_Event::UPDATE_1))
+        .setParallelEvents(QAO_EventFlag(QAO_Event::UPDATE_1));
+}
+
+//! Records the value of the counter when its event is called.
+class CounterObserver : public QAO_Base {
+public:
+    CounterObserver(QAO_InstGuard aInstGuard, const std::atomic<int>& aCounter, int aPriority)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, aPriority, "CounterObserver"}
+        , _counter{aCounter} {}
+
+    void _eventUpdate1() override {
+        observedValues.push_back(_counter.load());
+    }
+
+    std::vector<int> observedValues;
+
+private:
+    const std::atomic<int>& _counter;
+};
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, ParallelEventsRunBetweenSerialObjectsOfOtherPriorities) {
+    constexpr int OBJECTS_PER_PRIORITY = 500;
+
+    _runtime.setParallelWorkerCount(3);
+    EXPECT_EQ(_runtime.getParallelWorkerCount(), 3);
+
+    std::atomic<int>                        counter{0};
+    std::vector<QAO_Handle<ParallelObject>> objects;
+    for (int i = 0; i < OBJECTS_PER_PRIORITY; i += 1) {
+        objects.push_back(QAO_Create<ParallelObject>(&_runtime, counter, 20));
+        objects.push_back(QAO_Create<ParallelObject>(&_runtime, counter, 10));
+    }
+    auto first  = QAO_Create<CounterObserver>(&_runtime, counter, 30);
+    auto middle = QAO_Create<CounterObserver>(&_runtime, counter, 15);
+    auto last   = QAO_Create<CounterObserver>(&_runtime, counter, 0);
+
+    performStep();
+
+    EXPECT_EQ(first->observedValues, (std::vector<int>{0}));
+    EXPECT_EQ(middle->observedValues, (std::vector<int>{OBJECTS_PER_PRIORITY}));
+    EXPECT_EQ(last->observedValues, (std::vector<int>{2 * OBJECTS_PER_PRIORITY}));
+    for (const auto& object : objects) {
+        EXPECT_EQ(object->updateCount, 1);
+    }
+}
+
+TEST_F(QAO_TestWithRuntime, ParallelEventThrows) {
+    constexpr int OBJECT_COUNT = 100;
+
+    _runtime.setParallelWorkerCount(2);
+
+    std::atomic<int>                        counter{0};
+    std::vector<QAO_Handle<ParallelObject>> objects;
+    for (int i = 0; i < OBJECT_COUNT; i += 1) {
+        objects.push_back(QAO_Create<ParallelObject>(&_runtime, counter, 0));
+    }
+    objects[OBJECT_COUNT / 2]->throwOnUpdate = true;
+
+    _runtime.startStep();
+    bool done = false;
+    EXPECT_THROW(_runtime.advanceStep(done), std::runtime_error);
+    EXPECT_FALSE(done);
+
+    // Resuming the step executes the event for the remaining objects exactly once
+    _runtime.advanceStep(done);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(counter.load(), OBJECT_COUNT - 1);
+    for (int i = 0; i < OBJECT_COUNT; i += 1) {
+        EXPECT_EQ(objects[static_cast<std::size_t>(i)]->updateCount, (i == OBJECT_COUNT / 2) ? 0 : 1);
+    }
+}
+
+TEST_F(QAO_TestWithRuntime, ParallelEventsRunSeriallyWithoutWorkers) {
+    std::atomic<int> counter{0};
+    auto             object   = QAO_Create<ParallelObject>(&_runtime, counter, 10);
+    auto             observer = QAO_Create<CounterObserver>(&_runtime, counter, 0);
+
+    EXPECT_EQ(_runtime.getParallelWorkerCount(), 0);
+    performStep();
+    EXPECT_EQ(object->updateCount, 1);
+    EXPECT_EQ(observer->observedValues, (std::vector<int>{1}));
+}
+
+TEST_F(QAO_TestWithRuntime, ParallelEventCanScheduleOnlyItsOwnDestruction) {
+    _runtime.setParallelWorkerCount(2);
+
+    std::atomic<int> counter{0};
+    auto             doomed = QAO_Create<ParallelObject>(&_runtime, counter, 0);
+    auto             other  = QAO_Create<ParallelObject>(&_runtime, counter, 0);
+    doomed->destroyOnUpdate = _getObjectPtr(doomed);
+
+    performStep();
+    EXPECT_EQ(_runtime.getObjectCount(), 1);
+    EXPECT_EQ(_runtime.find(other->getId()).ptr(), _getObjectPtr(other));
+
+    auto victim            = QAO_Create<ParallelObject>(&_runtime, counter, 0);
+    other->destroyOnUpdate = _getObjectPtr(victim);
+
+    _runtime.startStep();
+    bool done = false;
+    EXPECT_THROW(_runtime.advanceStep(done), hg::PreconditionNotMetError);
+    EXPECT_FALSE(done);
+
+    other->destroyOnUpdate = nullptr;
+    _runtime.advanceStep(done);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(_runtime.getObjectCount(), 2);
+    EXPECT_EQ(_runtime.find(victim->getId()).ptr(), _getObjectPtr(victim));
+}
+
+// MARK: Profiling tests
+
+TEST_F(QAO_TestWithRuntime, ProfilingCountsEventsPerClass) {
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 2; i += 1) {
+        QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, i);
+    }
+    for (int i = 0; i < 3; i += 1) {
+        QAO_Create<ParallelObject>(&_runtime, counter, 0);
+    }
+    QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 3);
+    _runtime.setParallelWorkerCount(2);
+
+    // Disabled by default
+    EXPECT_FALSE(_runtime.isProfilingEnabled());
+    performStep();
+    EXPECT_TRUE(_runtime.getProfilingStats().empty());
+
+    _runtime.setProfilingEnabled(true);
+    performStep();
+    performStep();
+
+    const auto* serialClass   = QAO_ClassMetadata::get(typeid(ObjectWhichHandlesOnlyUpdate1));
+    const auto* parallelClass = QAO_ClassMetadata::get(typeid(ParallelObject));
+    ASSERT_NE(serialClass, nullptr);
+    ASSERT_NE(parallelClass, nullptr);
+
+    const auto stats = _runtime.getProfilingStats();
+    // Unregistered classes (counted together under null) handle all events
+    ASSERT_EQ(stats.size(), 2 + QAO_Event::EVENT_COUNT);
+    for (std::size_t i = 1; i < stats.size(); i += 1) {
+        EXPECT_GE(stats[i - 1].totalTime, stats[i].totalTime);
+    }
+    for (const auto& entry : stats) {
+        if (entry.classMetadata == serialClass) {
+            EXPECT_EQ(entry.event, QAO_Event::UPDATE_1);
+            EXPECT_EQ(entry.callCount, 4);
+        } else if (entry.classMetadata == parallelClass) {
+            EXPECT_EQ(entry.event, QAO_Event::UPDATE_1);
+            EXPECT_EQ(entry.callCount, 6);
+        } else {
+            EXPECT_EQ(entry.classMetadata, nullptr);
+            EXPECT_EQ(entry.callCount, 2);
+        }
+    }
+
+    // Reset per window
+    _runtime.resetProfilingStats();
+    EXPECT_TRUE(_runtime.getProfilingStats().empty());
+    performStep();
+    EXPECT_EQ(_runtime.getProfilingStats().size(), 2 + QAO_Event::EVENT_COUNT);
+
+    // Disabling keeps the stats but stops gathering new ones
+    _runtime.setProfilingEnabled(false);
+    performStep();
+    std::int64_t totalCallCount = 0;
+    for (const auto& entry : _runtime.getProfilingStats()) {
+        totalCallCount += entry.callCount;
+    }
+    EXPECT_EQ(totalCallCount, 2 + 3 + QAO_Event::EVENT_COUNT);
+}
+
+// MARK: Mailbox and runtime group tests
+
+TEST_F(QAO_TestWithRuntime, PostedTasksAndObjectsAreDeliveredInOrder) {
+    std::vector<int> delivered;
+    _runtime.postTask([&](QAO_Runtime& aRuntime) {
+        EXPECT_EQ(&aRuntime, &_runtime);
+        delivered.push_back(1);
+    });
+    _runtime.postObject(QAO_Create<SimpleActiveObject>(nullptr, _numbers, 5));
+    _runtime.postTask([&](QAO_Runtime& aRuntime) {
+        delivered.push_back(aRuntime.getObjectCount());
+    });
+    EXPECT_EQ(_runtime.getObjectCount(), 0);
+    EXPECT_TRUE(delivered.empty());
+
+    EXPECT_EQ(_runtime.deliverMail(), 3);
+    performStep();
+    EXPECT_EQ(delivered, (std::vector<int>{1, 1}));
+    EXPECT_EQ(_numbers, (std::vector<int>{5}));
+    EXPECT_EQ(_runtime.deliverMail(), 0);
+}
+
+TEST_F(QAO_TestWithRuntime, TasksArePostedFromManyThreads) {
+    constexpr int THREAD_COUNT     = 4;
+    constexpr int TASKS_PER_THREAD = 1000;
+
+    int                      counter = 0; // Only touched by the tasks, on this thread
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_COUNT; i += 1) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < TASKS_PER_THREAD; j += 1) {
+                _runtime.postTask([&](QAO_Runtime&) {
+                    counter += 1;
+                });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(_runtime.deliverMail(), THREAD_COUNT * TASKS_PER_THREAD);
+    EXPECT_EQ(counter, THREAD_COUNT * TASKS_PER_THREAD);
+}
+
+namespace {
+class TravellingObject : public QAO_Base {
+public:
+    TravellingObject(QAO_InstGuard aInstGuard, QAO_Runtime* aDestination)
+        : QAO_Base{aInstGuard, QAO_ExeCon::ESSENTIAL, 0, "TravellingObject"}
+        , destination{aDestination} {}
+
+    void _eventUpdate1() override {
+        visitedRuntimes.push_back(getRuntime());
+        if (destination != nullptr) {
+            getRuntime()->transferObject(*this, *std::exchange(destination, nullptr));
+        }
+    }
+
+    QAO_Runtime*              destination;
+    std::vector<QAO_Runtime*> visitedRuntimes;
+};
+} // namespace
+
+TEST_F(QAO_TestWithRuntime, RuntimeGroupStepsRuntimesAndTransfersObjects) {
+    QAO_Runtime other;
+
+    QAO_RuntimeGroup group{2};
+    group.addRuntime(_runtime);
+    group.addRuntime(other);
+    EXPECT_EQ(group.getRuntimeCount(), 2);
+
+    auto* traveller = QAO_Create<TravellingObject>(&_runtime, &other).ptr();
+    auto  stayer    = QAO_Create<SimpleActiveObject>(&other, _numbers, 1);
+
+    group.step();
+    EXPECT_EQ(_runtime.getObjectCount(), 0);
+    EXPECT_EQ(other.getObjectCount(), 1); // Not delivered yet
+    EXPECT_EQ(_numbers, (std::vector<int>{1}));
+
+    group.step();
+    EXPECT_EQ(other.getObjectCount(), 2);
+    EXPECT_TRUE(other.ownsObject(*traveller));
+    EXPECT_EQ(traveller->visitedRuntimes, (std::vector<QAO_Runtime*>{&_runtime, &other}));
+    EXPECT_EQ(_numbers, (std::vector<int>{1, 1}));
+
+    group.removeRuntime(other);
+    EXPECT_EQ(group.getRuntimeCount(), 1);
+}
+
+// MARK: Find by name tests
+
+TEST_F(QAO_TestWithRuntime, FindByName) {
+    auto obj1 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 1);
+    auto obj2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+    auto obj3 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 3);
+    obj1->setExecutionPriority(5);
+    obj2->setName("Two");
+
+    EXPECT_EQ(_runtime.find("Two").ptr(), _getObjectPtr(obj2));
+    EXPECT_EQ(_runtime.find("Three").ptr(), nullptr);
+
+    // With several objects of the same name, the one with the highest priority is found
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(obj1));
+    obj3->setExecutionPriority(10);
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(obj3));
+
+    // Renaming
+    obj3->setName("Three");
+    EXPECT_EQ(_runtime.find("Three").ptr(), _getObjectPtr(obj3));
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(obj1));
+
+    // Detaching
+    QAO_Destroy(obj1);
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), nullptr);
+    auto handle = _runtime.detachObject(*obj2);
+    EXPECT_EQ(_runtime.find("Two").ptr(), nullptr);
+    obj2->setName("Two again"); // Not attached - must not touch the runtime
+    EXPECT_EQ(_runtime.find("Two again").ptr(), nullptr);
+}
+
+TEST_F(QAO_TestWithRuntime, FindByNameChecksType) {
+    std::atomic<int> counter{0};
+
+    auto obj1 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 1);
+    auto obj2 = QAO_Create<ObjectWhichHandlesOnlyUpdate1>(&_runtime, _numbers, 2);
+    auto obj3 = QAO_Create<ParallelObject>(&_runtime, counter, 0);
+    obj1->setName("Object");
+    obj2->setName("Object");
+    obj3->setName("Object");
+    obj1->setExecutionPriority(10);
+    obj2->setExecutionPriority(5);
+
+    EXPECT_EQ(_runtime.find("Object").ptr(), _getObjectPtr(obj1));
+    EXPECT_EQ(_runtime.find<SimpleActiveObject>("Object").ptr(), _getObjectPtr(obj1));
+    EXPECT_EQ(_runtime.find<ObjectWhichHandlesOnlyUpdate1>("Object").ptr(), _getObjectPtr(obj2));
+    EXPECT_EQ(_runtime.find<ParallelObject>("Object").ptr(), _getObjectPtr(obj3));
+    EXPECT_EQ(_runtime.find<CounterObserver>("Object").ptr(), nullptr);
+}
+
+TEST_F(QAO_TestWithRuntime, FindByNameAfterDetachingObjectsWithTheSameName) {
+    std::vector<QAO_Handle<SimpleActiveObject>> objects;
+    for (int i = 0; i < 6; i += 1) {
+        objects.push_back(QAO_Create<SimpleActiveObject>(&_runtime, _numbers, i));
+        objects.back()->setExecutionPriority(i);
+    }
+
+    QAO_Destroy(objects[2]);
+    QAO_Destroy(objects[5]);
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(objects[4]));
+    QAO_Destroy(objects[0]);
+    QAO_Destroy(objects[4]);
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(objects[3]));
+    objects[3]->setName("Three");
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), _getObjectPtr(objects[1]));
+    QAO_Destroy(objects[1]);
+    EXPECT_EQ(_runtime.find("SimpleActiveObject").ptr(), nullptr);
+    EXPECT_EQ(_runtime.find("Three").ptr(), _getObjectPtr(objects[3]));
+}
+
 // MARK: GenericId tests
 
 TEST_F(QAO_TestWithRuntime, NullIdEquality) {
@@ -327,6 +1077,17 @@ TEST_F(QAO_TestWithRuntime, NullIdEquality) {
     ASSERT_EQ(id1, id2);
 }
 
+TEST_F(QAO_TestWithRuntime, StaleIdFindsNullptr) {
+    auto       obj1    = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 1);
+    const auto staleId = obj1->getId();
+    QAO_Destroy(obj1);
+    auto obj2 = QAO_Create<SimpleActiveObject>(&_runtime, _numbers, 2);
+
+    ASSERT_EQ(obj2->getId().getIndex(), staleId.getIndex()); // Index got reused
+    ASSERT_EQ(_runtime.find(staleId), nullptr);
+    ASSERT_EQ(_runtime.find(obj2->getId()).ptr(), _getObjectPtr(obj2));
+}
+
 TEST_F(QAO_TestWithRuntime, NullIdFindsNullptr) {
     QAO_GenericId nullId{};
     ASSERT_EQ(_runtime.find(nullId), nullptr);
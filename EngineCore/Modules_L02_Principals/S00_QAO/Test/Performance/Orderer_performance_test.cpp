@@ -0,0 +1,225 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+// Compares the bucketed `QAO_Orderer` against the `std::set`-based orderer which QAO used
+// previously, in the operations a `QAO_Runtime` performs on its orderer: attaching objects,
+// walking all objects once per event, changing priorities and detaching objects.
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Logging.hpp>
+#include <Hobgoblin/QAO.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace hg::qao;
+using hg::qao::qao_detail::QAO_HandleFactory;
+
+namespace {
+
+constexpr auto LOG_ID = "QAO.PerformanceTest";
+
+constexpr int OBJECT_COUNT     = 20'000;
+constexpr int PRIORITY_COUNT   = 24;
+constexpr int PASS_COUNT       = 12 * 60; // 12 events per step, 60 steps
+constexpr int REPETITION_COUNT = 5;
+
+class Dummy : public QAO_Base {
+public:
+    Dummy(QAO_InstGuard aInstGuard, int aPriority)
+        : QAO_Base{aInstGuard, QAO_ExeCon::META_EXECUTE_ALL, aPriority, QAO_DEFAULT_NAME} {}
+};
+
+//! Orderer implementation which QAO used before `QAO_Orderer` (kept here as a baseline).
+class SetOrderer {
+public:
+    struct Comparator {
+        bool operator()(const QAO_GenericHandle& a, const QAO_GenericHandle& b) const {
+            const int pri_a = a->getExecutionPriority();
+            const int pri_b = b->getExecutionPriority();
+
+            return (pri_a > pri_b) ||
+                   ((pri_a == pri_b) && (reinterpret_cast<std::uintptr_t>(a.ptr()) <
+                                         reinterpret_cast<std::uintptr_t>(b.ptr())));
+        }
+    };
+
+    using Set      = std::set<QAO_GenericHandle, Comparator>;
+    using Iterator = Set::iterator;
+
+    Iterator insert(QAO_Base* aObject) {
+        return _set.insert(QAO_HandleFactory::createHandle(aObject, false)).first;
+    }
+
+    void erase(Iterator aIter) {
+        _set.erase(aIter);
+    }
+
+    Iterator reposition(Iterator aIter, QAO_Base* aObject, int aNewPriority) {
+        _set.erase(aIter);
+        aObject->setExecutionPriority(aNewPriority);
+        return insert(aObject);
+    }
+
+    Set::const_iterator begin() const {
+        return _set.begin();
+    }
+
+    Set::const_iterator end() const {
+        return _set.end();
+    }
+
+private:
+    Set _set;
+};
+
+class BucketOrderer {
+public:
+    using Iterator = QAO_OrdererIterator;
+
+    Iterator insert(QAO_Base* aObject) {
+        return _orderer.insert(QAO_HandleFactory::createHandle(aObject, false));
+    }
+
+    void erase(Iterator aIter) {
+        _orderer.erase(aIter);
+    }
+
+    Iterator reposition(Iterator aIter, QAO_Base* aObject, int aNewPriority) {
+        aObject->setExecutionPriority(aNewPriority);
+        _orderer.reposition(aIter);
+        return aIter;
+    }
+
+    QAO_OrdererIterator begin() const {
+        return _orderer.begin();
+    }
+
+    QAO_OrdererIterator end() const {
+        return _orderer.end();
+    }
+
+private:
+    qao_detail::QAO_Orderer _orderer;
+};
+
+struct Results {
+    double attachMs     = 0.0;
+    double iterateMs    = 0.0;
+    double repositionMs = 0.0;
+    double detachMs     = 0.0;
+};
+
+double MsSince(std::chrono::steady_clock::time_point aStart) {
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - aStart).count();
+}
+
+template <class taOrderer>
+Results RunBenchmark(const std::vector<QAO_Base*>& aObjects, const std::vector<int>& aShuffledIndices) {
+    Results   results;
+    taOrderer orderer;
+
+    std::vector<typename taOrderer::Iterator> iterators;
+    iterators.resize(aObjects.size());
+
+    // Attach
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (const int idx : aShuffledIndices) {
+            const auto szIdx = static_cast<std::size_t>(idx);
+            iterators[szIdx] = orderer.insert(aObjects[szIdx]);
+        }
+        results.attachMs = MsSince(start);
+    }
+
+    // Iterate
+    {
+        std::int64_t checksum = 0;
+        const auto   start    = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASS_COUNT; pass += 1) {
+            for (const auto& handle : orderer) {
+                checksum += handle->getExecutionPriority();
+            }
+        }
+        results.iterateMs = MsSince(start);
+        HG_LOG_DEBUG(LOG_ID, "(checksum: {})", checksum);
+    }
+
+    // Change priorities of 1/4 of the objects
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < aShuffledIndices.size() / 4; i += 1) {
+            const auto idx  = static_cast<std::size_t>(aShuffledIndices[i]);
+            auto*      obj  = aObjects[idx];
+            const auto prio = (obj->getExecutionPriority() + 1) % PRIORITY_COUNT;
+            iterators[idx]  = orderer.reposition(iterators[idx], obj, prio);
+        }
+        results.repositionMs = MsSince(start);
+    }
+
+    // Detach
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (auto iter = aShuffledIndices.rbegin(); iter != aShuffledIndices.rend(); ++iter) {
+            orderer.erase(iterators[static_cast<std::size_t>(*iter)]);
+        }
+        results.detachMs = MsSince(start);
+    }
+
+    return results;
+}
+
+void PrintResults(const char* aName, const Results& aResults) {
+    HG_LOG_INFO(LOG_ID,
+                "{:>14} | attach: {:8.3f}ms | iterate x{}: {:9.3f}ms | reposition: {:8.3f}ms | "
+                "detach: {:8.3f}ms",
+                aName,
+                aResults.attachMs,
+                PASS_COUNT,
+                aResults.iterateMs,
+                aResults.repositionMs,
+                aResults.detachMs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    hg::log::SetMinimalLogSeverity(hg::log::Severity::Info);
+
+    std::mt19937 rng{12345};
+
+    std::vector<QAO_GenericHandle> handles;
+    std::vector<QAO_Base*>         objects;
+    handles.reserve(OBJECT_COUNT);
+    objects.reserve(OBJECT_COUNT);
+
+    std::uniform_int_distribution<int> priorityDist{0, PRIORITY_COUNT - 1};
+    for (int i = 0; i < OBJECT_COUNT; i += 1) {
+        handles.push_back(QAO_Create<Dummy>(nullptr, priorityDist(rng)));
+        objects.push_back(handles.back().ptr());
+    }
+
+    std::vector<int> shuffledIndices(OBJECT_COUNT);
+    for (int i = 0; i < OBJECT_COUNT; i += 1) {
+        shuffledIndices[static_cast<std::size_t>(i)] = i;
+    }
+    std::shuffle(shuffledIndices.begin(), shuffledIndices.end(), rng);
+
+    HG_LOG_INFO(LOG_ID,
+                "Objects: {}, distinct priorities: {}, repetitions: {}",
+                OBJECT_COUNT,
+                PRIORITY_COUNT,
+                REPETITION_COUNT);
+
+    for (int i = 0; i < REPETITION_COUNT; i += 1) {
+        PrintResults("std::set", RunBenchmark<SetOrderer>(objects, shuffledIndices));
+        PrintResults("QAO_Orderer", RunBenchmark<BucketOrderer>(objects, shuffledIndices));
+    }
+
+    return 0;
+}
@@ -5,7 +5,9 @@
 
 
 #include <Hobgoblin/RigelNet/Client_interface.hpp>
+#include <Hobgoblin/RigelNet/Compression.hpp>
 #include <Hobgoblin/RigelNet/Configuration.hpp>
+#include <Hobgoblin/RigelNet/Congestion_control.hpp>
 #include <Hobgoblin/RigelNet/Connector_interface.hpp>
 #include <Hobgoblin/RigelNet/Events.hpp>
 #include <Hobgoblin/RigelNet/Factories.hpp>
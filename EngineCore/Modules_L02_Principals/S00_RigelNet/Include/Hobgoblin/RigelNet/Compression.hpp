@@ -0,0 +1,45 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+// clang-format off
+
+#ifndef UHOBGOBLIN_RN_COMPRESSION_HPP
+#define UHOBGOBLIN_RN_COMPRESSION_HPP
+
+#include <Hobgoblin/Common.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Settings of the compression of data packets' payloads (see `RN_NodeInterface::setCompression()`).
+struct RN_CompressionSettings {
+    //! Whether this node offers to compress data exchanged with its remotes (it's used only
+    //! if the remote enabled it too, with the same dictionary).
+    bool enabled = false;
+
+    //! Payloads of packets smaller than this (in bytes) are never compressed, because the
+    //! savings wouldn't be worth the time. Must be larger than 4.
+    PZInteger minPayloadByteCount = 128;
+
+    //! Optional pre-trained dictionary: a sample of typical data (for example, a few recorded
+    //! state updates). Repetitions of it are compressed even in the first packets and in
+    //! packets too small to repeat much on their own. Both sides must use the exact same
+    //! dictionary (otherwise compression isn't used); only its last 64 KiB are used.
+    std::shared_ptr<const std::vector<std::uint8_t>> dictionary;
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+#include <Hobgoblin/Private/Short_namespace.hpp>
+
+#endif // !UHOBGOBLIN_RN_COMPRESSION_HPP
+
+// clang-format on
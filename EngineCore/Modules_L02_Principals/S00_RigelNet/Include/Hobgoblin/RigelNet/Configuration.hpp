@@ -18,13 +18,57 @@ enum class RN_Protocol {
 };
 
 enum class RN_NetworkingStack {
-    Default, //!< Use socket implementation and networking stack of the host OS.
-    ZeroTier //!< TODO Add description...
+    Default,      //!< Use socket implementation and networking stack of the host OS.
+    ZeroTier,     //!< TODO Add description...
+    NativeBatched //!< Use the networking stack of the host OS through native sockets which send
+                  //!< and receive datagrams in batches (one system call per batch instead of one
+                  //!< per datagram). Linux only.
 };
 
 struct RN_ComposeForAllType {};
 constexpr RN_ComposeForAllType RN_COMPOSE_FOR_ALL{};
 
+//! How a composed message is delivered to its recipients (can be passed to `Compose_*` functions
+//! right after the recipients). Modes other than `ReliableOrdered` are used only if the remote
+//! supports them (older peers don't); otherwise the message is delivered reliably and in order.
+enum class RN_DeliveryMode {
+    ReliableOrdered,     //!< Always delivered, in the order of composing (default).
+    ReliableUnordered,   //!< Always delivered, but handled as soon as it arrives - it doesn't
+                         //!< wait for earlier messages (and they don't wait for it).
+    Unreliable,          //!< Delivered at most once (never retransmitted), in any order.
+    UnreliableSequenced, //!< Like `Unreliable`, but a message is dropped if one composed after it
+                         //!< (in the same mode) was already received - only the newest counts.
+                         //!< There is one sequence per connection, shared by all messages
+                         //!< sent in this mode, regardless of their handler or content.
+};
+
+//! Number of independent streams of reliable ordered messages per connection.
+constexpr PZInteger RN_STREAM_COUNT = 16;
+
+//! Stream of reliable ordered messages (can be passed to `Compose_*` functions right after the
+//! recipients). Messages are handled in the order of composing only relative to the other
+//! messages in the same stream, so a lost packet holds up only its own stream. Without the
+//! support of the remote, all streams are merged into one (stream 0, the default).
+struct RN_Stream {
+    constexpr explicit RN_Stream(PZInteger aIndex)
+        : index{aIndex} {}
+
+    PZInteger index; //!< In the range [0, RN_STREAM_COUNT).
+};
+
+//! Tells `Compose_*` functions how to deliver a message; constructed implicitly from either
+//! an `RN_DeliveryMode` or an `RN_Stream`.
+struct RN_ComposeOptions {
+    constexpr RN_ComposeOptions(RN_DeliveryMode aDeliveryMode)
+        : deliveryMode{aDeliveryMode} {}
+
+    constexpr RN_ComposeOptions(RN_Stream aStream)
+        : stream{aStream.index} {}
+
+    RN_DeliveryMode deliveryMode = RN_DeliveryMode::ReliableOrdered;
+    PZInteger       stream       = 0; //!< Used only with `RN_DeliveryMode::ReliableOrdered`.
+};
+
 } // namespace rn
 HOBGOBLIN_NAMESPACE_END
 
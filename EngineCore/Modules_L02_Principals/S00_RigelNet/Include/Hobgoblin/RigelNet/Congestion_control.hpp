@@ -0,0 +1,72 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+// clang-format off
+
+#ifndef UHOBGOBLIN_RN_CONGESTION_CONTROL_HPP
+#define UHOBGOBLIN_RN_CONGESTION_CONTROL_HPP
+
+#include <Hobgoblin/Common.hpp>
+
+#include <chrono>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Algorithm used to limit how fast a connector sends data to its remote.
+enum class RN_CongestionControl {
+    //! No congestion control: all prepared packets are sent as soon as possible, and lost packets
+    //! are retransmitted whenever the retransmit predicate says so.
+    None,
+
+    //! Additive increase / multiplicative decrease of the congestion window, in the style of
+    //! TCP NewReno: the window grows quickly (slow start) until the first loss, and then by about
+    //! one packet per round trip; each loss (but at most one per round trip) halves it.
+    LossBased,
+
+    //! Keeps the round-trip time close to the lowest one observed: the window grows while there
+    //! is little queueing delay and shrinks as it builds up, so it backs off before the links
+    //! start dropping packets. Losses still halve the window, same as with `LossBased`.
+    DelayBased
+};
+
+//! Snapshot of a connector's congestion control state.
+struct RN_CongestionControlState {
+    //! Algorithm in use.
+    RN_CongestionControl algorithm = RN_CongestionControl::None;
+
+    //! Maximal number of bytes which can be in flight (sent but not yet acknowledged).
+    //! 0 when `algorithm` is `None`.
+    PZInteger congestionWindow = 0;
+
+    //! Number of bytes sent but not yet acknowledged.
+    PZInteger bytesInFlight = 0;
+
+    //! Rate (in bytes per second) at which packets are spaced out. 0 means no pacing.
+    PZInteger pacingRate = 0;
+
+    //! Smoothed round-trip time (-1 before the first measurement).
+    std::chrono::microseconds smoothedRtt{-1};
+
+    //! Variation of the round-trip time (-1 before the first measurement).
+    std::chrono::microseconds rttVariance{-1};
+
+    //! Time after which an unacknowledged packet is considered lost (doubles with each
+    //! retransmission of the same packet).
+    std::chrono::microseconds retransmitTimeout{-1};
+
+    //! Number of loss events (each of which shrank the congestion window) so far.
+    PZInteger lossEventCount = 0;
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+#include <Hobgoblin/Private/Short_namespace.hpp>
+
+#endif // !UHOBGOBLIN_RN_CONGESTION_CONTROL_HPP
+
+// clang-format on
@@ -5,7 +5,9 @@
 #define UHOBGOBLIN_RN_CONNECTOR_INTERFACE_HPP
 
 #include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/RigelNet/Congestion_control.hpp>
 #include <Hobgoblin/RigelNet/Remote_info.hpp>
+#include <Hobgoblin/RigelNet/Telemetry.hpp>
 
 #include <string>
 
@@ -48,6 +50,28 @@ public:
 
     //! Size of the receive buffer in bytes.
     virtual PZInteger getRecvBufferSize() const = 0;
+
+    //! Returns true if acknowledgements exchanged with the remote use the compact encoding
+    //! (which is the case if both sides enabled it - see `RN_NodeInterface::setCompactAcksEnabled()`).
+    //! Only meaningful once the connection is established.
+    virtual bool isUsingCompactAcks() const noexcept = 0;
+
+    //! Returns true if the payloads of data packets exchanged with the remote can be compressed
+    //! (which is the case if both sides enabled it with the same dictionary - see
+    //! `RN_NodeInterface::setCompression()`). Only meaningful once the connection is established.
+    virtual bool isUsingCompression() const noexcept = 0;
+
+    //! Returns the current state of congestion control for the connection to the remote
+    //! (see `RN_NodeInterface::setCongestionControl()`).
+    virtual RN_CongestionControlState getCongestionControlState() const = 0;
+
+    //! Returns detailed statistics of the connection to the remote, accumulated over the current
+    //! sampling window (see `RN_ConnectorTelemetry`).
+    virtual RN_ConnectorTelemetry getTelemetry() const = 0;
+
+    //! Starts a new sampling window for `getTelemetry()` (all statistics go back to 0). A new
+    //! window also starts whenever a connection is established.
+    virtual void resetTelemetry() = 0;
 };
 
 } // namespace rn
@@ -40,6 +40,7 @@ using UHOBGOBLIN_TypeIdentity = taType;
                                UHOBGOBLIN_RN_NORMALIZE_ARGS(const, __VA_ARGS__)) { \
         static ::jbatnozic::hobgoblin::rn::rn_detail::RN_HandlerNameToIdCacher hntic{#_name_}; \
         ::jbatnozic::hobgoblin::rn::UHOBGOBLIN_RN_ComposeImpl(node, recepients, \
+                                                              ::jbatnozic::hobgoblin::rn::RN_DeliveryMode::ReliableOrdered, \
                                                               hntic.getHandlerId() /* , */ \
                                                               UHOBGOBLIN_RN_PASS_COMPOSE_ARGS(__VA_ARGS__)); \
     } \
@@ -50,6 +51,29 @@ using UHOBGOBLIN_TypeIdentity = taType;
                                 UHOBGOBLIN_RN_NORMALIZE_ARGS(const, __VA_ARGS__)) { \
         static ::jbatnozic::hobgoblin::rn::rn_detail::RN_HandlerNameToIdCacher hntic{#_name_}; \
         ::jbatnozic::hobgoblin::rn::UHOBGOBLIN_RN_ComposeImpl(node, std::forward<taRec>(recepients), \
+                                                              ::jbatnozic::hobgoblin::rn::RN_DeliveryMode::ReliableOrdered, \
+                                                              hntic.getHandlerId() /* , */ \
+                                                              UHOBGOBLIN_RN_PASS_COMPOSE_ARGS(__VA_ARGS__)); \
+    } \
+    ::UHOBGOBLIN_TypeIdentity<void> \
+    _prefix_##Compose_##_name_(::jbatnozic::hobgoblin::rn::RN_NodeInterface& node, \
+                               std::initializer_list<::jbatnozic::hobgoblin::PZInteger> recepients, \
+                               ::jbatnozic::hobgoblin::rn::RN_ComposeOptions options /* , */ \
+                               UHOBGOBLIN_RN_NORMALIZE_ARGS(const, __VA_ARGS__)) { \
+        static ::jbatnozic::hobgoblin::rn::rn_detail::RN_HandlerNameToIdCacher hntic{#_name_}; \
+        ::jbatnozic::hobgoblin::rn::UHOBGOBLIN_RN_ComposeImpl(node, recepients, options, \
+                                                              hntic.getHandlerId() /* , */ \
+                                                              UHOBGOBLIN_RN_PASS_COMPOSE_ARGS(__VA_ARGS__)); \
+    } \
+    template <class taRec> \
+    UHOBGOBLIN_TypeIdentity<void> \
+    _prefix_##Compose_##_name_(::jbatnozic::hobgoblin::rn::RN_NodeInterface& node, \
+                                taRec&& recepients, \
+                                ::jbatnozic::hobgoblin::rn::RN_ComposeOptions options /* , */ \
+                                UHOBGOBLIN_RN_NORMALIZE_ARGS(const, __VA_ARGS__)) { \
+        static ::jbatnozic::hobgoblin::rn::rn_detail::RN_HandlerNameToIdCacher hntic{#_name_}; \
+        ::jbatnozic::hobgoblin::rn::UHOBGOBLIN_RN_ComposeImpl(node, std::forward<taRec>(recepients), \
+                                                              options, \
                                                               hntic.getHandlerId() /* , */ \
                                                               UHOBGOBLIN_RN_PASS_COMPOSE_ARGS(__VA_ARGS__)); \
     }
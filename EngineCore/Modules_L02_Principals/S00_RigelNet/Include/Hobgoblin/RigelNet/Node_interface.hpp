@@ -7,7 +7,9 @@
 #define UHOBGOBLIN_RN_NODE_INTERFACE_HPP
 
 #include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/RigelNet/Compression.hpp>
 #include <Hobgoblin/RigelNet/Configuration.hpp>
+#include <Hobgoblin/RigelNet/Congestion_control.hpp>
 #include <Hobgoblin/RigelNet/Events.hpp>
 #include <Hobgoblin/RigelNet/Handlermgmt.hpp>
 #include <Hobgoblin/RigelNet/Telemetry.hpp>
@@ -46,6 +48,53 @@ public:
 
     virtual RN_Telemetry update(RN_UpdateMode updateMode) = 0;
 
+    //! Enables or disables the dedicated I/O thread of this node (disabled by default).
+    //! While it's enabled, a background thread performs all sending and receiving on the
+    //! node's socket: it keeps receiving datagrams even while `update()` isn't being called
+    //! (so they don't pile up in - and overflow - the OS's buffers during long frames), and
+    //! sends the datagrams prepared by `update(RN_UpdateMode::Send)` as soon as they are ready.
+    //! Datagrams are exchanged with `update()` through lock-free queues. All other work
+    //! (acknowledgements, retransmission, running handlers, raising events) still happens
+    //! in `update()`, so received packets are acknowledged (and lost ones retransmitted) no
+    //! sooner than without the thread - packet latency still depends on how often `update()`
+    //! is called. Can be changed at any time.
+    virtual void setIoThreadEnabled(bool aEnabled) = 0;
+
+    virtual bool isIoThreadEnabled() const noexcept = 0;
+
+    //! Enables or disables the compact encoding of acknowledgements (enabled by default).
+    //! With it, acks are sent as bitmaps (a base packet ordinal plus a 32-bit mask covering the
+    //! following 32 packets) instead of one ordinal per acknowledged packet, which makes them
+    //! several times smaller at high packet rates. It's negotiated during the handshake, so it's
+    //! used only if both sides have it enabled (and support it - older peers don't), and changing
+    //! this setting affects only connections established afterwards.
+    virtual void setCompactAcksEnabled(bool aEnabled) = 0;
+
+    virtual bool isCompactAcksEnabled() const noexcept = 0;
+
+    //! Sets the congestion control algorithm used by this node's connectors (`None` by default).
+    //! With congestion control, each connector limits how much data it has in flight (sent but
+    //! not yet acknowledged) based on how the network behaves, spaces its packets out instead of
+    //! sending them in bursts, and retransmits lost packets only after a timeout derived from the
+    //! measured round-trip time and its variance (backing off exponentially), which prevents
+    //! retransmissions from making congestion worse. Data which doesn't fit waits in the send
+    //! buffer. Changing this setting affects only connections established afterwards.
+    virtual void setCongestionControl(RN_CongestionControl aCongestionControl) = 0;
+
+    virtual RN_CongestionControl getCongestionControl() const noexcept = 0;
+
+    //! Sets how the payloads of data packets are compressed (they aren't by default). With
+    //! compression enabled, each data packet whose payload is at least `minPayloadByteCount`
+    //! bytes large is compressed right before it's first sent (with a fast LZ77-style algorithm,
+    //! and the optional pre-trained dictionary), if that makes it smaller. It's negotiated during
+    //! the handshake, so it's used only if both sides have it enabled with the same dictionary
+    //! (and support it - older peers don't), and changing this setting affects only connections
+    //! established afterwards. The savings are reported in the telemetry returned by `update()`.
+    //! \throws InvalidArgumentError if `minPayloadByteCount` isn't larger than 4.
+    virtual void setCompression(const RN_CompressionSettings& aCompression) = 0;
+
+    virtual const RN_CompressionSettings& getCompression() const noexcept = 0;
+
     //! Call the provided function if this node is a Client.
     void callIfClient(std::function<void(RN_ClientInterface& client)> func);
 
@@ -64,8 +113,10 @@ public:
     T* getUserDataOrThrow() const;
 
 private:
-    virtual void _compose(RN_ComposeForAllType receiver, const void* data, std::size_t sizeInBytes) = 0;
-    virtual void _compose(PZInteger receiver, const void* data, std::size_t sizeInBytes) = 0;
+    virtual void _compose(RN_ComposeForAllType receiver, RN_ComposeOptions options,
+                          const void* data, std::size_t sizeInBytes) = 0;
+    virtual void _compose(PZInteger receiver, RN_ComposeOptions options,
+                          const void* data, std::size_t sizeInBytes) = 0;
     virtual util::Packet* _getCurrentPacket() = 0;
     virtual void _setUserData(util::AnyPtr userData) = 0;
     virtual util::AnyPtr _getUserData() const = 0;
@@ -73,6 +124,7 @@ private:
     template <class taRecepients, class ...taArgs>
     friend void UHOBGOBLIN_RN_ComposeImpl(RN_NodeInterface& node, 
                                           taRecepients&& recepients, 
+                                          RN_ComposeOptions options,
                                           rn_detail::RN_HandlerId handlerId, 
                                           taArgs... args);
 
@@ -101,6 +153,7 @@ T* RN_NodeInterface::getUserDataOrThrow() const {
 template <class taRecepients,  class ...taArgs>
 void UHOBGOBLIN_RN_ComposeImpl(RN_NodeInterface& node,
                                taRecepients&& recepients,
+                               RN_ComposeOptions options,
                                rn_detail::RN_HandlerId handlerId,
                                taArgs... args) {
     util::Packet packet;
@@ -108,16 +161,17 @@ void UHOBGOBLIN_RN_ComposeImpl(RN_NodeInterface& node,
     util::PackArgs(packet, std::forward<taArgs>(args)...);
 
     if constexpr (std::is_same_v<std::remove_cv_t<std::remove_reference_t<taRecepients>>, RN_ComposeForAllType>) {
-        node._compose(RN_ComposeForAllType{}, packet.getData(), packet.getDataSize());
+        node._compose(RN_ComposeForAllType{}, options, packet.getData(), packet.getDataSize());
     }
     else if constexpr (std::is_convertible_v<taRecepients, PZInteger>) {    
         node._compose(std::forward<taRecepients>(recepients),
+                      options,
                       packet.getData(), 
                       packet.getDataSize());
     } 
     else {
         for (PZInteger i : std::forward<taRecepients>(recepients)) {
-            node._compose(i, packet.getData(), packet.getDataSize());
+            node._compose(i, options, packet.getData(), packet.getDataSize());
         }
     }
 }
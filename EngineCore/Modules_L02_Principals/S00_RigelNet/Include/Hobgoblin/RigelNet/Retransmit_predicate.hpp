@@ -21,6 +21,10 @@ namespace rn {
 //!                             since the packet was last sent to the recepient.
 //! \param aTimeSinceLastSend time in microseconds since the packet was last sent to the recepient.
 //! \param aCurrentLatency current estimated (round-trip) latency to the recepient.
+//!
+//! \note once the predicate returns true for a packet, it should keep doing so as cycles and time
+//!       pass. Packets are checked in the order in which they were last sent, and the checking
+//!       stops at the first one which isn't due yet (as the ones sent after it can't be either).
 using RN_RetransmitPredicate = std::function<bool(PZInteger                 aCyclesSinceLasySend,
                                                   std::chrono::microseconds aTimeSinceLastSend,
                                                   std::chrono::microseconds aCurrentLatency)>;
@@ -8,6 +8,7 @@
 #include <Hobgoblin/RigelNet/Connector_interface.hpp>
 #include <Hobgoblin/RigelNet/Node_interface.hpp>
 #include <Hobgoblin/RigelNet/Retransmit_predicate.hpp>
+#include <Hobgoblin/RigelNet/Telemetry.hpp>
 
 #include <chrono>
 #include <cstdint>
@@ -49,6 +50,14 @@ public:
                             bool               aNotifyRemote = true,
                             const std::string& aMessage      = "") = 0;
 
+    //! Returns the telemetry of the connectors of all connected clients, aggregated (see
+    //! `RN_ConnectorInterface::getTelemetry()`).
+    virtual RN_ConnectorTelemetry getClientTelemetry() const = 0;
+
+    //! Starts a new sampling window for the telemetry of the connectors of all clients (see
+    //! `RN_ConnectorInterface::resetTelemetry()`).
+    virtual void resetClientTelemetry() = 0;
+
     ///////////////////////////////////////////////////////////////////////////
     // STATE INSPECTION                                                      //
     ///////////////////////////////////////////////////////////////////////////
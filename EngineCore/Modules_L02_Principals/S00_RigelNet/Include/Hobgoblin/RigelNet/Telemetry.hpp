@@ -8,6 +8,10 @@
 
 #include <Hobgoblin/Common.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstdint>
+
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
 HOBGOBLIN_NAMESPACE_BEGIN
@@ -22,13 +26,26 @@ struct RN_Telemetry {
     //! Note that this does NOT count bytes exchanged between
     //! locally connected nodes.
     hobgoblin::PZInteger downloadByteCount = 0;
+    //! Part of `uploadByteCount` which was spent on retransmitting packets
+    //! (which the remotes didn't acknowledge in time).
+    hobgoblin::PZInteger retransmittedByteCount = 0;
+    //! Payload bytes of the data packets which were large enough to be compressed
+    //! (see `RN_NodeInterface::setCompression()`), before compression. Each packet
+    //! is counted once, when it's sent for the first time.
+    hobgoblin::PZInteger uncompressedPayloadByteCount = 0;
+    //! The same payloads after compression (part of `uploadByteCount`); those
+    //! which didn't shrink are counted at their original size.
+    hobgoblin::PZInteger compressedPayloadByteCount = 0;
 };
 
 inline
 RN_Telemetry operator+(const RN_Telemetry& aLhs, const RN_Telemetry& aRhs) {
     return RN_Telemetry{
-        aLhs.uploadByteCount   + aRhs.uploadByteCount,
-        aLhs.downloadByteCount + aRhs.downloadByteCount
+        aLhs.uploadByteCount              + aRhs.uploadByteCount,
+        aLhs.downloadByteCount            + aRhs.downloadByteCount,
+        aLhs.retransmittedByteCount       + aRhs.retransmittedByteCount,
+        aLhs.uncompressedPayloadByteCount + aRhs.uncompressedPayloadByteCount,
+        aLhs.compressedPayloadByteCount   + aRhs.compressedPayloadByteCount
     };
 }
 
@@ -37,6 +54,111 @@ RN_Telemetry& operator+=(RN_Telemetry& aLhs, const RN_Telemetry& aRhs) {
     return (aLhs = aLhs + aRhs);
 }
 
+//! Detailed statistics of the connection of a single connector, accumulated over a sampling
+//! window: since the connection was established, or since the last call to
+//! `RN_ConnectorInterface::resetTelemetry()` (whichever happened later). The statistics of
+//! several connectors can be aggregated with `operator+` (see also
+//! `RN_ServerInterface::getClientTelemetry()`).
+//! Note that traffic between locally connected nodes isn't counted, except for the processing
+//! time, the buffers and the reassembled packets.
+struct RN_ConnectorTelemetry {
+    //! Time elapsed since the start of the sampling window (when aggregated, the longest one).
+    std::chrono::microseconds windowDuration{0};
+
+    // MARK: Round-trip time
+
+    //! Number of buckets in `rttHistogram`.
+    static constexpr PZInteger RTT_HISTOGRAM_BUCKET_COUNT = 16;
+
+    //! Returns the (exclusive) upper bound of the round-trip times counted in the given bucket of
+    //! `rttHistogram`: 250 microseconds for bucket 0, and twice as much for each next bucket. The
+    //! last bucket has no upper bound (the returned value is `microseconds::max()`).
+    static std::chrono::microseconds getRttHistogramBucketUpperBound(PZInteger aBucket);
+
+    //! Number of measured round-trip times (one for each data packet, from its last transmission
+    //! until its first strong acknowledgement).
+    std::int64_t rttSampleCount = 0;
+    //! Sum of all measured round-trip times.
+    std::chrono::microseconds rttSum{0};
+    //! Sum of the squares of all measured round-trip times (in microseconds).
+    double rttSquaredSum = 0.0;
+    //! Shortest measured round-trip time (0 if none were measured).
+    std::chrono::microseconds rttMin{0};
+    //! Longest measured round-trip time (0 if none were measured).
+    std::chrono::microseconds rttMax{0};
+    //! Number of measured round-trip times by bucket (see `getRttHistogramBucketUpperBound()`).
+    std::array<std::int64_t, RTT_HISTOGRAM_BUCKET_COUNT> rttHistogram{};
+
+    //! Adds a measured round-trip time to the statistics above.
+    void addRttSample(std::chrono::microseconds aRtt);
+
+    //! Mean of the measured round-trip times (0 if none were measured).
+    std::chrono::microseconds getRttMean() const;
+
+    //! Variance of the measured round-trip times, in microseconds squared (its square root is
+    //! the standard deviation). 0 if none were measured.
+    double getRttVariance() const;
+
+    //! Estimated round-trip time under which the given percentage (in the range (0, 100]) of
+    //! the measured ones fall. It's interpolated within the bucket of `rttHistogram` in which
+    //! the percentile falls (and clamped to `[rttMin, rttMax]`). 0 if none were measured.
+    std::chrono::microseconds getRttPercentile(double aPercentage) const;
+
+    // MARK: Packets
+
+    //! Number of datagrams sent to the remote (including retransmissions and acks).
+    std::int64_t sentPacketCount = 0;
+    //! Number of datagrams received from the remote.
+    std::int64_t receivedPacketCount = 0;
+    //! Part of `sentPacketCount` which were retransmissions.
+    std::int64_t retransmittedPacketCount = 0;
+    //! Number of received data packets which were dropped because they had already been
+    //! received before (the remote retransmitted them before it received the acks).
+    std::int64_t duplicatePacketCount = 0;
+    //! Number of packets which were reassembled from fragments (because they didn't fit into a
+    //! single datagram), and the number of fragments they were reassembled from.
+    std::int64_t reassembledPacketCount   = 0;
+    std::int64_t reassembledFragmentCount = 0;
+
+    // MARK: Bytes
+
+    //! Bytes uploaded to the remote (same as `RN_Telemetry::uploadByteCount`).
+    std::int64_t uploadByteCount = 0;
+    //! Bytes downloaded from the remote (same as `RN_Telemetry::downloadByteCount`).
+    std::int64_t downloadByteCount = 0;
+    //! Part of `uploadByteCount` spent on acknowledgements (dedicated ACKS packets, and the acks
+    //! in the headers of data packets).
+    std::int64_t ackByteCount = 0;
+    //! Part of `uploadByteCount` spent on messages (the payloads of data and unreliable packets,
+    //! after compression, including retransmissions).
+    std::int64_t payloadByteCount = 0;
+
+    // MARK: Buffers
+
+    //! Number of packets in the send buffer and in the receive buffer at the time of the
+    //! snapshot (see `RN_ConnectorInterface::getSendBufferSize()`). Summed when aggregated.
+    PZInteger sendBufferLength = 0;
+    PZInteger recvBufferLength = 0;
+    //! The highest numbers of packets in the buffers (at the end of an update) during the
+    //! sampling window. When aggregated, the highest of any connector.
+    PZInteger maxSendBufferLength = 0;
+    PZInteger maxRecvBufferLength = 0;
+
+    // MARK: Processing time
+
+    //! Time spent preparing and sending packets.
+    std::chrono::microseconds sendProcessingTime{0};
+    //! Time spent processing received packets (not including the handlers of the messages).
+    std::chrono::microseconds receiveProcessingTime{0};
+};
+
+RN_ConnectorTelemetry operator+(const RN_ConnectorTelemetry& aLhs, const RN_ConnectorTelemetry& aRhs);
+
+inline
+RN_ConnectorTelemetry& operator+=(RN_ConnectorTelemetry& aLhs, const RN_ConnectorTelemetry& aRhs) {
+    return (aLhs = aLhs + aRhs);
+}
+
 } // namespace rn
 HOBGOBLIN_NAMESPACE_END
 
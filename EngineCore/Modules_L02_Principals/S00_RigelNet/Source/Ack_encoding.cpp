@@ -0,0 +1,63 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Ack_encoding.hpp"
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <algorithm>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+namespace {
+constexpr PacketOrdinal MAX_BITMAP_SPAN = 32; //!< Ordinals covered by a mask (after the base)
+} // namespace
+
+void PrepareAcks(std::vector<PacketOrdinal>& aAcks) {
+    // Acks are usually collected in (almost) ascending order already
+    if (!std::is_sorted(aAcks.begin(), aAcks.end())) {
+        std::sort(aAcks.begin(), aAcks.end());
+    }
+    aAcks.erase(std::unique(aAcks.begin(), aAcks.end()), aAcks.end());
+}
+
+PZInteger CountAckBitmaps(const std::vector<PacketOrdinal>& aAcks) {
+    PZInteger count = 0;
+    for (std::size_t i = 0; i < aAcks.size();) {
+        const PacketOrdinal base = aAcks[i];
+        i += 1;
+        while (i < aAcks.size() && aAcks[i] - base <= MAX_BITMAP_SPAN) {
+            i += 1;
+        }
+        count += 1;
+    }
+    return count;
+}
+
+void WriteAckBitmaps(util::Packet&               aPacket,
+                     std::vector<PacketOrdinal>& aAcks,
+                     PZInteger                   aMaxEntryCount) {
+    HG_ASSERT(std::is_sorted(aAcks.begin(), aAcks.end()));
+
+    std::size_t i = 0;
+    for (PZInteger entry = 0; entry < aMaxEntryCount && i < aAcks.size(); entry += 1) {
+        const PacketOrdinal base = aAcks[i];
+        std::uint32_t       mask = 0;
+        i += 1;
+        while (i < aAcks.size() && aAcks[i] - base <= MAX_BITMAP_SPAN) {
+            mask |= (std::uint32_t{1} << (aAcks[i] - base - 1));
+            i += 1;
+        }
+        aPacket << base << mask;
+    }
+
+    aAcks.erase(aAcks.begin(), aAcks.begin() + static_cast<std::ptrdiff_t>(i));
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
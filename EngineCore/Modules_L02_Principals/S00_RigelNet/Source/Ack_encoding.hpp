@@ -0,0 +1,66 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_ACK_ENCODING_HPP
+#define UHOBGOBLIN_RN_ACK_ENCODING_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/Packet.hpp>
+
+#include "Packet_ordinal.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! How acknowledgements are written into ACKS packets and DATA packet headers.
+enum class AckEncoding {
+    //! One `PacketOrdinal` per acknowledged packet (the original encoding, which every peer
+    //! understands).
+    ORDINAL_LIST,
+
+    //! Ordinals are grouped into bitmap entries (see `WriteAckBitmaps()`). Used only if both
+    //! peers agreed on it during the handshake (see `UDP_FEATURE_COMPACT_ACKS`).
+    BITMAPS
+};
+
+//! Size of a single bitmap entry in bytes: base ordinal + 32-bit mask.
+constexpr PZInteger ACK_BITMAP_ENTRY_BYTE_COUNT = sizeof(PacketOrdinal) + sizeof(std::uint32_t);
+
+//! Sorts the acks and removes duplicates (the order in which acks are sent doesn't matter).
+//! Both functions below expect the acks to be prepared like this.
+void PrepareAcks(std::vector<PacketOrdinal>& aAcks);
+
+//! Returns how many bitmap entries are needed to encode all of the given (prepared) acks.
+PZInteger CountAckBitmaps(const std::vector<PacketOrdinal>& aAcks);
+
+//! Writes at most `aMaxEntryCount` bitmap entries, encoding as many of the given (prepared)
+//! acks as fit into them, to the packet, and removes the encoded acks from the vector.
+//! Each entry consists of a base ordinal followed by a 32-bit mask in which bit N set means
+//! that ordinal `base + 1 + N` is acknowledged as well, so one entry (8 bytes) can cover up
+//! to 33 consecutive packets.
+void WriteAckBitmaps(util::Packet&               aPacket,
+                     std::vector<PacketOrdinal>& aAcks,
+                     PZInteger                   aMaxEntryCount);
+
+//! Calls `aFunc(PacketOrdinal)` for each ordinal encoded in the bitmap entry.
+template <class taFunc>
+void ForEachAckInBitmap(PacketOrdinal aBase, std::uint32_t aMask, taFunc&& aFunc) {
+    aFunc(aBase);
+    for (std::uint32_t bit = 0; aMask != 0; bit += 1, aMask >>= 1) {
+        if ((aMask & 1u) != 0) {
+            aFunc(aBase + 1 + bit);
+        }
+    }
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_RN_ACK_ENCODING_HPP
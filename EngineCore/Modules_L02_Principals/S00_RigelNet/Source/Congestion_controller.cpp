@@ -0,0 +1,247 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Congestion_controller.hpp"
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <algorithm>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+namespace {
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// Retransmit timeout (RFC 6298, but with bounds more suitable for real-time applications)
+constexpr microseconds INITIAL_RETRANSMIT_TIMEOUT = milliseconds{250};
+constexpr microseconds MIN_RETRANSMIT_TIMEOUT     = milliseconds{10};
+constexpr microseconds MAX_RETRANSMIT_TIMEOUT     = milliseconds{2000};
+constexpr microseconds CLOCK_GRANULARITY          = milliseconds{1};
+
+//! The lowest RTT is forgotten after this long, so that a changed route doesn't leave it stuck.
+constexpr microseconds MIN_RTT_LIFETIME = milliseconds{10'000};
+
+constexpr PZInteger INITIAL_WINDOW_PACKET_COUNT = 10;
+constexpr PZInteger MAX_WINDOW_BYTE_COUNT       = 1 << 30;
+
+// Pacing
+constexpr std::int64_t PACING_GAIN_NUMERATOR   = 5;
+constexpr std::int64_t PACING_GAIN_DENOMINATOR = 4;
+constexpr microseconds MIN_PACING_RTT          = milliseconds{1};
+//! Longer pauses between rounds of sending don't make more bytes available.
+constexpr microseconds MAX_PACING_INTERVAL = milliseconds{100};
+//! Unused budget which can be carried over into the next round of sending (in packets).
+constexpr PZInteger MAX_PACING_CARRY_OVER_PACKET_COUNT = 2;
+
+//! Target queueing delay of the delay-based algorithm (on top of the lowest RTT).
+constexpr microseconds TARGET_QUEUEING_DELAY = milliseconds{25};
+
+microseconds ClampRetransmitTimeout(microseconds aTimeout) {
+    return std::clamp(aTimeout, MIN_RETRANSMIT_TIMEOUT, MAX_RETRANSMIT_TIMEOUT);
+}
+
+//! Never limits anything; only measures the RTT.
+class UnlimitedController : public CongestionController {
+public:
+    explicit UnlimitedController(PZInteger aMaxPacketSize)
+        : CongestionController{RN_CongestionControl::None, aMaxPacketSize} {}
+
+private:
+    void _onAcked(PZInteger, PZInteger) override {}
+    void _onLossEvent() override {}
+};
+
+//! Slow start followed by additive increase, multiplicative decrease (like TCP NewReno).
+class LossBasedController : public CongestionController {
+public:
+    explicit LossBasedController(PZInteger aMaxPacketSize)
+        : CongestionController{RN_CongestionControl::LossBased, aMaxPacketSize} {
+        _congestionWindow = INITIAL_WINDOW_PACKET_COUNT * _maxPacketSize;
+    }
+
+private:
+    PZInteger _slowStartThreshold = MAX_WINDOW_BYTE_COUNT;
+
+    void _onAcked(PZInteger aByteCount, PZInteger /*aBytesInFlight*/) override {
+        if (_congestionWindow < _slowStartThreshold) {
+            _setCongestionWindow(std::int64_t{_congestionWindow} + aByteCount);
+        } else {
+            // About one packet per round trip
+            const auto increase = std::int64_t{_maxPacketSize} * aByteCount / _congestionWindow;
+            _setCongestionWindow(_congestionWindow + std::max<std::int64_t>(1, increase));
+        }
+    }
+
+    void _onLossEvent() override {
+        _slowStartThreshold = std::max(_congestionWindow / 2, _getMinCongestionWindow());
+        _setCongestionWindow(_slowStartThreshold);
+    }
+};
+
+//! Grows the window while the queueing delay is below the target and shrinks it when it's above
+//! (similar to LEDBAT, RFC 6817), after a slow start which ends once delay starts building up.
+class DelayBasedController : public CongestionController {
+public:
+    explicit DelayBasedController(PZInteger aMaxPacketSize)
+        : CongestionController{RN_CongestionControl::DelayBased, aMaxPacketSize} {
+        _congestionWindow = INITIAL_WINDOW_PACKET_COUNT * _maxPacketSize;
+    }
+
+private:
+    bool _inSlowStart = true;
+
+    void _onAcked(PZInteger aByteCount, PZInteger /*aBytesInFlight*/) override {
+        if (_latestRtt < microseconds::zero() || _minRtt < microseconds::zero()) {
+            return;
+        }
+
+        const auto queueingDelay = _latestRtt - _minRtt;
+        if (_inSlowStart && queueingDelay < TARGET_QUEUEING_DELAY / 2) {
+            _setCongestionWindow(std::int64_t{_congestionWindow} + aByteCount);
+            return;
+        }
+        _inSlowStart = false;
+
+        // Scaled by how far off target the delay is (in the range [-1, 1]); at most one packet
+        // per round trip in either direction
+        const auto offTarget = std::clamp<std::int64_t>(
+            (TARGET_QUEUEING_DELAY - queueingDelay).count(),
+            -TARGET_QUEUEING_DELAY.count(),
+            TARGET_QUEUEING_DELAY.count());
+        const auto change = offTarget * _maxPacketSize * aByteCount /
+                            (TARGET_QUEUEING_DELAY.count() * std::int64_t{_congestionWindow});
+        _setCongestionWindow(_congestionWindow + change);
+    }
+
+    void _onLossEvent() override {
+        _inSlowStart = false;
+        _setCongestionWindow(_congestionWindow / 2);
+    }
+};
+} // namespace
+
+std::unique_ptr<CongestionController> CongestionController::create(RN_CongestionControl aAlgorithm,
+                                                                   PZInteger aMaxPacketSize) {
+    switch (aAlgorithm) {
+    case RN_CongestionControl::None:
+        return std::make_unique<UnlimitedController>(aMaxPacketSize);
+
+    case RN_CongestionControl::LossBased:
+        return std::make_unique<LossBasedController>(aMaxPacketSize);
+
+    case RN_CongestionControl::DelayBased:
+        return std::make_unique<DelayBasedController>(aMaxPacketSize);
+
+    default:
+        HG_UNREACHABLE("Invalid value for RN_CongestionControl ({}).", (int)aAlgorithm);
+    }
+    return nullptr;
+}
+
+CongestionController::CongestionController(RN_CongestionControl aAlgorithm, PZInteger aMaxPacketSize)
+    : _maxPacketSize{aMaxPacketSize}
+    , _algorithm{aAlgorithm}
+    , _retransmitTimeout{INITIAL_RETRANSMIT_TIMEOUT} {}
+
+void CongestionController::onRttSample(microseconds aRtt) {
+    _latestRtt = aRtt;
+
+    if (_smoothedRtt < microseconds::zero()) {
+        _smoothedRtt = aRtt;
+        _rttVariance = aRtt / 2;
+    } else {
+        const auto deviation = (_smoothedRtt > aRtt) ? (_smoothedRtt - aRtt) : (aRtt - _smoothedRtt);
+        _rttVariance         = (3 * _rttVariance + deviation) / 4;
+        _smoothedRtt         = (7 * _smoothedRtt + aRtt) / 8;
+    }
+    _retransmitTimeout =
+        ClampRetransmitTimeout(_smoothedRtt + std::max(CLOCK_GRANULARITY, 4 * _rttVariance));
+
+    if (_minRtt < microseconds::zero() || aRtt < _minRtt ||
+        _minRttStopwatch.getElapsedTime<microseconds>() >= MIN_RTT_LIFETIME) {
+        _minRtt = aRtt;
+        _minRttStopwatch.restart();
+    }
+}
+
+bool CongestionController::isRetransmitAllowed(microseconds aTimeSinceLastSend,
+                                               PZInteger    aTransmissionCount) const {
+    if (_algorithm == RN_CongestionControl::None) {
+        return true;
+    }
+
+    auto timeout = _retransmitTimeout;
+    for (PZInteger i = 1; i < aTransmissionCount && timeout < MAX_RETRANSMIT_TIMEOUT; i += 1) {
+        timeout *= 2;
+    }
+    return aTimeSinceLastSend >= ClampRetransmitTimeout(timeout);
+}
+
+void CongestionController::onPacketAcked(PZInteger aByteCount, PZInteger aBytesInFlight) {
+    // Don't grow the window when it's not being used (so that it reflects what the network
+    // can actually handle when the application starts sending more)
+    if (aBytesInFlight < _congestionWindow / 2) {
+        return;
+    }
+    _onAcked(aByteCount, aBytesInFlight);
+}
+
+void CongestionController::onPacketLost(PacketOrdinal aPacketOrdinal,
+                                        PacketOrdinal aNextUnsentOrdinal) {
+    if (aPacketOrdinal < _recoveryOrdinal) {
+        return;
+    }
+    _recoveryOrdinal = aNextUnsentOrdinal;
+    _lossEventCount += 1;
+    _onLossEvent();
+}
+
+void CongestionController::beginSending() {
+    const auto elapsed = std::min(_pacingStopwatch.restart<microseconds>(), MAX_PACING_INTERVAL);
+    const auto rate    = _getPacingRate();
+    if (rate == 0) {
+        _pacingBudget = 0;
+        return;
+    }
+
+    _pacingBudget = std::min<std::int64_t>(_pacingBudget,
+                                           MAX_PACING_CARRY_OVER_PACKET_COUNT * _maxPacketSize);
+    _pacingBudget += rate * elapsed.count() / 1'000'000;
+}
+
+RN_CongestionControlState CongestionController::getState(PZInteger aBytesInFlight) const {
+    RN_CongestionControlState state;
+    state.algorithm         = _algorithm;
+    state.congestionWindow  = _congestionWindow;
+    state.bytesInFlight     = aBytesInFlight;
+    state.pacingRate        = static_cast<PZInteger>(std::min<std::int64_t>(_getPacingRate(), 1 << 30));
+    state.smoothedRtt       = _smoothedRtt;
+    state.rttVariance       = _rttVariance;
+    state.retransmitTimeout = _retransmitTimeout;
+    state.lossEventCount    = _lossEventCount;
+    return state;
+}
+
+void CongestionController::_setCongestionWindow(std::int64_t aCongestionWindow) {
+    _congestionWindow = static_cast<PZInteger>(std::clamp<std::int64_t>(aCongestionWindow,
+                                                                        _getMinCongestionWindow(),
+                                                                        MAX_WINDOW_BYTE_COUNT));
+}
+
+std::int64_t CongestionController::_getPacingRate() const {
+    if (_congestionWindow == 0 || _smoothedRtt < microseconds::zero()) {
+        return 0;
+    }
+    const auto rtt = std::max(_smoothedRtt, MIN_PACING_RTT);
+    return std::int64_t{_congestionWindow} * 1'000'000 * PACING_GAIN_NUMERATOR /
+           (rtt.count() * PACING_GAIN_DENOMINATOR);
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
@@ -0,0 +1,134 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_CONGESTION_CONTROLLER_HPP
+#define UHOBGOBLIN_RN_CONGESTION_CONTROLLER_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/RigelNet/Congestion_control.hpp>
+#include <Hobgoblin/Utility/Time_utils.hpp>
+
+#include "Packet_ordinal.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Decides how much data a send buffer may have in flight and how fast it may send it.
+//! The round-trip time estimation (and the retransmit timeout derived from it, as per RFC 6298)
+//! and the pacing are common to all algorithms; subclasses only decide how the congestion
+//! window reacts to acknowledgements and losses.
+class CongestionController {
+public:
+    //! Creates a controller implementing the given algorithm.
+    static std::unique_ptr<CongestionController> create(RN_CongestionControl aAlgorithm,
+                                                        PZInteger            aMaxPacketSize);
+
+    virtual ~CongestionController() = default;
+
+    RN_CongestionControl getAlgorithm() const {
+        return _algorithm;
+    }
+
+    // MARK: Round-trip time
+
+    //! Feeds a new round-trip time measurement. Measurements must come only from packets which
+    //! were transmitted exactly once (otherwise it's unknown which transmission was acked).
+    void onRttSample(std::chrono::microseconds aRtt);
+
+    //! Returns whether a packet which was already transmitted `aTransmissionCount` times, the
+    //! last time `aTimeSinceLastSend` ago, may be retransmitted (this is checked in addition to
+    //! the retransmit predicate). The retransmit timeout doubles with each retransmission.
+    bool isRetransmitAllowed(std::chrono::microseconds aTimeSinceLastSend,
+                             PZInteger                 aTransmissionCount) const;
+
+    // MARK: Congestion window
+
+    //! Returns whether a packet (new or retransmitted) may be sent now.
+    bool canSendPacket(PZInteger aBytesInFlight) const {
+        return _congestionWindow == 0 || aBytesInFlight < _congestionWindow;
+    }
+
+    //! Informs the controller that a packet of `aByteCount` bytes was acknowledged, while
+    //! `aBytesInFlight` bytes (including that packet) were in flight.
+    void onPacketAcked(PZInteger aByteCount, PZInteger aBytesInFlight);
+
+    //! Informs the controller that the packet with the given ordinal is considered lost (because
+    //! it's about to be retransmitted). Only the first loss among the packets sent before the
+    //! previous reaction is reacted to (so a burst of losses counts as a single event);
+    //! `aNextUnsentOrdinal` is the ordinal of the first packet which wasn't sent yet.
+    void onPacketLost(PacketOrdinal aPacketOrdinal, PacketOrdinal aNextUnsentOrdinal);
+
+    // MARK: Pacing
+
+    //! Must be called before each round of sending; makes more bytes available for sending,
+    //! in proportion to the time that passed since the previous call.
+    void beginSending();
+
+    //! Returns whether sending must stop until the next round because the pacing budget
+    //! is used up.
+    bool isPacingLimited() const {
+        return _getPacingRate() > 0 && _pacingBudget <= 0;
+    }
+
+    //! Informs the controller that a datagram of `aByteCount` bytes was sent.
+    void onPacketSent(PZInteger aByteCount) {
+        _pacingBudget -= aByteCount;
+    }
+
+    // MARK: Telemetry
+
+    RN_CongestionControlState getState(PZInteger aBytesInFlight) const;
+
+protected:
+    CongestionController(RN_CongestionControl aAlgorithm, PZInteger aMaxPacketSize);
+
+    const PZInteger _maxPacketSize;
+
+    //! Maximal number of bytes in flight, or 0 for no limit.
+    PZInteger _congestionWindow = 0;
+
+    std::chrono::microseconds _latestRtt{-1};
+    std::chrono::microseconds _minRtt{-1}; //!< Lowest RTT seen in the current window
+
+    PZInteger _getMinCongestionWindow() const {
+        return 2 * _maxPacketSize;
+    }
+
+    void _setCongestionWindow(std::int64_t aCongestionWindow);
+
+    //! Called after a new RTT sample was accounted for.
+    virtual void _onAcked(PZInteger aByteCount, PZInteger aBytesInFlight) = 0;
+
+    //! Called once per loss event.
+    virtual void _onLossEvent() = 0;
+
+private:
+    RN_CongestionControl _algorithm;
+
+    std::chrono::microseconds _smoothedRtt{-1};
+    std::chrono::microseconds _rttVariance{-1};
+    std::chrono::microseconds _retransmitTimeout;
+    util::Stopwatch           _minRttStopwatch;
+
+    PacketOrdinal _recoveryOrdinal = 0;
+    PZInteger     _lossEventCount  = 0;
+
+    std::int64_t    _pacingBudget = 0;
+    util::Stopwatch _pacingStopwatch;
+
+    //! In bytes per second; 0 means no pacing.
+    std::int64_t _getPacingRate() const;
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_RN_CONGESTION_CONTROLLER_HPP
@@ -39,6 +39,30 @@ public:
 
     RN_Telemetry update(RN_UpdateMode mode) override { return {}; }
 
+    void setIoThreadEnabled(bool aEnabled) override {}
+
+    bool isIoThreadEnabled() const noexcept override {
+        return false;
+    }
+
+    void setCompactAcksEnabled(bool aEnabled) override {}
+
+    bool isCompactAcksEnabled() const noexcept override {
+        return false;
+    }
+
+    void setCongestionControl(RN_CongestionControl aCongestionControl) override {}
+
+    RN_CongestionControl getCongestionControl() const noexcept override {
+        return RN_CongestionControl::None;
+    }
+
+    void setCompression(const RN_CompressionSettings& aCompression) override {}
+
+    const RN_CompressionSettings& getCompression() const noexcept override {
+        return _compression;
+    }
+
     void addEventListener(NeverNull<RN_EventListener*> aEventListener) override {}
 
     void removeEventListener(NeverNull<RN_EventListener*> aEventListener) override {}
@@ -61,6 +85,12 @@ public:
                     bool               aNotifyRemote,
                     const std::string& aMessage) override {}
 
+    RN_ConnectorTelemetry getClientTelemetry() const override {
+        return {};
+    }
+
+    void resetClientTelemetry() override {}
+
     ///////////////////////////////////////////////////////////////////////////
     // STATE INSPECTION                                                      //
     ///////////////////////////////////////////////////////////////////////////
@@ -104,11 +134,18 @@ public:
     }
 
 private:
-    std::string _passphrase = "";
-
-    void _compose(RN_ComposeForAllType receiver, const void* data, std::size_t sizeInBytes) override {}
-
-    void _compose(PZInteger receiver, const void* data, std::size_t sizeInBytes) override {}
+    std::string            _passphrase = "";
+    RN_CompressionSettings _compression;
+
+    void _compose(RN_ComposeForAllType receiver,
+                  RN_ComposeOptions    options,
+                  const void*          data,
+                  std::size_t          sizeInBytes) override {}
+
+    void _compose(PZInteger         receiver,
+                  RN_ComposeOptions options,
+                  const void*       data,
+                  std::size_t       sizeInBytes) override {}
 
     util::Packet* _getCurrentPacket() override { return nullptr; }
 
@@ -0,0 +1,332 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Native_udp_socket.hpp"
+
+#ifdef __linux__
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+namespace {
+//! Converts `errno` (after a failed socket call) to a status in the same way SFML does.
+sf::Socket::Status GetErrorStatus() {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return sf::Socket::NotReady;
+    }
+    if (errno == ECONNRESET || errno == ECONNREFUSED) {
+        return sf::Socket::Disconnected;
+    }
+    return sf::Socket::Error;
+}
+
+//! Same as `GetErrorStatus()`, except that a lack of buffer space in the OS (`ENOBUFS`) is also
+//! reported as `NotReady`, because the datagram can be sent again later.
+sf::Socket::Status GetSendErrorStatus() {
+    if (errno == ENOBUFS) {
+        return sf::Socket::NotReady;
+    }
+    return GetErrorStatus();
+}
+
+//! Returns true if `errno` (after a failed send) only concerns the datagram that was being sent
+//! (for example, because its destination is unreachable), and not the socket as a whole.
+bool IsDatagramError() {
+    switch (errno) {
+    case EACCES:
+    case EAFNOSUPPORT:
+    case ECONNREFUSED:
+    case EDESTADDRREQ:
+    case EHOSTDOWN:
+    case EHOSTUNREACH:
+    case EINVAL:
+    case EMSGSIZE:
+    case ENETDOWN:
+    case ENETUNREACH:
+    case EPERM:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+sockaddr_in MakeAddress(const sf::IpAddress& aIpAddress, std::uint16_t aPort) {
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(aPort);
+    address.sin_addr.s_addr = htonl(aIpAddress.toInteger());
+    return address;
+}
+} // namespace
+
+RN_NativeUdpSocket::~RN_NativeUdpSocket() {
+    unbind();
+}
+
+void RN_NativeUdpSocket::init(PZInteger aMaxDatagramSize) {
+    HG_VALIDATE_ARGUMENT(aMaxDatagramSize > 0);
+
+    _maxDatagramSize = aMaxDatagramSize;
+    _prepareBatch(_recvBatch);
+    _prepareBatch(_sendBatch);
+}
+
+sf::Socket::Status RN_NativeUdpSocket::bind(std::uint16_t aLocalPort, const sf::IpAddress& aIpAddress) {
+    unbind();
+    _open();
+
+    const auto address = MakeAddress(aIpAddress, aLocalPort);
+    if (::bind(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(_fd);
+        _fd = -1;
+        return sf::Socket::Error;
+    }
+    return sf::Socket::Done;
+}
+
+void RN_NativeUdpSocket::unbind() {
+    if (_fd < 0) {
+        return;
+    }
+
+    (void)flush();
+    ::close(_fd);
+
+    _fd          = -1;
+    _sendCount   = 0;
+    _recvCount   = 0;
+    _recvNext    = 0;
+    _recvDrained = false;
+}
+
+std::uint16_t RN_NativeUdpSocket::getLocalPort() const {
+    if (_fd < 0) {
+        return 0;
+    }
+
+    sockaddr_in address;
+    socklen_t   addressLength = sizeof(address);
+    if (::getsockname(_fd, reinterpret_cast<sockaddr*>(&address), &addressLength) != 0) {
+        return 0;
+    }
+    return ntohs(address.sin_port);
+}
+
+int RN_NativeUdpSocket::getNativeHandle() const noexcept {
+    return _fd;
+}
+
+sf::Socket::Status RN_NativeUdpSocket::send(const void*          aData,
+                                            std::size_t          aByteCount,
+                                            const sf::IpAddress& aTargetAddress,
+                                            std::uint16_t        aTargetPort) {
+    const iovec piece{const_cast<void*>(aData), aByteCount};
+    return send(&piece, 1, aTargetAddress, aTargetPort);
+}
+
+sf::Socket::Status RN_NativeUdpSocket::send(const iovec*         aPieces,
+                                            std::size_t          aPieceCount,
+                                            const sf::IpAddress& aTargetAddress,
+                                            std::uint16_t        aTargetPort) {
+    if (_fd < 0) {
+        _open();
+    }
+
+    std::size_t byteCount = 0;
+    for (std::size_t i = 0; i < aPieceCount; i += 1) {
+        byteCount += aPieces[i].iov_len;
+    }
+
+    if (byteCount > pztos(_maxDatagramSize)) {
+        // Doesn't fit into a batch slot; flush the queue first to preserve ordering
+        const auto status = flush();
+        if (status != sf::Socket::Done) {
+            return status;
+        }
+
+        auto address = MakeAddress(aTargetAddress, aTargetPort);
+
+        msghdr header;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_name    = &address;
+        header.msg_namelen = sizeof(address);
+        header.msg_iov     = const_cast<iovec*>(aPieces);
+        header.msg_iovlen  = aPieceCount;
+
+        if (::sendmsg(_fd, &header, 0) < 0 && !IsDatagramError()) {
+            return GetSendErrorStatus();
+        }
+        return sf::Socket::Done;
+    }
+
+    if (_sendCount == BATCH_SIZE) {
+        // Unsent datagrams stay queued, so there's room only if the flush got some of them out
+        const auto status = flush();
+        if (status == sf::Socket::Error || _sendCount == BATCH_SIZE) {
+            return status;
+        }
+    }
+
+    const auto slot   = pztos(_sendCount);
+    auto*      target = static_cast<std::uint8_t*>(_sendBatch.iovecs[slot].iov_base);
+    for (std::size_t i = 0; i < aPieceCount; i += 1) {
+        std::memcpy(target, aPieces[i].iov_base, aPieces[i].iov_len);
+        target += aPieces[i].iov_len;
+    }
+    _sendBatch.iovecs[slot].iov_len = byteCount;
+    _sendBatch.addresses[slot]      = MakeAddress(aTargetAddress, aTargetPort);
+    _sendCount += 1;
+
+    return sf::Socket::Done;
+}
+
+sf::Socket::Status RN_NativeUdpSocket::flush() {
+    auto      status = sf::Socket::Done;
+    PZInteger sent   = 0;
+
+    while (sent < _sendCount) {
+        const int res =
+            _sendDatagrams(&_sendBatch.headers[pztos(sent)], static_cast<unsigned>(_sendCount - sent));
+        if (res < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (IsDatagramError()) {
+                // Only the first unsent datagram was rejected; skip it and send the rest
+                sent += 1;
+                continue;
+            }
+            // Keep whatever wasn't sent for the next flush
+            status = GetSendErrorStatus();
+            break;
+        }
+        sent += res;
+    }
+
+    _dropSentDatagrams(sent);
+    return status;
+}
+
+sf::Socket::Status RN_NativeUdpSocket::receive(util::Packet&  aPacket,
+                                               sf::IpAddress& aRemoteAddress,
+                                               std::uint16_t& aRemotePort) {
+    while (true) {
+        if (_recvNext == _recvCount) {
+            if (_recvDrained || _fd < 0) {
+                // The last batch didn't fill up, so there was nothing left to receive at the time;
+                // report that instead of making another system call to find out the same thing
+                _recvDrained = false;
+                return sf::Socket::NotReady;
+            }
+
+            for (auto& header : _recvBatch.headers) {
+                header.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                header.msg_hdr.msg_flags   = 0;
+            }
+
+            int res;
+            do {
+                res = ::recvmmsg(_fd,
+                                 _recvBatch.headers.data(),
+                                 static_cast<unsigned>(BATCH_SIZE),
+                                 MSG_DONTWAIT,
+                                 nullptr);
+            } while (res < 0 && errno == EINTR);
+
+            if (res < 0) {
+                return GetErrorStatus();
+            }
+
+            _recvCount   = res;
+            _recvNext    = 0;
+            _recvDrained = (res < BATCH_SIZE);
+            continue;
+        }
+
+        const auto  index   = pztos(_recvNext);
+        const auto& header  = _recvBatch.headers[index];
+        const auto& address = _recvBatch.addresses[index];
+        _recvNext += 1;
+
+        if ((header.msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+            // Datagram was larger than the maximum size; drop it
+            continue;
+        }
+
+        const auto bytesWritten = aPacket.write(_recvBatch.iovecs[index].iov_base,
+                                                static_cast<std::int64_t>(header.msg_len));
+        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(header.msg_len));
+
+        aRemoteAddress = sf::IpAddress{ntohl(address.sin_addr.s_addr)};
+        aRemotePort    = ntohs(address.sin_port);
+
+        return sf::Socket::Done;
+    }
+}
+
+int RN_NativeUdpSocket::_sendDatagrams(mmsghdr* aHeaders, unsigned aCount) {
+    return ::sendmmsg(_fd, aHeaders, aCount, MSG_DONTWAIT);
+}
+
+void RN_NativeUdpSocket::_open() {
+    _fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        HG_THROW_TRACED(TracedRuntimeError, errno, "Failed to create socket.");
+    }
+}
+
+void RN_NativeUdpSocket::_prepareBatch(Batch& aBatch) {
+    const auto maxDatagramSize = pztos(_maxDatagramSize);
+    const auto batchSize       = pztos(BATCH_SIZE);
+
+    aBatch.buffer.resize(batchSize * maxDatagramSize);
+    aBatch.headers.resize(batchSize);
+    aBatch.iovecs.resize(batchSize);
+    aBatch.addresses.resize(batchSize);
+
+    for (std::size_t i = 0; i < batchSize; i += 1) {
+        aBatch.iovecs[i].iov_base = aBatch.buffer.data() + i * maxDatagramSize;
+        aBatch.iovecs[i].iov_len  = maxDatagramSize;
+
+        auto& header = aBatch.headers[i];
+        std::memset(&header, 0, sizeof(header));
+        header.msg_hdr.msg_name    = &aBatch.addresses[i];
+        header.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        header.msg_hdr.msg_iov     = &aBatch.iovecs[i];
+        header.msg_hdr.msg_iovlen  = 1;
+    }
+}
+
+void RN_NativeUdpSocket::_dropSentDatagrams(PZInteger aSentCount) {
+    const auto sentCount = pztos(aSentCount);
+    const auto remaining = pztos(_sendCount) - sentCount;
+
+    // Move the unsent datagrams to the front of the queue (slots never overlap)
+    for (std::size_t i = 0; i < remaining && sentCount > 0; i += 1) {
+        const auto& source = _sendBatch.iovecs[sentCount + i];
+        std::memcpy(_sendBatch.iovecs[i].iov_base, source.iov_base, source.iov_len);
+        _sendBatch.iovecs[i].iov_len = source.iov_len;
+        _sendBatch.addresses[i]      = _sendBatch.addresses[sentCount + i];
+    }
+
+    _sendCount = static_cast<PZInteger>(remaining);
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // __linux__
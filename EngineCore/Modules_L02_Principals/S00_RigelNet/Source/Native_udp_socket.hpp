@@ -0,0 +1,124 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_NATIVE_UDP_SOCKET_HPP
+#define UHOBGOBLIN_RN_NATIVE_UDP_SOCKET_HPP
+
+#ifdef __linux__
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/No_copy_no_move.hpp>
+#include <Hobgoblin/Utility/Packet.hpp>
+#include <SFML/Network.hpp>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Non-blocking UDP socket which uses the native Linux socket API to send and receive datagrams
+//! in batches, so that a single system call (`recvmmsg` / `sendmmsg`) moves up to `BATCH_SIZE`
+//! datagrams. All buffers are allocated once (in `init()`) and reused for every batch.
+//!
+//! The interface mirrors that of `sf::UdpSocket` (methods return `sf::Socket::Status`), except
+//! that `send()` only queues a datagram - queued datagrams are sent when `flush()` is called or
+//! when the queue fills up.
+class RN_NativeUdpSocket
+    : NO_COPY
+    , NO_MOVE {
+public:
+    //! Maximum number of datagrams sent or received with a single system call.
+    static constexpr PZInteger BATCH_SIZE = 64;
+
+    RN_NativeUdpSocket() = default;
+    virtual ~RN_NativeUdpSocket();
+
+    //! Allocates the send and receive buffers.
+    //! \param aMaxDatagramSize maximum size of datagrams that can be received (larger ones are
+    //!                         dropped). Larger datagrams can still be sent, but without batching.
+    void init(PZInteger aMaxDatagramSize);
+
+    sf::Socket::Status bind(std::uint16_t aLocalPort, const sf::IpAddress& aIpAddress);
+
+    //! Sends all queued datagrams (ignoring errors) and closes the socket.
+    void unbind();
+
+    std::uint16_t getLocalPort() const;
+
+    //! Returns the file descriptor of the socket (-1 if it isn't open).
+    int getNativeHandle() const noexcept;
+
+    //! Queues a datagram for sending. Datagrams rejected by the OS because of their destination
+    //! (for example, an unreachable host) are dropped as if they were lost on the way.
+    //! \returns `Done` if the datagram was queued (or sent). If the queue was full, it is flushed
+    //!          first; `NotReady` (and nothing is queued) if the socket's send buffer is full and
+    //!          there is still no room for the datagram, so it has to be sent again later.
+    //!          `Error` (and nothing is queued) if the socket itself failed.
+    sf::Socket::Status send(const void*          aData,
+                            std::size_t          aByteCount,
+                            const sf::IpAddress& aTargetAddress,
+                            std::uint16_t        aTargetPort);
+
+    //! Same as the above, except that the datagram is gathered from several pieces (in the
+    //! given order). The pieces are copied straight into the queue, or handed to the OS as
+    //! they are if the datagram is too large to be queued.
+    sf::Socket::Status send(const iovec*         aPieces,
+                            std::size_t          aPieceCount,
+                            const sf::IpAddress& aTargetAddress,
+                            std::uint16_t        aTargetPort);
+
+    //! Sends all queued datagrams. A datagram rejected because of its destination is skipped and
+    //! the rest are still sent. Datagrams which could not be sent because the socket's send
+    //! buffer was full stay queued (in order) for the next flush, and `NotReady` is returned.
+    sf::Socket::Status flush();
+
+    //! Writes the next received datagram into `aPacket`. Receives a new batch from the OS when
+    //! all previously received datagrams have been consumed.
+    sf::Socket::Status receive(util::Packet&  aPacket,
+                               sf::IpAddress& aRemoteAddress,
+                               std::uint16_t& aRemotePort);
+
+protected:
+    //! Hands `aCount` datagrams to the OS (`sendmmsg`). Returns the number of datagrams sent, or
+    //! -1 with `errno` set. Can be overridden to simulate a full send buffer in tests.
+    virtual int _sendDatagrams(mmsghdr* aHeaders, unsigned aCount);
+
+private:
+    int       _fd              = -1;
+    PZInteger _maxDatagramSize = 0;
+
+    struct Batch {
+        std::vector<std::uint8_t> buffer; //!< Room for BATCH_SIZE datagrams, one after another
+        std::vector<mmsghdr>      headers;
+        std::vector<iovec>        iovecs;
+        std::vector<sockaddr_in>  addresses;
+    };
+
+    Batch     _recvBatch;
+    PZInteger _recvCount   = 0;     //!< Number of datagrams in the current receive batch
+    PZInteger _recvNext    = 0;     //!< Index of the next datagram to hand out from the batch
+    bool      _recvDrained = false; //!< True if the OS had nothing more after the current batch
+
+    Batch     _sendBatch;
+    PZInteger _sendCount = 0; //!< Number of queued datagrams
+
+    void _open();
+    void _prepareBatch(Batch& aBatch);
+    void _dropSentDatagrams(PZInteger aSentCount);
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // __linux__
+
+#endif // !UHOBGOBLIN_RN_NATIVE_UDP_SOCKET_HPP
@@ -0,0 +1,130 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_PACKET_WINDOW_HPP
+#define UHOBGOBLIN_RN_PACKET_WINDOW_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/HGExcept.hpp>
+
+#include "Packet_ordinal.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Window of elements with consecutive packet ordinals, kept in a ring of slots: the element
+//! with ordinal N is in slot N modulo the capacity (which is a power of two). So looking an
+//! element up by its ordinal, appending one at the back and dropping one from the front are all
+//! O(1), and never move the other elements. When the window is full, its capacity is doubled.
+//!
+//! Elements are never constructed or destroyed by pushing and popping - a dropped element stays
+//! in its slot and is handed out again by `pushBack()`, so the buffers it owns (for example, the
+//! storage of a `util::Packet`) are reused instead of being allocated anew for every packet. The
+//! caller must reinitialize the elements it gets from `pushBack()`, and release anything that
+//! shouldn't be held on to before dropping them.
+//!
+//! \note references to elements are invalidated by `pushBack()` (if the capacity grows).
+template <class T>
+class PacketWindow {
+public:
+    //! \param aHeadOrdinal ordinal which the first element to be appended will have.
+    explicit PacketWindow(PacketOrdinal aHeadOrdinal = 1)
+        : _headOrdinal{aHeadOrdinal} {}
+
+    PZInteger getSize() const {
+        return stopz(_size);
+    }
+
+    bool isEmpty() const {
+        return _size == 0;
+    }
+
+    //! Returns the ordinal of the element at the front (if there is one).
+    PacketOrdinal getHeadOrdinal() const {
+        return _headOrdinal;
+    }
+
+    //! Returns the ordinal which the next element to be appended will have.
+    PacketOrdinal getEndOrdinal() const {
+        return _headOrdinal + static_cast<PacketOrdinal>(_size);
+    }
+
+    bool contains(PacketOrdinal aOrdinal) const {
+        // (Ordinals before the head wrap around to huge offsets)
+        return static_cast<PacketOrdinal>(aOrdinal - _headOrdinal) < _size;
+    }
+
+    //! Returns the element with the given ordinal, which must be in the window.
+    T& operator[](PacketOrdinal aOrdinal) {
+        HG_ASSERT(contains(aOrdinal));
+        return _slots[aOrdinal & _mask];
+    }
+
+    T& front() {
+        return (*this)[_headOrdinal];
+    }
+
+    T& back() {
+        return (*this)[getEndOrdinal() - 1];
+    }
+
+    //! Appends an element at the back, and returns it. It still holds whatever was in its slot
+    //! the last time it was used (or is default-constructed, if the slot is new).
+    T& pushBack() {
+        if (_size == _slots.size()) {
+            _grow();
+        }
+        T& result = _slots[getEndOrdinal() & _mask];
+        _size += 1;
+        return result;
+    }
+
+    //! Drops the element at the front (its slot is kept as is, for reuse).
+    void popFront() {
+        HG_ASSERT(!isEmpty());
+        _headOrdinal += 1;
+        _size -= 1;
+    }
+
+    //! Drops all elements (their slots are kept as they are, for reuse).
+    //! \param aHeadOrdinal ordinal which the next element to be appended will have.
+    void clear(PacketOrdinal aHeadOrdinal) {
+        _headOrdinal = aHeadOrdinal;
+        _size        = 0;
+    }
+
+private:
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    std::vector<T> _slots; //!< Size is always 0 or a power of 2
+    std::size_t    _mask = 0;
+    PacketOrdinal  _headOrdinal;
+    std::size_t    _size = 0;
+
+    void _grow() {
+        const std::size_t capacity = std::max(_slots.size() * 2, MIN_CAPACITY);
+
+        // (The window is full, so every old slot holds an element)
+        std::vector<T> slots(capacity);
+        for (std::size_t i = 0; i < _slots.size(); i += 1) {
+            const auto ordinal = static_cast<PacketOrdinal>(_headOrdinal + i);
+            slots[ordinal & (capacity - 1)] = std::move(_slots[ordinal & _mask]);
+        }
+
+        _slots = std::move(slots);
+        _mask  = capacity - 1;
+    }
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_RN_PACKET_WINDOW_HPP
@@ -0,0 +1,245 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include "Payload_codec.hpp"
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+namespace {
+constexpr std::size_t MIN_MATCH_LENGTH = 4;
+constexpr unsigned    HASH_BITS        = 12;
+constexpr std::size_t LENGTH_NIBBLE    = 15; //!< Nibble value meaning 'length continues'
+//! The longer no match is found, the faster the data is skipped (incompressible data would
+//! otherwise take long for nothing).
+constexpr unsigned SKIP_SHIFT = 6;
+
+std::uint32_t Read32(std::span<const std::uint8_t> aData, std::size_t aPosition) {
+    HG_ASSERT(aPosition + sizeof(std::uint32_t) <= aData.size());
+    std::uint32_t result;
+    std::memcpy(&result, aData.data() + aPosition, sizeof(result));
+    return result;
+}
+
+std::uint32_t Hash(std::uint32_t aValue) {
+    return (aValue * 2654435761u) >> (32u - HASH_BITS);
+}
+
+//! Writes the part of a length which didn't fit into its nibble.
+void WriteLengthContinuation(std::vector<std::uint8_t>& aOutput, std::size_t aLength) {
+    aLength -= LENGTH_NIBBLE;
+    while (aLength >= 255) {
+        aOutput.push_back(255);
+        aLength -= 255;
+    }
+    aOutput.push_back(static_cast<std::uint8_t>(aLength));
+}
+
+bool ReadLengthContinuation(std::span<const std::uint8_t> aData,
+                            std::size_t&                  aPosition,
+                            std::size_t&                  aLength) {
+    std::uint8_t byte;
+    do {
+        if (aPosition >= aData.size()) {
+            return false;
+        }
+        byte = aData[aPosition];
+        aPosition += 1;
+        aLength += byte;
+    } while (byte == 255);
+    return true;
+}
+} // namespace
+
+PayloadCodec::PayloadCodec(std::shared_ptr<const std::vector<std::uint8_t>> aDictionary)
+    : _dictionaryHolder{std::move(aDictionary)}
+    , _dictionaryHashTable(std::size_t{1} << HASH_BITS, 0)
+    , _hashTable(std::size_t{1} << HASH_BITS, 0) {
+    if (_dictionaryHolder == nullptr) {
+        return;
+    }
+
+    _dictionary = *_dictionaryHolder;
+    if (_dictionary.size() > pztos(MAX_OFFSET)) {
+        _dictionary = _dictionary.last(pztos(MAX_OFFSET));
+    }
+    for (std::size_t i = 0; i + MIN_MATCH_LENGTH <= _dictionary.size(); i += 1) {
+        _dictionaryHashTable[Hash(Read32(_dictionary, i))] = static_cast<std::uint32_t>(i + 1);
+    }
+}
+
+bool PayloadCodec::compress(std::span<const std::uint8_t> aData,
+                            PZInteger                     aMaxOutputByteCount,
+                            std::vector<std::uint8_t>&    aOutput) {
+    const std::size_t dictionarySize = _dictionary.size();
+    const std::size_t end            = dictionarySize + aData.size();
+    const std::size_t outputLimit    = pztos(aMaxOutputByteCount);
+
+    const auto byteAt = [&](std::size_t aPosition) -> std::uint8_t {
+        return (aPosition < dictionarySize) ? _dictionary[aPosition] : aData[aPosition - dictionarySize];
+    };
+
+    const auto writeLiterals = [&](std::size_t aFrom, std::size_t aTo, std::size_t aMatchNibble) {
+        const std::size_t literalCount = aTo - aFrom;
+        aOutput.push_back(
+            static_cast<std::uint8_t>((std::min(literalCount, LENGTH_NIBBLE) << 4) | aMatchNibble));
+        if (literalCount >= LENGTH_NIBBLE) {
+            WriteLengthContinuation(aOutput, literalCount);
+        }
+        const auto* literals = aData.data() + (aFrom - dictionarySize);
+        aOutput.insert(aOutput.end(), literals, literals + literalCount);
+    };
+
+    aOutput.clear();
+    _hashTable = _dictionaryHashTable;
+
+    // Positions are counted from the start of the dictionary
+    std::size_t anchor   = dictionarySize; // Start of the pending literals
+    std::size_t position = dictionarySize;
+    while (position + MIN_MATCH_LENGTH <= end) {
+        if (aOutput.size() >= outputLimit) {
+            return false;
+        }
+
+        const std::uint32_t value = Read32(aData, position - dictionarySize);
+        std::uint32_t&      entry = _hashTable[Hash(value)];
+
+        const std::size_t candidate = entry; // (Plus 1)
+        entry                       = static_cast<std::uint32_t>(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > pztos(MAX_OFFSET)) {
+            position += 1 + ((position - anchor) >> SKIP_SHIFT);
+            continue;
+        }
+
+        const std::size_t matchPosition = candidate - 1;
+        bool              isMatch;
+        if (matchPosition + MIN_MATCH_LENGTH <= dictionarySize) {
+            isMatch = (Read32(_dictionary, matchPosition) == value);
+        } else if (matchPosition >= dictionarySize) {
+            isMatch = (Read32(aData, matchPosition - dictionarySize) == value);
+        } else {
+            isMatch = true;
+            for (std::size_t i = 0; i < MIN_MATCH_LENGTH && isMatch; i += 1) {
+                isMatch = (byteAt(matchPosition + i) == byteAt(position + i));
+            }
+        }
+        if (!isMatch) {
+            position += 1 + ((position - anchor) >> SKIP_SHIFT);
+            continue;
+        }
+
+        std::size_t matchLength = MIN_MATCH_LENGTH;
+        while (position + matchLength < end &&
+               byteAt(matchPosition + matchLength) == byteAt(position + matchLength)) {
+            matchLength += 1;
+        }
+
+        const std::size_t matchNibble = std::min(matchLength - MIN_MATCH_LENGTH, LENGTH_NIBBLE);
+        writeLiterals(anchor, position, matchNibble);
+
+        const std::size_t offset = position - matchPosition;
+        aOutput.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+        aOutput.push_back(static_cast<std::uint8_t>(offset >> 8));
+        if (matchNibble == LENGTH_NIBBLE) {
+            WriteLengthContinuation(aOutput, matchLength - MIN_MATCH_LENGTH);
+        }
+
+        position += matchLength;
+        anchor = position;
+    }
+
+    writeLiterals(anchor, end, 0);
+
+    return aOutput.size() < outputLimit;
+}
+
+bool PayloadCodec::decompress(std::span<const std::uint8_t> aData,
+                              PZInteger                     aOriginalByteCount,
+                              std::vector<std::uint8_t>&    aOutput) const {
+    const std::size_t dictionarySize = _dictionary.size();
+    const std::size_t originalSize   = pztos(aOriginalByteCount);
+
+    aOutput.clear();
+    aOutput.reserve(originalSize);
+
+    std::size_t position = 0;
+    while (true) {
+        if (position >= aData.size()) {
+            return false;
+        }
+        const std::uint8_t token = aData[position];
+        position += 1;
+
+        std::size_t literalCount = (token >> 4);
+        if (literalCount == LENGTH_NIBBLE && !ReadLengthContinuation(aData, position, literalCount)) {
+            return false;
+        }
+        if (literalCount > aData.size() - position || literalCount > originalSize - aOutput.size()) {
+            return false;
+        }
+        aOutput.insert(aOutput.end(), aData.begin() + position, aData.begin() + position + literalCount);
+        position += literalCount;
+
+        if (position == aData.size()) {
+            break; // The last sequence holds only literals
+        }
+
+        if (aData.size() - position < 2) {
+            return false;
+        }
+        const std::size_t offset = aData[position] | (std::size_t{aData[position + 1]} << 8);
+        position += 2;
+        if (offset == 0 || offset > dictionarySize + aOutput.size()) {
+            return false;
+        }
+
+        std::size_t matchLength = (token & 0x0F);
+        if (matchLength == LENGTH_NIBBLE && !ReadLengthContinuation(aData, position, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH_LENGTH;
+        if (matchLength > originalSize - aOutput.size()) {
+            return false;
+        }
+
+        // Byte by byte, because the match can overlap the bytes it produces
+        std::size_t source = dictionarySize + aOutput.size() - offset;
+        for (std::size_t i = 0; i < matchLength; i += 1, source += 1) {
+            aOutput.push_back((source < dictionarySize) ? _dictionary[source]
+                                                        : aOutput[source - dictionarySize]);
+        }
+    }
+
+    return aOutput.size() == originalSize;
+}
+
+std::uint32_t PayloadCodec::getDictionaryId(const std::vector<std::uint8_t>* aDictionary) {
+    if (aDictionary == nullptr || aDictionary->empty()) {
+        return 0;
+    }
+
+    std::span<const std::uint8_t> dictionary = *aDictionary;
+    if (dictionary.size() > pztos(MAX_OFFSET)) {
+        dictionary = dictionary.last(pztos(MAX_OFFSET));
+    }
+
+    // FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (const std::uint8_t byte : dictionary) {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return (hash != 0) ? hash : 1;
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
@@ -0,0 +1,73 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_PAYLOAD_CODEC_HPP
+#define UHOBGOBLIN_RN_PAYLOAD_CODEC_HPP
+
+#include <Hobgoblin/Common.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Fast compression of data packets' payloads, in the style of LZ4: the data is encoded as a
+//! sequence of literal runs and back-references (offset + length) to earlier bytes, without any
+//! entropy coding, so both directions take only a few CPU cycles per byte. The optional
+//! dictionary logically precedes the data of every packet, so back-references can point into it.
+//!
+//! Format: a sequence of [token][literal length]?[literals][offset][match length]?, where the
+//! token holds the literal length in the high 4 bits and the match length (minus 4) in the low
+//! 4 bits; if a nibble is 15, the length continues in the following bytes (each of which is
+//! added to it, until one that isn't 255). The offset is 2 bytes, little-endian. The last
+//! sequence holds only literals (no offset and match length).
+class PayloadCodec {
+public:
+    //! Back-references can't reach further than this (so it's also the largest dictionary size).
+    static constexpr PZInteger MAX_OFFSET = 65535;
+
+    //! \param aDictionary optional dictionary (can be null or empty). Only its last `MAX_OFFSET`
+    //!                    bytes are used.
+    explicit PayloadCodec(std::shared_ptr<const std::vector<std::uint8_t>> aDictionary);
+
+    //! Compresses the data into `aOutput` (replacing its contents).
+    //! \returns `true` on success, or `false` if the compressed data wouldn't be smaller than
+    //!          `aMaxOutputByteCount` bytes (in which case the contents of `aOutput` are
+    //!          unspecified).
+    bool compress(std::span<const std::uint8_t> aData,
+                  PZInteger                     aMaxOutputByteCount,
+                  std::vector<std::uint8_t>&    aOutput);
+
+    //! Decompresses the data into `aOutput` (replacing its contents).
+    //! \param aOriginalByteCount size of the data before compression.
+    //! \returns `true` on success, or `false` if the data is corrupt (or was compressed with a
+    //!          different dictionary, or doesn't decompress to exactly `aOriginalByteCount` bytes).
+    bool decompress(std::span<const std::uint8_t> aData,
+                    PZInteger                     aOriginalByteCount,
+                    std::vector<std::uint8_t>&    aOutput) const;
+
+    //! Returns a checksum of the part of the dictionary which would be used, so that peers can
+    //! check that they have the same one (0 for no dictionary).
+    static std::uint32_t getDictionaryId(const std::vector<std::uint8_t>* aDictionary);
+
+private:
+    std::shared_ptr<const std::vector<std::uint8_t>> _dictionaryHolder;
+    std::span<const std::uint8_t>                    _dictionary; //!< The part which is used
+
+    //! Maps hashes of 4-byte sequences to the positions (plus 1; 0 means none) at which they
+    //! last appeared. Positions within the dictionary come first, followed by the data.
+    std::vector<std::uint32_t> _dictionaryHashTable; //!< Positions within the dictionary only
+    std::vector<std::uint32_t> _hashTable;           //!< Reused by `compress()`
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_RN_PAYLOAD_CODEC_HPP
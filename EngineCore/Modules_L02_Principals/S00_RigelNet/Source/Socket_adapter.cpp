@@ -5,6 +5,18 @@
 
 #include <Hobgoblin/HGExcept.hpp>
 
+#include <chrono>
+#include <utility>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#endif
+
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
 HOBGOBLIN_NAMESPACE_BEGIN
@@ -12,6 +24,23 @@ namespace rn {
 
 namespace {
 
+//! Maximum number of datagrams waiting in each of the I/O thread's queues.
+constexpr PZInteger IO_THREAD_QUEUE_CAPACITY = 4096;
+
+//! How long the I/O thread waits before checking the socket again when it can't block until
+//! the socket is ready: when the socket can't be polled (see _getPollableHandle()), and when
+//! the incoming queue is full. Sending always wakes it up immediately (see flush()).
+constexpr auto IO_THREAD_IDLE_WAIT = std::chrono::microseconds{500};
+
+#ifdef __linux__
+//! Gives access to the OS handle of an SFML socket (sf::Socket::getHandle() is protected).
+struct SfSocketHandleAccessor : sf::UdpSocket {
+    static sf::SocketHandle get(const sf::UdpSocket& aSocket) {
+        return (aSocket.*&SfSocketHandleAccessor::getHandle)();
+    }
+};
+#endif
+
 inline bool UseSfSocket(RN_Protocol protocol, RN_NetworkingStack networkingStack) {
     return (networkingStack == RN_NetworkingStack::Default);
 }
@@ -21,6 +50,33 @@ inline bool UseZtSocket(RN_Protocol protocol, RN_NetworkingStack networkingStack
     return (networkingStack == RN_NetworkingStack::ZeroTier);
 }
 #endif
+
+#ifdef __linux__
+inline bool UseNativeSocket(RN_Protocol protocol, RN_NetworkingStack networkingStack) {
+    return (networkingStack == RN_NetworkingStack::NativeBatched);
+}
+#endif
+
+RN_SocketAdapter::Status ConvertSfStatus(sf::Socket::Status status) {
+    switch (status) {
+    case sf::Socket::Done:
+        return RN_SocketAdapter::Status::OK;
+
+    case sf::Socket::NotReady:
+        return RN_SocketAdapter::Status::NotReady;
+
+    case sf::Socket::Partial:
+        // SFML's UDP socket can't return this status
+        HG_UNREACHABLE("Received unexpected sf::Socket::Partial status from UDP socket.");
+
+    case sf::Socket::Disconnected:
+        return RN_SocketAdapter::Status::Disconnected;
+
+    case sf::Socket::Error:
+    default:
+        HG_THROW_TRACED(TracedRuntimeError, 0, "Socket reached an unrecoverable error state.");
+    }
+}
 } // namespace
 
 RN_SocketAdapter::RN_SocketAdapter(RN_Protocol aProtocol, RN_NetworkingStack aNetworkingStack)
@@ -34,6 +90,11 @@ RN_SocketAdapter::RN_SocketAdapter(RN_Protocol aProtocol, RN_NetworkingStack aNe
     else if (UseZtSocket(_protocol, _networkingStack)) {
         _socket.emplace<zt::Socket>();
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        _socket.emplace<RN_NativeUdpSocket>();
+    }
 #endif
     else {
         HG_UNREACHABLE("Unsupported networking stack requested. "
@@ -41,6 +102,10 @@ RN_SocketAdapter::RN_SocketAdapter(RN_Protocol aProtocol, RN_NetworkingStack aNe
     }
 }
 
+RN_SocketAdapter::~RN_SocketAdapter() {
+    _stopIoThread();
+}
+
 void RN_SocketAdapter::init(PZInteger aRecvBufferSize) {
     if (UseSfSocket(_protocol, _networkingStack)) {
         auto& socket = std::get<sf::UdpSocket>(_socket);
@@ -56,11 +121,21 @@ void RN_SocketAdapter::init(PZInteger aRecvBufferSize) {
             HG_THROW_TRACED(TracedRuntimeError, res.getError().errorCode, res.getError().message);
         }
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        socket.init(aRecvBufferSize);
+        return;
+    }
 #endif
     _recvBuffer.resize(pztos(aRecvBufferSize));
 }
 
 void RN_SocketAdapter::bind(sf::IpAddress aIpAddress, std::uint16_t aLocalPort) {
+    _stopIoThread();
+    _bound = false;
+
     if (UseSfSocket(_protocol, _networkingStack)) {
         auto& socket = std::get<sf::UdpSocket>(_socket);
         if (socket.bind(aLocalPort, aIpAddress) != sf::Socket::Done) {
@@ -76,6 +151,19 @@ void RN_SocketAdapter::bind(sf::IpAddress aIpAddress, std::uint16_t aLocalPort)
         }
     }
 #endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        if (socket.bind(aLocalPort, aIpAddress) != sf::Socket::Done) {
+            HG_THROW_TRACED(TracedRuntimeError, 0, "Failed to bind port.");
+        }
+    }
+#endif
+
+    _bound = true;
+    if (_ioThreadEnabled) {
+        _startIoThread();
+    }
 }
 
 RN_SocketAdapter::Status RN_SocketAdapter::send(util::Packet&        aPacket,
@@ -84,28 +172,116 @@ RN_SocketAdapter::Status RN_SocketAdapter::send(util::Packet&        aPacket,
     if (aPacket.getDataSize() == 0u)
         return Status::OK;
 
-    if (UseSfSocket(_protocol, _networkingStack)) {
-        auto& socket = std::get<sf::UdpSocket>(_socket);
+    if (!_ioThread || !_ioThread->running.load(std::memory_order_relaxed)) {
+        return _sendNow(aPacket.getData(),
+                        pztos(aPacket.getDataSize()),
+                        aTargetAddress,
+                        aTargetPort);
+    }
+
+    _rethrowIoThreadError();
+
+    auto* datagram = _ioThread->outbound.beginPush();
+    if (datagram == nullptr) {
+        return Status::NotReady;
+    }
+    datagram->packet.clear();
+    datagram->sharedPieces.clear();
+    const auto bytesWritten = datagram->packet.write(aPacket.getData(), aPacket.getDataSize());
+    HG_ASSERT(bytesWritten == aPacket.getDataSize());
+    datagram->address = aTargetAddress;
+    datagram->port    = aTargetPort;
+    _ioThread->outbound.endPush();
+
+    return Status::OK;
+}
+
+RN_SocketAdapter::Status RN_SocketAdapter::send(std::span<const DatagramPiece> aPieces,
+                                                const sf::IpAddress&           aTargetAddress,
+                                                std::uint16_t                  aTargetPort) {
+    if (!_ioThread || !_ioThread->running.load(std::memory_order_relaxed)) {
+        return _sendNow(aPieces, aTargetAddress, aTargetPort);
+    }
+
+    _rethrowIoThreadError();
 
-        switch (
-            socket.send(aPacket.getData(), pztos(aPacket.getDataSize()), aTargetAddress, aTargetPort)) {
-        case sf::Socket::Done:
+    auto* datagram = _ioThread->outbound.beginPush();
+    if (datagram == nullptr) {
+        return Status::NotReady;
+    }
+    datagram->packet.clear();
+    datagram->sharedPieces.clear();
+    for (const auto& piece : aPieces) {
+        if (piece.sharedPayload != nullptr) {
+            // Hold on to the payload instead of copying it
+            const auto* payloadData = (*piece.sharedPayload)->data();
+            datagram->sharedPieces.push_back(
+                {*piece.sharedPayload,
+                 pztos(static_cast<const std::uint8_t*>(piece.data) - payloadData),
+                 piece.byteCount,
+                 pztos(datagram->packet.getDataSize())});
+            continue;
+        }
+        const auto bytesWritten = datagram->packet.write(piece.data, stopz(piece.byteCount));
+        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(piece.byteCount));
+    }
+    if (datagram->packet.getDataSize() == 0u && datagram->sharedPieces.empty()) {
+        return Status::OK;
+    }
+    datagram->address = aTargetAddress;
+    datagram->port    = aTargetPort;
+    _ioThread->outbound.endPush();
+
+    return Status::OK;
+}
+
+RN_SocketAdapter::Status RN_SocketAdapter::flush() {
+    if (!_ioThread || !_ioThread->running.load(std::memory_order_relaxed)) {
+        return _flushNow();
+    }
+
+    _rethrowIoThreadError();
+    _wakeUpIoThread();
+
+    return Status::OK;
+}
+
+RN_SocketAdapter::Status RN_SocketAdapter::recv(util::Packet&  aPacket,
+                                                sf::IpAddress& aRemoteAddress,
+                                                std::uint16_t& aRemotePort) {
+    if (_ioThread) {
+        if (_ioThread->running.load(std::memory_order_relaxed)) {
+            _rethrowIoThreadError();
+        }
+
+        // Even when the I/O thread isn't running anymore, what it received must come first
+        if (auto* datagram = _ioThread->inbound.front()) {
+            std::swap(aPacket, datagram->packet);
+            aRemoteAddress = datagram->address;
+            aRemotePort    = datagram->port;
+            _ioThread->inbound.pop();
             return Status::OK;
+        }
 
-        case sf::Socket::NotReady:
+        if (_ioThread->running.load(std::memory_order_relaxed)) {
             return Status::NotReady;
+        }
+    }
 
-        case sf::Socket::Partial:
-            // SFML's UDP socket can't return this status
-            HG_UNREACHABLE("Received unexpected sf::Socket::Partial status from UDP socket.");
+    return _recvNow(aPacket, aRemoteAddress, aRemotePort);
+}
 
-        case sf::Socket::Disconnected:
-            return Status::Disconnected;
+RN_SocketAdapter::Status RN_SocketAdapter::_sendNow(const void*          aData,
+                                                    std::size_t          aByteCount,
+                                                    const sf::IpAddress& aTargetAddress,
+                                                    std::uint16_t        aTargetPort) {
+    if (aByteCount == 0) {
+        return Status::OK;
+    }
 
-        case sf::Socket::Error:
-        default:
-            HG_THROW_TRACED(TracedRuntimeError, 0, "Socket reached an unrecoverable error state.");
-        }
+    if (UseSfSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<sf::UdpSocket>(_socket);
+        return ConvertSfStatus(socket.send(aData, aByteCount, aTargetAddress, aTargetPort));
     }
 #ifdef HOBGOBLIN_RN_ZEROTIER_SUPPORT
     else if (UseZtSocket(_protocol, _networkingStack)) {
@@ -125,8 +301,8 @@ RN_SocketAdapter::Status RN_SocketAdapter::send(util::Packet&        aPacket,
             return Status::NotReady;
         }
 
-        const auto res = socket.sendTo(aPacket.getData(),
-                                       aPacket.getDataSize(),
+        const auto res = socket.sendTo(aData,
+                                       aByteCount,
                                        zt::IpAddress::ipv4FromString(aTargetAddress.toString()),
                                        aTargetPort);
         if (res.hasError()) {
@@ -135,6 +311,12 @@ RN_SocketAdapter::Status RN_SocketAdapter::send(util::Packet&        aPacket,
 
         return Status::OK;
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        return ConvertSfStatus(socket.send(aData, aByteCount, aTargetAddress, aTargetPort));
+    }
 #endif
     else {
         HG_UNREACHABLE("Unsupported networking stack requested. "
@@ -142,9 +324,59 @@ RN_SocketAdapter::Status RN_SocketAdapter::send(util::Packet&        aPacket,
     }
 }
 
-RN_SocketAdapter::Status RN_SocketAdapter::recv(util::Packet&  aPacket,
-                                                sf::IpAddress& aRemoteAddress,
-                                                std::uint16_t& aRemotePort) {
+RN_SocketAdapter::Status RN_SocketAdapter::_sendNow(std::span<const DatagramPiece> aPieces,
+                                                    const sf::IpAddress&           aTargetAddress,
+                                                    std::uint16_t                  aTargetPort) {
+#ifdef __linux__
+    if (UseNativeSocket(_protocol, _networkingStack)) {
+        // The native socket copies the pieces straight into its batch buffers
+        _gatherIovecs.clear();
+        std::size_t byteCount = 0;
+        for (const auto& piece : aPieces) {
+            _gatherIovecs.push_back({const_cast<void*>(piece.data), piece.byteCount});
+            byteCount += piece.byteCount;
+        }
+        if (byteCount == 0) {
+            return Status::OK;
+        }
+
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        return ConvertSfStatus(socket.send(_gatherIovecs.data(),
+                                           _gatherIovecs.size(),
+                                           aTargetAddress,
+                                           aTargetPort));
+    }
+#endif
+
+    if (aPieces.size() == 1) {
+        // Nothing to gather
+        return _sendNow(aPieces[0].data, aPieces[0].byteCount, aTargetAddress, aTargetPort);
+    }
+
+    _gatherBuffer.clear();
+    for (const auto& piece : aPieces) {
+        const auto bytesWritten = _gatherBuffer.write(piece.data, stopz(piece.byteCount));
+        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(piece.byteCount));
+    }
+    return _sendNow(_gatherBuffer.getData(),
+                    pztos(_gatherBuffer.getDataSize()),
+                    aTargetAddress,
+                    aTargetPort);
+}
+
+RN_SocketAdapter::Status RN_SocketAdapter::_flushNow() {
+#ifdef __linux__
+    if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        return ConvertSfStatus(socket.flush());
+    }
+#endif
+    return Status::OK;
+}
+
+RN_SocketAdapter::Status RN_SocketAdapter::_recvNow(util::Packet&  aPacket,
+                                                    sf::IpAddress& aRemoteAddress,
+                                                    std::uint16_t& aRemotePort) {
     if (UseSfSocket(_protocol, _networkingStack)) {
         auto& socket = std::get<sf::UdpSocket>(_socket);
 
@@ -158,24 +390,7 @@ RN_SocketAdapter::Status RN_SocketAdapter::recv(util::Packet&  aPacket,
             aPacket.write(_recvBuffer.data(), static_cast<std::int64_t>(receivedByteCount));
         HG_ASSERT(bytesWritten == static_cast<std::int64_t>(receivedByteCount));
 
-        switch (status) {
-        case sf::Socket::Done:
-            return Status::OK;
-
-        case sf::Socket::NotReady:
-            return Status::NotReady;
-
-        case sf::Socket::Partial:
-            // SFML's UDP socket can't return this status
-            HG_UNREACHABLE("Received unexpected sf::Socket::Partial status from UDP socket.");
-
-        case sf::Socket::Disconnected:
-            return Status::Disconnected;
-
-        case sf::Socket::Error:
-        default:
-            HG_THROW_TRACED(TracedRuntimeError, 0, "Socket reached an unrecoverable error state.");
-        }
+        return ConvertSfStatus(status);
     }
 #ifdef HOBGOBLIN_RN_ZEROTIER_SUPPORT
     else if (UseZtSocket(_protocol, _networkingStack)) {
@@ -211,6 +426,12 @@ RN_SocketAdapter::Status RN_SocketAdapter::recv(util::Packet&  aPacket,
 
         return Status::OK;
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        return ConvertSfStatus(socket.receive(aPacket, aRemoteAddress, aRemotePort));
+    }
 #endif
     else {
         HG_UNREACHABLE("Unsupported networking stack requested. "
@@ -221,6 +442,9 @@ RN_SocketAdapter::Status RN_SocketAdapter::recv(util::Packet&  aPacket,
 void RN_SocketAdapter::close() {
     // Note: This method swallows all errors as we don't expect to use the socket afterwards
 
+    _stopIoThread();
+    _bound = false;
+
     if (UseSfSocket(_protocol, _networkingStack)) {
         auto& socket = std::get<sf::UdpSocket>(_socket);
         socket.unbind();
@@ -230,6 +454,13 @@ void RN_SocketAdapter::close() {
         auto& socket = std::get<zt::Socket>(_socket);
         socket.close();
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        // Also sends out any queued packets
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        socket.unbind();
+    }
 #endif
     else {
         HG_UNREACHABLE("Unsupported networking stack requested. "
@@ -247,6 +478,12 @@ std::uint16_t RN_SocketAdapter::getLocalPort() const {
         auto& socket = std::get<zt::Socket>(_socket);
         return socket.getLocalPort();
     }
+#endif
+#ifdef __linux__
+    else if (UseNativeSocket(_protocol, _networkingStack)) {
+        auto& socket = std::get<RN_NativeUdpSocket>(_socket);
+        return socket.getLocalPort();
+    }
 #endif
     else {
         HG_UNREACHABLE("Unsupported networking stack requested. "
@@ -262,6 +499,242 @@ RN_NetworkingStack RN_SocketAdapter::getNetworkingStack() const noexcept {
     return _networkingStack;
 }
 
+void RN_SocketAdapter::setIoThreadEnabled(bool aEnabled) {
+    _ioThreadEnabled = aEnabled;
+    if (_ioThreadEnabled && _bound) {
+        _startIoThread();
+    } else if (!_ioThreadEnabled) {
+        _stopIoThread();
+    }
+}
+
+bool RN_SocketAdapter::isIoThreadEnabled() const noexcept {
+    return _ioThreadEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// I/O THREAD                                                            //
+///////////////////////////////////////////////////////////////////////////
+
+RN_SocketAdapter::IoThread::IoThread()
+    : inbound{IO_THREAD_QUEUE_CAPACITY}
+    , outbound{IO_THREAD_QUEUE_CAPACITY} {
+#ifdef __linux__
+    wakeUpFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeUpFd < 0) {
+        HG_THROW_TRACED(TracedRuntimeError, errno, "Failed to create eventfd for the I/O thread.");
+    }
+#endif
+}
+
+#ifdef __linux__
+RN_SocketAdapter::IoThread::~IoThread() {
+    ::close(wakeUpFd);
+}
+#endif
+
+void RN_SocketAdapter::_startIoThread() {
+    if (_ioThread && _ioThread->running.load()) {
+        return;
+    }
+    if (!_ioThread) {
+        _ioThread = std::make_unique<IoThread>();
+    }
+
+    _ioThread->stopRequested.store(false);
+    _ioThread->failed.store(false);
+    _ioThread->exception = nullptr;
+    _ioThread->running.store(true);
+    _ioThread->thread = std::thread{&RN_SocketAdapter::_ioThreadBody, this};
+}
+
+void RN_SocketAdapter::_stopIoThread() {
+    if (!_ioThread || !_ioThread->running.load()) {
+        return;
+    }
+
+    _ioThread->stopRequested.store(true);
+    _wakeUpIoThread();
+    _ioThread->thread.join();
+    _ioThread->running.store(false);
+}
+
+void RN_SocketAdapter::_rethrowIoThreadError() {
+    if (!_ioThread->failed.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    auto exception = _ioThread->exception;
+    _stopIoThread();
+    _ioThreadEnabled = false;
+    std::rethrow_exception(exception);
+}
+
+void RN_SocketAdapter::_wakeUpIoThread() {
+#ifdef __linux__
+    const std::uint64_t increment = 1;
+    (void)::write(_ioThread->wakeUpFd, &increment, sizeof(increment));
+#else
+    {
+        std::lock_guard<std::mutex> lock{_ioThread->mutex};
+        _ioThread->wakeUpRequested = true;
+    }
+    _ioThread->cv.notify_one();
+#endif
+}
+
+void RN_SocketAdapter::_waitForIoThreadWork(bool aWaitToSend, bool aWaitToReceive) {
+    auto& io = *_ioThread;
+
+#ifdef __linux__
+    const int socketHandle = _getPollableHandle();
+
+    pollfd fds[2];
+    fds[0] = {io.wakeUpFd, POLLIN, 0};
+    fds[1] = {socketHandle, 0, 0};
+    if (aWaitToSend) {
+        fds[1].events |= POLLOUT;
+    }
+    if (aWaitToReceive) {
+        fds[1].events |= POLLIN;
+    }
+    const nfds_t fdCount = (socketHandle >= 0 && fds[1].events != 0) ? 2 : 1;
+
+    // Block until the socket is ready, unless there's something which can't be waited on
+    const bool      blockIndefinitely = (socketHandle >= 0 && aWaitToReceive);
+    const timespec  timeout{0, static_cast<long>(std::chrono::nanoseconds{IO_THREAD_IDLE_WAIT}.count())};
+    const timespec* timeoutPtr = blockIndefinitely ? nullptr : &timeout;
+
+    if (::ppoll(fds, fdCount, timeoutPtr, nullptr) < 0) {
+        if (errno == EINTR) {
+            return;
+        }
+        HG_THROW_TRACED(TracedRuntimeError, errno, "Polling the socket failed on the I/O thread.");
+    }
+
+    if ((fds[0].revents & POLLIN) != 0) {
+        std::uint64_t counter;
+        (void)::read(io.wakeUpFd, &counter, sizeof(counter));
+    }
+#else
+    (void)aWaitToSend;
+    (void)aWaitToReceive;
+
+    std::unique_lock<std::mutex> lock{io.mutex};
+    io.cv.wait_for(lock, IO_THREAD_IDLE_WAIT, [&]() {
+        return io.wakeUpRequested || io.stopRequested.load();
+    });
+    io.wakeUpRequested = false;
+#endif
+}
+
+int RN_SocketAdapter::_getPollableHandle() const {
+#ifdef __linux__
+    if (UseSfSocket(_protocol, _networkingStack)) {
+        return SfSocketHandleAccessor::get(std::get<sf::UdpSocket>(_socket));
+    }
+    if (UseNativeSocket(_protocol, _networkingStack)) {
+        return std::get<RN_NativeUdpSocket>(_socket).getNativeHandle();
+    }
+#endif
+    return -1;
+}
+
+std::span<const RN_SocketAdapter::DatagramPiece> RN_SocketAdapter::_reassembleDatagram(
+    const Datagram& aDatagram) {
+    auto&       pieces = _ioThread->pieces;
+    const auto* bytes  = static_cast<const std::uint8_t*>(aDatagram.packet.getData());
+
+    pieces.clear();
+    std::size_t position = 0;
+    for (const auto& sharedPiece : aDatagram.sharedPieces) {
+        if (sharedPiece.position > position) {
+            pieces.push_back({bytes + position, sharedPiece.position - position});
+            position = sharedPiece.position;
+        }
+        pieces.push_back({sharedPiece.payload->data() + sharedPiece.offset, sharedPiece.byteCount});
+    }
+    if (position < pztos(aDatagram.packet.getDataSize())) {
+        pieces.push_back({bytes + position, pztos(aDatagram.packet.getDataSize()) - position});
+    }
+
+    return pieces;
+}
+
+void RN_SocketAdapter::_ioThreadBody() {
+    auto& io = *_ioThread;
+
+    bool sendBlocked = false; // Outgoing datagrams wait for room in the socket's send buffer
+    bool inboundFull = false; // No room for incoming datagrams until the owner takes some
+
+    const auto sendQueued = [&]() -> bool {
+        bool didWork = false;
+        sendBlocked  = false;
+        while (auto* datagram = io.outbound.front()) {
+            const auto status =
+                datagram->sharedPieces.empty()
+                    ? _sendNow(datagram->packet.getData(),
+                               pztos(datagram->packet.getDataSize()),
+                               datagram->address,
+                               datagram->port)
+                    : _sendNow(_reassembleDatagram(*datagram), datagram->address, datagram->port);
+            if (status == Status::NotReady) {
+                sendBlocked = true;
+                break; // Try again once the socket is writable
+            }
+            // Don't keep the payloads alive until the slot is reused
+            datagram->sharedPieces.clear();
+            io.outbound.pop();
+            didWork = true;
+        }
+        if (_flushNow() == Status::NotReady) {
+            sendBlocked = true; // The rest of the batch goes out once the socket is writable
+        }
+        return didWork;
+    };
+
+    const auto receiveAvailable = [&]() -> bool {
+        bool didWork = false;
+        while (true) {
+            auto* datagram = io.inbound.beginPush();
+            inboundFull    = (datagram == nullptr);
+            if (inboundFull) {
+                break;
+            }
+
+            datagram->packet.clear();
+            const auto status = _recvNow(datagram->packet, datagram->address, datagram->port);
+            if (status == Status::NotReady) {
+                break;
+            }
+            if (status == Status::OK) {
+                io.inbound.endPush();
+            }
+            // Status::Disconnected is ignored for UDP sockets (same as when not using the I/O thread)
+            didWork = true;
+        }
+        return didWork;
+    };
+
+    try {
+        while (!io.stopRequested.load()) {
+            const bool sent     = sendQueued();
+            const bool received = receiveAvailable();
+            if (sent || received) {
+                continue;
+            }
+
+            _waitForIoThreadWork(sendBlocked, !inboundFull);
+        }
+
+        // Don't leave anything unsent
+        (void)sendQueued();
+    } catch (...) {
+        io.exception = std::current_exception();
+        io.failed.store(true, std::memory_order_release);
+    }
+}
+
 } // namespace rn
 HOBGOBLIN_NAMESPACE_END
 
@@ -11,12 +11,22 @@
 #include <Hobgoblin/Utility/Packet.hpp>
 #include <SFML/Network.hpp>
 
+#include "Native_udp_socket.hpp"
+#include "Spsc_queue.hpp"
+
 #ifdef HOBGOBLIN_RN_ZEROTIER_SUPPORT
 #include <ZTCpp.hpp>
 namespace zt = jbatnozic::ztcpp;
 #endif
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
 #include <variant>
 #include <vector>
 
@@ -25,11 +35,18 @@ namespace zt = jbatnozic::ztcpp;
 HOBGOBLIN_NAMESPACE_BEGIN
 namespace rn {
 
+//! Immutable, reference-counted block of message data which can be queued in the send buffers
+//! of several connectors at once (so that a message composed for many recipients is stored
+//! only once).
+using SharedPayload = std::shared_ptr<const std::vector<std::uint8_t>>;
+
 //! This class abstracts away different socket implementations that RigelNet can use.
 //! In all cases, RN_SocketAdapter acts as a non-blocking socket.
 //! For now, always constructs an UDP socket, regardless of specified protocol (TODO)
 //! All function calls throw only on errors from which RigelNet cannot recover. Otherwise
 //! they return an appropriate status code.
+//! Optionally, all operations on the underlying socket can be delegated to a dedicated I/O
+//! thread (see setIoThreadEnabled()); the interface and its semantics stay the same.
 class RN_SocketAdapter {
 public:
     enum class Status {
@@ -42,6 +59,9 @@ public:
     //! Throws TracedLogicError, only if an unsupported RN_NetworkingStack is requested.
     RN_SocketAdapter(RN_Protocol aProtocol, RN_NetworkingStack aNetworkingStack);
 
+    //! Stops the I/O thread (if running).
+    ~RN_SocketAdapter();
+
     //! Prepare the socket for use.
     //! Throws TracedRuntimeError on failure (realistically should not happen).
     void init(PZInteger aRecvBufferSize);
@@ -53,12 +73,38 @@ public:
     //! Attempt to send a packet.
     //! Returns true on success.
     //! Throws TracedRuntimeError or TracedLogicError on unrecoverable error.
+    //! Note: with the NativeBatched networking stack, the packet is only queued and will
+    //!       actually be sent on the next call to flush() (or once enough packets are queued).
     Status send(util::Packet& aPacket,
                 const sf::IpAddress& aTargetAddress,
                 std::uint16_t aTargetPort);
 
+    //! A contiguous piece of a datagram (see the gathering overload of send()).
+    struct DatagramPiece {
+        const void* data;
+        std::size_t byteCount;
+        //! If not null, `data` points into this payload. The I/O thread then keeps a reference
+        //! to the payload until the datagram is sent, instead of copying the piece.
+        const SharedPayload* sharedPayload = nullptr;
+    };
+
+    //! Same as the above, except that the datagram is gathered from several pieces (in the
+    //! given order) instead of being taken from a single packet. Depending on the underlying
+    //! socket, the pieces are either copied straight into the socket's own buffers, or first
+    //! assembled in a scratch buffer.
+    Status send(std::span<const DatagramPiece> aPieces,
+                const sf::IpAddress& aTargetAddress,
+                std::uint16_t aTargetPort);
+
+    //! Send all packets queued by send() that weren't sent yet. Nodes call this at the end
+    //! of each update. Does nothing for networking stacks which don't queue packets.
+    //! Throws TracedRuntimeError or TracedLogicError on unrecoverable error.
+    Status flush();
+
     //! Receive data if available.
     //! Returns Status::OK if any data was received.
+    //! Note: with the NativeBatched networking stack, datagrams are received from the OS in
+    //!       batches and then handed out one by one.
     //! Throws TracedRuntimeError or TracedLogicError on unrecoverable error.
     Status recv(util::Packet& aPacket, 
                 sf::IpAddress& aRemoteAddress, 
@@ -79,20 +125,123 @@ public:
     //! Returns the protocol the networking stack was created for.
     RN_NetworkingStack getNetworkingStack() const noexcept;
 
+    //! Enable or disable the I/O thread. While enabled (and the socket is bound), a background
+    //! thread performs all sending and receiving on the socket: it keeps receiving datagrams
+    //! into a queue from which recv() takes them, and sends the datagrams which send() puts
+    //! into another queue (flush() wakes it up to do so immediately). If the queue for outgoing
+    //! datagrams is full, send() returns Status::NotReady. On Linux, the thread sleeps in
+    //! poll() on the socket between datagrams; elsewhere (and for ZeroTier sockets, which can't
+    //! be polled by the OS) it checks the socket periodically.
+    //! Unrecoverable errors which happen on the I/O thread are rethrown from the next call to
+    //! send(), recv() or flush().
+    //! Disabling the I/O thread sends all datagrams left in the outgoing queue; datagrams left
+    //! in the incoming queue are still returned by recv() before it goes back to the socket.
+    void setIoThreadEnabled(bool aEnabled);
+
+    //! Returns whether the I/O thread is enabled (it runs only while the socket is bound).
+    bool isIoThreadEnabled() const noexcept;
+
 private:
     RN_Protocol _protocol;
     RN_NetworkingStack _networkingStack;
+    bool _bound = false;
+    bool _ioThreadEnabled = false;
 
     std::variant<
         int, // Dummy
-        sf::UdpSocket,
+        sf::UdpSocket
     #ifdef HOBGOBLIN_RN_ZEROTIER_SUPPORT
-        zt::Socket
+        , zt::Socket
+    #endif
+    #ifdef __linux__
+        , RN_NativeUdpSocket
     #endif
     > _socket;
 
-    //! Used to 'catch' data received by sockets
+    //! Used to 'catch' data received by sockets (except for RN_NativeUdpSocket, which has its
+    //! own buffers)
     std::vector<std::uint8_t> _recvBuffer;
+
+    //! Used to assemble datagrams sent in pieces, for sockets which can't gather them
+    util::Packet _gatherBuffer;
+
+#ifdef __linux__
+    std::vector<iovec> _gatherIovecs; //!< Same as above, for RN_NativeUdpSocket
+#endif
+
+    struct Datagram {
+        //! A piece of a shared payload, spliced into `packet` at `position`.
+        struct SharedPiece {
+            SharedPayload payload;
+            std::size_t offset;
+            std::size_t byteCount;
+            std::size_t position;
+        };
+
+        util::Packet packet; //!< All of the datagram except for the pieces in `sharedPieces`
+        std::vector<SharedPiece> sharedPieces;
+        sf::IpAddress address;
+        std::uint16_t port = 0;
+    };
+
+    struct IoThread {
+        IoThread();
+
+        SpscQueue<Datagram> inbound;  //!< I/O thread -> owner thread
+        SpscQueue<Datagram> outbound; //!< Owner thread -> I/O thread
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+        std::atomic<bool> stopRequested{false};
+        std::atomic<bool> failed{false};
+        std::exception_ptr exception; //!< Set by the I/O thread before it sets `failed`
+
+        std::vector<DatagramPiece> pieces; //!< Used by the I/O thread to reassemble datagrams
+
+    #ifdef __linux__
+        //! eventfd which wakes the I/O thread up while it's blocked waiting for the socket
+        int wakeUpFd = -1;
+
+        ~IoThread();
+    #else
+        std::mutex mutex; // Protects: wakeUpRequested
+        std::condition_variable cv;
+        bool wakeUpRequested = false;
+    #endif
+    };
+
+    //! Created when the I/O thread is first started, and kept afterwards (so that the queues
+    //! can be drained).
+    std::unique_ptr<IoThread> _ioThread;
+
+    void _startIoThread();
+    void _stopIoThread();
+    void _ioThreadBody();
+    void _rethrowIoThreadError();
+
+    //! Returns the pieces which make up the datagram, in order (for the I/O thread).
+    std::span<const DatagramPiece> _reassembleDatagram(const Datagram& aDatagram);
+    void _wakeUpIoThread();
+
+    //! Blocks the I/O thread until there is something for it to do (or it is woken up).
+    //! \param aWaitToSend wait for the socket to become writable (outgoing datagrams are waiting).
+    //! \param aWaitToReceive wait for the socket to become readable (there's room in the
+    //!                       incoming queue).
+    void _waitForIoThreadWork(bool aWaitToSend, bool aWaitToReceive);
+
+    //! Returns the OS handle of the socket which can be polled, or -1 if there is none.
+    int _getPollableHandle() const;
+
+    // These operate on the socket directly
+    Status _sendNow(const void*          aData,
+                    std::size_t          aByteCount,
+                    const sf::IpAddress& aTargetAddress,
+                    std::uint16_t        aTargetPort);
+    Status _sendNow(std::span<const DatagramPiece> aPieces,
+                    const sf::IpAddress&           aTargetAddress,
+                    std::uint16_t                  aTargetPort);
+    Status _recvNow(util::Packet& aPacket, sf::IpAddress& aRemoteAddress, std::uint16_t& aRemotePort);
+    Status _flushNow();
 };
 
 } // namespace rn
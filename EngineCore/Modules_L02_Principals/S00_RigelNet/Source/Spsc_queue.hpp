@@ -0,0 +1,87 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifndef UHOBGOBLIN_RN_SPSC_QUEUE_HPP
+#define UHOBGOBLIN_RN_SPSC_QUEUE_HPP
+
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/HGExcept.hpp>
+#include <Hobgoblin/Utility/No_copy_no_move.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+//! Bounded lock-free queue for exactly one producer thread and exactly one consumer thread.
+//!
+//! Elements are never constructed or destroyed by pushing and popping - the queue holds a fixed
+//! ring of slots which the producer fills in place (`beginPush()` + `endPush()`) and the
+//! consumer reads in place (`front()` + `pop()`). This way the slots (and any buffers they own)
+//! are reused, and a steady stream of elements doesn't allocate.
+template <class T>
+class SpscQueue
+    : NO_COPY
+    , NO_MOVE {
+public:
+    explicit SpscQueue(PZInteger aCapacity)
+        : _slots(pztos(aCapacity) + 1) {
+        HG_VALIDATE_ARGUMENT(aCapacity > 0);
+    }
+
+    //! Producer only: returns the slot to fill with the next element, or `nullptr` if the queue
+    //! is full. The slot still holds whatever was in it the last time it was used. The element
+    //! becomes visible to the consumer only once `endPush()` is called.
+    T* beginPush() {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (_next(tail) == _head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &_slots[tail];
+    }
+
+    //! Producer only: publishes the slot returned by the last call to `beginPush()`.
+    void endPush() {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        _tail.store(_next(tail), std::memory_order_release);
+    }
+
+    //! Consumer only: returns the oldest element in the queue, or `nullptr` if it's empty.
+    T* front() {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &_slots[head];
+    }
+
+    //! Consumer only: removes the element returned by `front()` (its slot goes back to the
+    //! producer as is).
+    void pop() {
+        const auto head = _head.load(std::memory_order_relaxed);
+        _head.store(_next(head), std::memory_order_release);
+    }
+
+private:
+    std::vector<T> _slots;
+
+    // Kept on separate cache lines so that the two threads don't keep invalidating each other's
+    alignas(64) std::atomic<std::size_t> _head{0}; //!< Written only by the consumer
+    alignas(64) std::atomic<std::size_t> _tail{0}; //!< Written only by the producer
+
+    std::size_t _next(std::size_t aIndex) const {
+        aIndex += 1;
+        return (aIndex == _slots.size()) ? 0 : aIndex;
+    }
+};
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
+
+#endif // !UHOBGOBLIN_RN_SPSC_QUEUE_HPP
@@ -0,0 +1,142 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <Hobgoblin/RigelNet/Telemetry.hpp>
+
+#include <Hobgoblin/HGExcept.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <Hobgoblin/Private/Pmacro_define.hpp>
+
+HOBGOBLIN_NAMESPACE_BEGIN
+namespace rn {
+
+namespace {
+constexpr std::chrono::microseconds FIRST_RTT_BUCKET_UPPER_BOUND{250};
+} // namespace
+
+std::chrono::microseconds RN_ConnectorTelemetry::getRttHistogramBucketUpperBound(PZInteger aBucket) {
+    HG_VALIDATE_ARGUMENT(aBucket >= 0 && aBucket < RTT_HISTOGRAM_BUCKET_COUNT);
+
+    if (aBucket == RTT_HISTOGRAM_BUCKET_COUNT - 1) {
+        return std::chrono::microseconds::max();
+    }
+    return FIRST_RTT_BUCKET_UPPER_BOUND * (std::int64_t{1} << aBucket);
+}
+
+void RN_ConnectorTelemetry::addRttSample(std::chrono::microseconds aRtt) {
+    if (rttSampleCount == 0) {
+        rttMin = aRtt;
+        rttMax = aRtt;
+    } else {
+        rttMin = std::min(rttMin, aRtt);
+        rttMax = std::max(rttMax, aRtt);
+    }
+    rttSampleCount += 1;
+    rttSum += aRtt;
+    rttSquaredSum += static_cast<double>(aRtt.count()) * static_cast<double>(aRtt.count());
+
+    PZInteger bucket = 0;
+    while (aRtt >= getRttHistogramBucketUpperBound(bucket)) {
+        bucket += 1;
+    }
+    rttHistogram[pztos(bucket)] += 1;
+}
+
+std::chrono::microseconds RN_ConnectorTelemetry::getRttMean() const {
+    if (rttSampleCount == 0) {
+        return std::chrono::microseconds{0};
+    }
+    return rttSum / rttSampleCount;
+}
+
+double RN_ConnectorTelemetry::getRttVariance() const {
+    if (rttSampleCount == 0) {
+        return 0.0;
+    }
+    const double count = static_cast<double>(rttSampleCount);
+    const double mean  = static_cast<double>(rttSum.count()) / count;
+    // (Rounding errors could make it slightly negative)
+    return std::max(rttSquaredSum / count - mean * mean, 0.0);
+}
+
+std::chrono::microseconds RN_ConnectorTelemetry::getRttPercentile(double aPercentage) const {
+    HG_VALIDATE_ARGUMENT(aPercentage > 0.0 && aPercentage <= 100.0);
+
+    if (rttSampleCount == 0) {
+        return std::chrono::microseconds{0};
+    }
+
+    // Rank of the sample at the percentile (counting from 1)
+    const double rank = std::ceil(static_cast<double>(rttSampleCount) * aPercentage / 100.0);
+
+    double    countBelow = 0.0;
+    PZInteger bucket     = 0;
+    while (countBelow + static_cast<double>(rttHistogram[pztos(bucket)]) < rank) {
+        countBelow += static_cast<double>(rttHistogram[pztos(bucket)]);
+        bucket += 1;
+    }
+
+    // The bounds of the bucket are narrowed down to the times which were actually measured
+    const auto lowerBound = std::max((bucket == 0) ? std::chrono::microseconds{0}
+                                                   : getRttHistogramBucketUpperBound(bucket - 1),
+                                     rttMin);
+    const auto upperBound = std::min(getRttHistogramBucketUpperBound(bucket), rttMax);
+
+    const double fraction = (rank - countBelow) / static_cast<double>(rttHistogram[pztos(bucket)]);
+    const double result   = static_cast<double>(lowerBound.count()) +
+                          fraction * static_cast<double>((upperBound - lowerBound).count());
+    return std::chrono::microseconds{static_cast<std::int64_t>(std::llround(result))};
+}
+
+RN_ConnectorTelemetry operator+(const RN_ConnectorTelemetry& aLhs, const RN_ConnectorTelemetry& aRhs) {
+    RN_ConnectorTelemetry result;
+
+    result.windowDuration = std::max(aLhs.windowDuration, aRhs.windowDuration);
+
+    result.rttSampleCount = aLhs.rttSampleCount + aRhs.rttSampleCount;
+    result.rttSum         = aLhs.rttSum + aRhs.rttSum;
+    result.rttSquaredSum  = aLhs.rttSquaredSum + aRhs.rttSquaredSum;
+    if (aLhs.rttSampleCount == 0) {
+        result.rttMin = aRhs.rttMin;
+        result.rttMax = aRhs.rttMax;
+    } else if (aRhs.rttSampleCount == 0) {
+        result.rttMin = aLhs.rttMin;
+        result.rttMax = aLhs.rttMax;
+    } else {
+        result.rttMin = std::min(aLhs.rttMin, aRhs.rttMin);
+        result.rttMax = std::max(aLhs.rttMax, aRhs.rttMax);
+    }
+    for (std::size_t i = 0; i < result.rttHistogram.size(); i += 1) {
+        result.rttHistogram[i] = aLhs.rttHistogram[i] + aRhs.rttHistogram[i];
+    }
+
+    result.sentPacketCount          = aLhs.sentPacketCount + aRhs.sentPacketCount;
+    result.receivedPacketCount      = aLhs.receivedPacketCount + aRhs.receivedPacketCount;
+    result.retransmittedPacketCount = aLhs.retransmittedPacketCount + aRhs.retransmittedPacketCount;
+    result.duplicatePacketCount     = aLhs.duplicatePacketCount + aRhs.duplicatePacketCount;
+    result.reassembledPacketCount   = aLhs.reassembledPacketCount + aRhs.reassembledPacketCount;
+    result.reassembledFragmentCount = aLhs.reassembledFragmentCount + aRhs.reassembledFragmentCount;
+
+    result.uploadByteCount   = aLhs.uploadByteCount + aRhs.uploadByteCount;
+    result.downloadByteCount = aLhs.downloadByteCount + aRhs.downloadByteCount;
+    result.ackByteCount      = aLhs.ackByteCount + aRhs.ackByteCount;
+    result.payloadByteCount  = aLhs.payloadByteCount + aRhs.payloadByteCount;
+
+    result.sendBufferLength    = aLhs.sendBufferLength + aRhs.sendBufferLength;
+    result.recvBufferLength    = aLhs.recvBufferLength + aRhs.recvBufferLength;
+    result.maxSendBufferLength = std::max(aLhs.maxSendBufferLength, aRhs.maxSendBufferLength);
+    result.maxRecvBufferLength = std::max(aLhs.maxRecvBufferLength, aRhs.maxRecvBufferLength);
+
+    result.sendProcessingTime    = aLhs.sendProcessingTime + aRhs.sendProcessingTime;
+    result.receiveProcessingTime = aLhs.receiveProcessingTime + aRhs.receiveProcessingTime;
+
+    return result;
+}
+
+} // namespace rn
+HOBGOBLIN_NAMESPACE_END
+
+#include <Hobgoblin/Private/Pmacro_undef.hpp>
@@ -26,6 +26,9 @@ RN_UdpClientImpl::RN_UdpClientImpl(std::string        aPassphrase,
                  _timeoutLimit,
                  _passphrase,
                  _retransmitPredicate,
+                 _localFeatures,
+                 _congestionControl,
+                 _compression,
                  rn_detail::EventFactory{_eventListeners},
                  _maxPacketSize}
     , _passphrase{std::move(aPassphrase)}
@@ -96,6 +99,49 @@ RN_Telemetry RN_UdpClientImpl::update(RN_UpdateMode mode) {
     }
 }
 
+void RN_UdpClientImpl::setIoThreadEnabled(bool aEnabled) {
+    _socket.setIoThreadEnabled(aEnabled);
+}
+
+bool RN_UdpClientImpl::isIoThreadEnabled() const noexcept {
+    return _socket.isIoThreadEnabled();
+}
+
+void RN_UdpClientImpl::setCompactAcksEnabled(bool aEnabled) {
+    if (aEnabled) {
+        _localFeatures |= UDP_FEATURE_COMPACT_ACKS;
+    } else {
+        _localFeatures &= ~UDP_FEATURE_COMPACT_ACKS;
+    }
+}
+
+bool RN_UdpClientImpl::isCompactAcksEnabled() const noexcept {
+    return (_localFeatures & UDP_FEATURE_COMPACT_ACKS) != 0;
+}
+
+void RN_UdpClientImpl::setCongestionControl(RN_CongestionControl aCongestionControl) {
+    _congestionControl = aCongestionControl;
+}
+
+RN_CongestionControl RN_UdpClientImpl::getCongestionControl() const noexcept {
+    return _congestionControl;
+}
+
+void RN_UdpClientImpl::setCompression(const RN_CompressionSettings& aCompression) {
+    HG_VALIDATE_ARGUMENT(aCompression.minPayloadByteCount > stopz(sizeof(std::uint32_t)),
+                         "Minimal size of compressed payloads must be larger than 4 bytes.");
+    _compression = aCompression;
+    if (aCompression.enabled) {
+        _localFeatures |= UDP_FEATURE_COMPRESSION;
+    } else {
+        _localFeatures &= ~UDP_FEATURE_COMPRESSION;
+    }
+}
+
+const RN_CompressionSettings& RN_UdpClientImpl::getCompression() const noexcept {
+    return _compression;
+}
+
 void RN_UdpClientImpl::addEventListener(NeverNull<RN_EventListener*> aEventListener) {
     _addEventListener(aEventListener);
 }
@@ -200,29 +246,41 @@ RN_Telemetry RN_UdpClientImpl::_updateReceive() {
         _connector.checkForTimeout();
     }
 
+    if (!_connector.isConnectedLocally()) {
+        _socket.flush(); // Send out the weak acks
+    }
+
     return telemetry;
 }
 
 RN_Telemetry RN_UdpClientImpl::_updateSend() {
-    return _connector.sendData();
+    const auto telemetry = _connector.sendData();
+    if (!_connector.isConnectedLocally()) {
+        _socket.flush();
+    }
+    return telemetry;
 }
 
-void RN_UdpClientImpl::_compose(int receiver, const void* data, std::size_t sizeInBytes) {
+void RN_UdpClientImpl::_compose(int               receiver,
+                                RN_ComposeOptions options,
+                                const void*       data,
+                                std::size_t       sizeInBytes) {
     if (_connector.getStatus() != RN_ConnectorStatus::Connected) {
         HG_THROW_TRACED(TracedLogicError,
                         0,
                         "Cannot compose messages to clients that are not connected.");
     }
-    _connector.appendDataForSending(data, sizeInBytes);
+    _connector.appendDataForSending(data, sizeInBytes, options);
 }
 
 void RN_UdpClientImpl::_compose(RN_ComposeForAllType receiver,
+                                RN_ComposeOptions    options,
                                 const void*          data,
                                 std::size_t          sizeInBytes) {
     if (_connector.getStatus() != RN_ConnectorStatus::Connected) {
         return;
     }
-    _connector.appendDataForSending(data, sizeInBytes);
+    _connector.appendDataForSending(data, sizeInBytes, options);
 }
 
 util::Packet* RN_UdpClientImpl::_getCurrentPacket() {
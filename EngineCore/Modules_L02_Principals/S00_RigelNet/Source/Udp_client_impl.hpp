@@ -51,6 +51,22 @@ public:
 
     RN_Telemetry update(RN_UpdateMode mode) override;
 
+    void setIoThreadEnabled(bool aEnabled) override;
+
+    bool isIoThreadEnabled() const noexcept override;
+
+    void setCompactAcksEnabled(bool aEnabled) override;
+
+    bool isCompactAcksEnabled() const noexcept override;
+
+    void setCongestionControl(RN_CongestionControl aCongestionControl) override;
+
+    RN_CongestionControl getCongestionControl() const noexcept override;
+
+    void setCompression(const RN_CompressionSettings& aCompression) override;
+
+    const RN_CompressionSettings& getCompression() const noexcept override;
+
     void addEventListener(NeverNull<RN_EventListener*> aEventListener) override;
 
     void removeEventListener(NeverNull<RN_EventListener*> aEventListener) override;
@@ -88,6 +104,9 @@ private:
     std::string _passphrase;
     std::chrono::microseconds _timeoutLimit = std::chrono::microseconds{0};
     RN_RetransmitPredicate _retransmitPredicate;
+    std::uint32_t _localFeatures = UDP_FEATURES_DEFAULT; //!< See RN_UdpConnectorImpl
+    RN_CongestionControl _congestionControl = RN_CongestionControl::None;
+    RN_CompressionSettings _compression;
     bool _running = false;
 
     util::Packet* _currentPacket = nullptr;
@@ -95,8 +114,14 @@ private:
     RN_Telemetry _updateReceive();
     RN_Telemetry _updateSend();
 
-    void _compose(int receiver, const void* data, std::size_t sizeInBytes) override;
-    void _compose(RN_ComposeForAllType receiver, const void* data, std::size_t sizeInBytes) override;
+    void _compose(int               receiver,
+                  RN_ComposeOptions options,
+                  const void*       data,
+                  std::size_t       sizeInBytes) override;
+    void _compose(RN_ComposeForAllType receiver,
+                  RN_ComposeOptions    options,
+                  const void*          data,
+                  std::size_t          sizeInBytes) override;
     util::Packet* _getCurrentPacket() override;
     void _setUserData(util::AnyPtr userData) override;
     util::AnyPtr _getUserData() const override;
@@ -3,6 +3,7 @@
 
 #include "Udp_connector_impl.hpp"
 #include "Invalid_data_error.hpp"
+#include "Payload_codec.hpp"
 #include "Udp_connector_packet_kinds.hpp"
 #include "Udp_server_impl.hpp"
 
@@ -10,11 +11,13 @@
 #include <Hobgoblin/Format.hpp>
 #include <Hobgoblin/HGExcept.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstring>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <utility>
 
@@ -130,16 +133,22 @@ RN_UdpConnectorImpl::RN_UdpConnectorImpl(RN_SocketAdapter&                aSocke
                                          const std::chrono::microseconds& aTimeoutLimit,
                                          const std::string&               aPassphrase,
                                          const RN_RetransmitPredicate&    aRetransmitPredicate,
+                                         const std::uint32_t&             aLocalFeatures,
+                                         const RN_CongestionControl&      aCongestionControl,
+                                         const RN_CompressionSettings&    aCompression,
                                          rn_detail::EventFactory          aEventFactory,
                                          PZInteger                        aMaxPacketSize)
     : _socket{aSocket}
     , _timeoutLimit{aTimeoutLimit}
     , _passphrase{aPassphrase}
     , _retransmitPredicate{aRetransmitPredicate}
+    , _localFeatures{aLocalFeatures}
+    , _congestionControl{aCongestionControl}
+    , _compression{aCompression}
     , _eventFactory{aEventFactory}
     , _maxPacketSize{aMaxPacketSize}
     , _status{RN_ConnectorStatus::Disconnected}
-    , _sendBuffer{_maxPacketSize, _retransmitPredicate}
+    , _sendBuffer{_maxPacketSize, _retransmitPredicate, _congestionControl}
     , _recvBuffer{} {}
 
 // MARK: Accepting
@@ -159,10 +168,29 @@ bool RN_UdpConnectorImpl::tryAccept(sf::IpAddress addr, std::uint16_t port, util
     }
 
     if (packetKind == UDP_PACKET_KIND_HELLO && receivedPassphrase == _passphrase) {
+        // Older clients don't send the list of features they support
+        std::uint32_t remoteFeatures = 0;
+        if (!packet.endOfPacket()) {
+            remoteFeatures = packet.extractNoThrow<std::uint32_t>();
+            if (!packet) {
+                remoteFeatures = 0;
+            }
+        }
+
+        // Compressed data can be decompressed only with the same dictionary
+        if ((remoteFeatures & UDP_FEATURE_COMPRESSION) != 0) {
+            const auto remoteDictionaryId = packet.extractNoThrow<std::uint32_t>();
+            if (!packet ||
+                remoteDictionaryId != PayloadCodec::getDictionaryId(_compression.dictionary.get())) {
+                remoteFeatures &= ~UDP_FEATURE_COMPRESSION;
+            }
+        }
+
         _remoteInfo = RN_RemoteInfo{addr, port};
         _status     = RN_ConnectorStatus::Accepting;
 
         _resetBuffers();
+        _applyFeatures(remoteFeatures & _localFeatures);
     } else {
         HG_LOG_WARN(LOG_ID,
                     "Connection attempt from {}:{} refused because packet kind and/or passphrase "
@@ -231,6 +259,7 @@ void RN_UdpConnectorImpl::connectLocal(RN_ServerInterface& server) {
     _status     = RN_ConnectorStatus::Connected;
 
     _resetBuffers();
+    resetTelemetry();
 
     _clientIndex = clientIndex;
     _eventFactory.createConnected();
@@ -246,6 +275,10 @@ void RN_UdpConnectorImpl::prepToReceive() {
 void RN_UdpConnectorImpl::receivedPacket(util::Packet& packet) {
     assert(_status != RN_ConnectorStatus::Disconnected);
 
+    util::Stopwatch stopwatch;
+    // (The packet can be moved into the receive buffer while it's being processed)
+    const auto downloadByteCount = stopz(packet.getDataSize() + UDP_HEADER_BYTE_COUNT);
+
     std::optional<TracedException> exception;
     try {
         const auto packetKind = packet.extract<std::uint32_t>();
@@ -275,10 +308,23 @@ void RN_UdpConnectorImpl::receivedPacket(util::Packet& packet) {
             _processDataTailPacket(packet);
             break;
 
+        case UDP_PACKET_KIND_DATA_UNORDERED:
+            _processDataUnorderedPacket(packet);
+            break;
+
+        case UDP_PACKET_KIND_UNRELIABLE:
+        case UDP_PACKET_KIND_UNRELIABLE_SEQUENCED:
+            _processUnreliablePacket(packet, packetKind);
+            break;
+
         case UDP_PACKET_KIND_ACKS:
             _processAcksPacket(packet);
             break;
 
+        case UDP_PACKET_KIND_ACKS_BITMAPS:
+            _processAcksBitmapsPacket(packet);
+            break;
+
         default:
             HG_THROW_TRACED(InvalidDataError, 0, "Received packet of unknown kind ({}).", packetKind);
             break;
@@ -306,6 +352,13 @@ void RN_UdpConnectorImpl::receivedPacket(util::Packet& packet) {
             _eventFactory.createConnectAttemptFailed(RN_Event::ConnectAttemptFailed::Reason::Error);
         }
     }
+
+    // (Counted only now, as the telemetry is reset if the packet establishes the connection)
+    if (!_isConnectedLocally()) {
+        _telemetry.receivedPacketCount += 1;
+        _telemetry.downloadByteCount += downloadByteCount;
+    }
+    _telemetry.receiveProcessingTime += stopwatch.getElapsedTime<std::chrono::microseconds>();
 }
 
 void RN_UdpConnectorImpl::receivingFinished() {
@@ -319,15 +372,22 @@ void RN_UdpConnectorImpl::receivingFinished() {
 RN_Telemetry RN_UdpConnectorImpl::sendWeakAcks() {
     assert(_status == RN_ConnectorStatus::Connected);
 
+    util::Stopwatch stopwatch;
+
     RN_Telemetry telemetry;
     telemetry.uploadByteCount += _sendBuffer.sendWeakAcks([this](util::Packet& aPacket) {
         _socket.send(aPacket, _remoteInfo.ipAddress, _remoteInfo.port);
     });
     if (telemetry.uploadByteCount > 0) {
         telemetry.uploadByteCount += UDP_HEADER_BYTE_COUNT;
+
+        _telemetry.sentPacketCount += 1;
+        _telemetry.uploadByteCount += telemetry.uploadByteCount;
+        _telemetry.ackByteCount += telemetry.uploadByteCount;
     }
     // TODO: should sendWeakAcks care about a packet limiter?
 
+    _telemetry.sendProcessingTime += stopwatch.getElapsedTime<std::chrono::microseconds>();
     return telemetry;
 }
 
@@ -361,6 +421,12 @@ void RN_UdpConnectorImpl::handleDataMessages(RN_NodeInterface&         aNode,
         _eventFactory.createDisconnected(RN_Event::Disconnected::Reason::Error, ex.what());
     }
 
+    const auto counters = _recvBuffer.takeCounters();
+    _telemetry.duplicatePacketCount += counters.duplicatePacketCount;
+    _telemetry.reassembledPacketCount += counters.reassembledPacketCount;
+    _telemetry.reassembledFragmentCount += counters.reassembledFragmentCount;
+    _telemetry.maxRecvBufferLength = std::max(_telemetry.maxRecvBufferLength, _recvBuffer.getLength());
+
     if (_isConnectedLocally()) {
         switch (_localSharedState->getStatus()) {
         case LocalConnectionSharedState::STATUS_ACTIVE:
@@ -402,20 +468,57 @@ void RN_UdpConnectorImpl::checkForTimeout() {
 
 // MARK: Sending
 
-void RN_UdpConnectorImpl::appendDataForSending(NeverNull<const void*> aData, PZInteger aDataByteCount) {
-    _sendBuffer.appendDataForSending(aData, aDataByteCount);
+void RN_UdpConnectorImpl::appendDataForSending(NeverNull<const void*> aData,
+                                               PZInteger              aDataByteCount,
+                                               RN_ComposeOptions      aOptions) {
+    HG_VALIDATE_ARGUMENT(aOptions.stream >= 0 && aOptions.stream < RN_STREAM_COUNT,
+                         "Stream index must be in the range [0, RN_STREAM_COUNT).");
+
+    // Older remotes only understand regular DATA packets
+    auto mode = aOptions.deliveryMode;
+    if ((_features & UDP_FEATURE_DELIVERY_MODES) == 0) {
+        mode = RN_DeliveryMode::ReliableOrdered;
+    }
+
+    switch (mode) {
+    case RN_DeliveryMode::ReliableOrdered:
+        _sendBuffer.appendDataForSending(aData, aDataByteCount, aOptions.stream);
+        break;
+
+    case RN_DeliveryMode::ReliableUnordered:
+        _sendBuffer.appendUnorderedDataForSending(aData, aDataByteCount);
+        break;
+
+    case RN_DeliveryMode::Unreliable:
+        _sendBuffer.appendUnreliableDataForSending(aData, aDataByteCount, false);
+        break;
+
+    case RN_DeliveryMode::UnreliableSequenced:
+        _sendBuffer.appendUnreliableDataForSending(aData, aDataByteCount, true);
+        break;
+
+    default:
+        HG_UNREACHABLE("Invalid value for RN_DeliveryMode ({}).", (int)mode);
+    }
+}
+
+void RN_UdpConnectorImpl::appendSharedDataForSending(const SharedPayload& aPayload, PZInteger aStream) {
+    HG_VALIDATE_ARGUMENT(aStream >= 0 && aStream < RN_STREAM_COUNT,
+                         "Stream index must be in the range [0, RN_STREAM_COUNT).");
+    _sendBuffer.appendSharedDataForSending(aPayload, aStream);
 }
 
 RN_Telemetry RN_UdpConnectorImpl::sendData() {
     assert(_status != RN_ConnectorStatus::Disconnected);
-    RN_Telemetry telemetry;
+    util::Stopwatch stopwatch;
+    RN_Telemetry    telemetry;
 
     switch (_status) {
     case RN_ConnectorStatus::Accepting: // Send CONNECT packets to the client, until a DATA packet is
                                         // received
         {
             util::Packet packet;
-            packet << UDP_PACKET_KIND_CONNECT << _passphrase << _clientIndex.value();
+            packet << UDP_PACKET_KIND_CONNECT << _passphrase << _clientIndex.value() << _features;
 
             // Safe to ignore recoverable errors here - Disconnected doesn't happen with UDP and
             // NotReady is irrelevant because CONNECTs keep getting resent until acknowledged anyway
@@ -428,7 +531,10 @@ RN_Telemetry RN_UdpConnectorImpl::sendData() {
                                          // received
         {
             util::Packet packet;
-            packet << UDP_PACKET_KIND_HELLO << _passphrase;
+            packet << UDP_PACKET_KIND_HELLO << _passphrase << _localFeatures;
+            if ((_localFeatures & UDP_FEATURE_COMPRESSION) != 0) {
+                packet << PayloadCodec::getDictionaryId(_compression.dictionary.get());
+            }
 
             // Safe to ignore recoverable errors here - Disconnected doesn't happen with UDP and
             // NotReady is irrelevant because HELLOs keep getting resent until acknowledged anyway
@@ -439,7 +545,7 @@ RN_Telemetry RN_UdpConnectorImpl::sendData() {
 
     case RN_ConnectorStatus::Connected:
         if (!_isConnectedLocally()) {
-            telemetry.uploadByteCount += _uploadAllData();
+            telemetry += _uploadAllData();
         } else {
             _transferAllDataToLocalPeer();
         }
@@ -450,6 +556,8 @@ RN_Telemetry RN_UdpConnectorImpl::sendData() {
         break;
     }
 
+    _telemetry.maxSendBufferLength = std::max(_telemetry.maxSendBufferLength, _sendBuffer.getLength());
+    _telemetry.sendProcessingTime += stopwatch.getElapsedTime<std::chrono::microseconds>();
     return telemetry;
 }
 
@@ -491,6 +599,7 @@ void RN_UdpConnectorImpl::disconnect(bool aNotfiyRemote, const std::string& aMes
 
             // Ignore all recoverable errors - The connector is getting disconnected anyway...
             _socket.send(packet, _remoteInfo.ipAddress, _remoteInfo.port);
+            _socket.flush();
         }
     }
 
@@ -511,6 +620,31 @@ PZInteger RN_UdpConnectorImpl::getRecvBufferSize() const {
     return _recvBuffer.getLength();
 }
 
+bool RN_UdpConnectorImpl::isUsingCompactAcks() const noexcept {
+    return (_features & UDP_FEATURE_COMPACT_ACKS) != 0;
+}
+
+bool RN_UdpConnectorImpl::isUsingCompression() const noexcept {
+    return (_features & UDP_FEATURE_STREAMS) != 0 && (_features & UDP_FEATURE_COMPRESSION) != 0;
+}
+
+RN_CongestionControlState RN_UdpConnectorImpl::getCongestionControlState() const {
+    return _sendBuffer.getCongestionControlState();
+}
+
+RN_ConnectorTelemetry RN_UdpConnectorImpl::getTelemetry() const {
+    RN_ConnectorTelemetry telemetry = _telemetry;
+    telemetry.windowDuration   = _telemetryStopwatch.getElapsedTime<std::chrono::microseconds>();
+    telemetry.sendBufferLength = _sendBuffer.getLength();
+    telemetry.recvBufferLength = _recvBuffer.getLength();
+    return telemetry;
+}
+
+void RN_UdpConnectorImpl::resetTelemetry() {
+    _telemetry = RN_ConnectorTelemetry{};
+    _telemetryStopwatch.restart();
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // MARK: PRIVATE METHODS                                                 //
 ///////////////////////////////////////////////////////////////////////////
@@ -522,6 +656,26 @@ bool RN_UdpConnectorImpl::_isConnectedLocally() const noexcept {
 void RN_UdpConnectorImpl::_resetBuffers() {
     _sendBuffer.reset();
     _recvBuffer.reset();
+    _features = 0;
+}
+
+void RN_UdpConnectorImpl::_applyFeatures(std::uint32_t aFeatures) {
+    _features = aFeatures;
+
+    const auto ackEncoding = ((_features & UDP_FEATURE_COMPACT_ACKS) != 0) ? AckEncoding::BITMAPS
+                                                                           : AckEncoding::ORDINAL_LIST;
+    _sendBuffer.setAckEncoding(ackEncoding);
+    _recvBuffer.setAckEncoding(ackEncoding);
+
+    const bool streamsEnabled = ((_features & UDP_FEATURE_STREAMS) != 0);
+    _sendBuffer.setStreamsEnabled(streamsEnabled);
+    _recvBuffer.setStreamsEnabled(streamsEnabled);
+
+    // (The flag which marks compressed packets is in the stream index)
+    if (isUsingCompression()) {
+        _sendBuffer.enableCompression(_compression);
+        _recvBuffer.enableCompression(_compression);
+    }
 }
 
 void RN_UdpConnectorImpl::_resetAll() {
@@ -547,16 +701,21 @@ bool RN_UdpConnectorImpl::_isConnectionTimedOut() const {
     return false;
 }
 
-PZInteger RN_UdpConnectorImpl::_uploadAllData() {
+RN_Telemetry RN_UdpConnectorImpl::_uploadAllData() {
     // TODO: propagate socket status upwards
     // TODO: better handling of packet limiter
 
-    PZInteger  packetLimiter = 10;
+    // With congestion control, the congestion window and pacing decide how much can be sent,
+    // so the limiter only guards against pathological cases
+    PZInteger packetLimiter =
+        (_sendBuffer.getCongestionControl() == RN_CongestionControl::None) ? 10 : 1000;
+
     const auto result =
         _sendBuffer.sendData(&packetLimiter,
                              _remoteInfo.meanLatency,
-                             [this](util::Packet& aPacket) -> RN_SocketAdapter::Status {
-                                 return _socket.send(aPacket, _remoteInfo.ipAddress, _remoteInfo.port);
+                             [this](std::span<const RN_SocketAdapter::DatagramPiece> aPieces)
+                                 -> RN_SocketAdapter::Status {
+                                 return _socket.send(aPieces, _remoteInfo.ipAddress, _remoteInfo.port);
                              });
 
     switch (result.socketStatus) {
@@ -579,7 +738,18 @@ PZInteger RN_UdpConnectorImpl::_uploadAllData() {
         HG_UNREACHABLE("Invalid value for RN_SocketAdapter::Status ({}).", (int)result.socketStatus);
     }
 
-    return result.uploadedByteCount;
+    _telemetry.sentPacketCount += result.sentPacketCount;
+    _telemetry.retransmittedPacketCount += result.retransmittedPacketCount;
+    _telemetry.uploadByteCount += result.uploadedByteCount;
+    _telemetry.ackByteCount += result.ackByteCount;
+    _telemetry.payloadByteCount += result.payloadByteCount;
+
+    RN_Telemetry telemetry;
+    telemetry.uploadByteCount              = result.uploadedByteCount;
+    telemetry.retransmittedByteCount       = result.retransmittedByteCount;
+    telemetry.uncompressedPayloadByteCount = result.uncompressedPayloadByteCount;
+    telemetry.compressedPayloadByteCount   = result.compressedPayloadByteCount;
+    return telemetry;
 }
 
 void RN_UdpConnectorImpl::_transferAllDataToLocalPeer() {
@@ -600,6 +770,7 @@ void RN_UdpConnectorImpl::_receivedAck(std::uint32_t ordinal, bool strong) {
 
     if (result.isSignificant) {
         _remoteInfo.timeoutStopwatch.restart();
+        _telemetry.addRttSample(result.timeToAck);
 
         _newMeanLatency += result.timeToAck;
 
@@ -617,6 +788,7 @@ void RN_UdpConnectorImpl::_receivedAck(std::uint32_t ordinal, bool strong) {
 void RN_UdpConnectorImpl::_startSession() {
     _status = RN_ConnectorStatus::Connected;
     _remoteInfo.timeoutStopwatch.restart();
+    resetTelemetry();
 }
 
 void RN_UdpConnectorImpl::_saveDataPacket(util::Packet& packet, std::uint32_t packetType) {
@@ -657,8 +829,18 @@ void RN_UdpConnectorImpl::_processConnectPacket(util::Packet& packet) {
             auto            receivedPassphrase  = packet.extract<std::string>();
             const PZInteger receivedClientIndex = packet.extract<PZInteger>();
             if (receivedPassphrase == _passphrase) {
+                // Older servers don't send the list of features to use
+                std::uint32_t features = 0;
+                if (!packet.endOfPacket()) {
+                    features = packet.extractNoThrow<std::uint32_t>();
+                    if (!packet) {
+                        features = 0;
+                    }
+                }
+
                 // Client connected to server
                 _clientIndex = receivedClientIndex;
+                _applyFeatures(features & _localFeatures);
                 _startSession();
                 _eventFactory.createConnected();
             } else {
@@ -765,6 +947,47 @@ void RN_UdpConnectorImpl::_processDataTailPacket(util::Packet& packet) {
     }
 }
 
+void RN_UdpConnectorImpl::_processDataUnorderedPacket(util::Packet& packet) {
+    switch (_status) {
+    case RN_ConnectorStatus::Connecting:
+        HG_THROW_TRACED(InvalidDataError, 0, "Received DATA_UNORDERED packet (status: Connecting).");
+
+    case RN_ConnectorStatus::Accepting:
+        _startSession(); // New connection confirmed
+        _eventFactory.createConnected();
+        SWITCH_FALLTHROUGH;
+
+    case RN_ConnectorStatus::Connected:
+        _saveDataPacket(packet, UDP_PACKET_KIND_DATA_UNORDERED);
+        break;
+
+    default:
+        HG_UNREACHABLE("Invalid value for _status ({}).", (int)_status);
+        break;
+    }
+}
+
+void RN_UdpConnectorImpl::_processUnreliablePacket(util::Packet& packet, std::uint32_t packetKind) {
+    switch (_status) {
+    case RN_ConnectorStatus::Connecting:
+        HG_THROW_TRACED(InvalidDataError, 0, "Received UNRELIABLE packet (status: Connecting).");
+
+    case RN_ConnectorStatus::Accepting:
+        _startSession(); // New connection confirmed
+        _eventFactory.createConnected();
+        SWITCH_FALLTHROUGH;
+
+    case RN_ConnectorStatus::Connected:
+        // Not acknowledged - the remote never retransmits these anyway
+        _recvBuffer.storeUnreliablePacket(std::move(packet), packetKind);
+        break;
+
+    default:
+        HG_UNREACHABLE("Invalid value for _status ({}).", (int)_status);
+        break;
+    }
+}
+
 void RN_UdpConnectorImpl::_processAcksPacket(util::Packet& packet) {
     switch (_status) {
     case RN_ConnectorStatus::Connecting:
@@ -786,6 +1009,30 @@ void RN_UdpConnectorImpl::_processAcksPacket(util::Packet& packet) {
     }
 }
 
+void RN_UdpConnectorImpl::_processAcksBitmapsPacket(util::Packet& packet) {
+    switch (_status) {
+    case RN_ConnectorStatus::Connecting:
+        HG_THROW_TRACED(InvalidDataError, 0, "Received ACKS_BITMAPS packet (status: Connecting).");
+
+    case RN_ConnectorStatus::Accepting:
+        HG_THROW_TRACED(InvalidDataError, 0, "Received ACKS_BITMAPS packet (status: Accepting).");
+
+    case RN_ConnectorStatus::Connected:
+        while (!packet.endOfPacket()) {
+            const auto base = packet.extract<PacketOrdinal>();
+            const auto mask = packet.extract<std::uint32_t>();
+            ForEachAckInBitmap(base, mask, [this](PacketOrdinal aAck) {
+                _receivedAck(aAck, false);
+            });
+        }
+        break;
+
+    default:
+        HG_UNREACHABLE("Invalid value for _status ({}).", (int)_status);
+        break;
+    }
+}
+
 } // namespace rn
 HOBGOBLIN_NAMESPACE_END
 
@@ -5,6 +5,7 @@
 #define UHOBGOBLIN_RN_UDP_CONNECTOR_IMPL_HPP
 
 #include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/RigelNet/Compression.hpp>
 #include <Hobgoblin/RigelNet/Configuration.hpp>
 #include <Hobgoblin/RigelNet/Connector_interface.hpp>
 #include <Hobgoblin/RigelNet/Events.hpp>
@@ -41,6 +42,9 @@ public:
                         const std::chrono::microseconds& aTimeoutLimit,
                         const std::string&               aPassphrase,
                         const RN_RetransmitPredicate&    aRetransmitPredicate,
+                        const std::uint32_t&             aLocalFeatures,
+                        const RN_CongestionControl&      aCongestionControl,
+                        const RN_CompressionSettings&    aCompression,
                         rn_detail::EventFactory          aEventFactory,
                         PZInteger                        aMaxPacketSize);
 
@@ -74,7 +78,10 @@ public:
 
     // Sending
 
-    void appendDataForSending(NeverNull<const void*> aData, PZInteger aDataByteCount);
+    void appendDataForSending(NeverNull<const void*> aData,
+                              PZInteger              aDataByteCount,
+                              RN_ComposeOptions      aOptions = RN_DeliveryMode::ReliableOrdered);
+    void appendSharedDataForSending(const SharedPayload& aPayload, PZInteger aStream = 0);
     auto sendData() -> RN_Telemetry;
 
     // Client index
@@ -96,14 +103,22 @@ public:
     bool      isConnectedLocally() const noexcept override;
     PZInteger getSendBufferSize() const override;
     PZInteger getRecvBufferSize() const override;
+    bool      isUsingCompactAcks() const noexcept override;
+    bool      isUsingCompression() const noexcept override;
+    auto      getCongestionControlState() const -> RN_CongestionControlState override;
+    auto      getTelemetry() const -> RN_ConnectorTelemetry override;
+    void      resetTelemetry() override;
 
 private:
-    // _socket, _timeoutLimit, _passphrase and _retransmitPredicate are references
-    // to objects that live in the Server or Client object.
+    // _socket, _timeoutLimit, _passphrase, _retransmitPredicate, _localFeatures, _congestionControl
+    // and _compression are references to objects that live in the Server or Client object.
     RN_SocketAdapter&                _socket;
     const std::chrono::microseconds& _timeoutLimit;
     const std::string&               _passphrase;
     const RN_RetransmitPredicate&    _retransmitPredicate;
+    const std::uint32_t&             _localFeatures; //!< Optional features this side supports
+    const RN_CongestionControl&      _congestionControl;
+    const RN_CompressionSettings&    _compression;
 
     rn_detail::EventFactory _eventFactory;
 
@@ -116,10 +131,14 @@ private:
     PZInteger                         _newLatencySampleSize = 0;
     RN_ConnectorStatus                _status;
     std::optional<PZInteger>          _clientIndex;
+    std::uint32_t                     _features = 0; //!< Optional features agreed on with the remote
 
     UdpSendBuffer    _sendBuffer;
     UdpReceiveBuffer _recvBuffer;
 
+    RN_ConnectorTelemetry _telemetry;
+    util::Stopwatch       _telemetryStopwatch; //!< Measures the duration of the sampling window
+
     class LocalConnectionSharedState;
     std::shared_ptr<LocalConnectionSharedState> _localSharedState = nullptr;
 
@@ -135,6 +154,9 @@ private:
     //! also clears the ack buffer.
     void _resetBuffers();
 
+    //! Starts using the given optional features (which the remote must have agreed to).
+    void _applyFeatures(std::uint32_t aFeatures);
+
     //! Clears all used data and reverts the connector into its original
     //! (unconnected) state.
     void _resetAll();
@@ -144,8 +166,8 @@ private:
     bool _isConnectionTimedOut() const;
 
     //! Sends all prepared data to the remote host (that is actually remote).
-    //! Return estimated number of bytes uploaded.
-    PZInteger _uploadAllData();
+    //! Return estimated number of bytes uploaded (and retransmitted).
+    RN_Telemetry _uploadAllData();
 
     //! Same as "_uploadAllData" but for a local connection.
     void _transferAllDataToLocalPeer();
@@ -173,7 +195,10 @@ private:
     void _processDataPacket(util::Packet& packet);
     void _processDataMorePacket(util::Packet& packet);
     void _processDataTailPacket(util::Packet& packet);
+    void _processDataUnorderedPacket(util::Packet& packet);
+    void _processUnreliablePacket(util::Packet& packet, std::uint32_t packetKind);
     void _processAcksPacket(util::Packet& packet);
+    void _processAcksBitmapsPacket(util::Packet& packet);
 };
 
 } // namespace rn
@@ -12,15 +12,43 @@ HOBGOBLIN_NAMESPACE_BEGIN
 namespace rn {
 
 // clang-format off
-constexpr std::uint32_t UDP_PACKET_KIND_HELLO      = 0x3BF0E110; //!< Client notifies server of its existence and of the wish to connect.
-constexpr std::uint32_t UDP_PACKET_KIND_CONNECT    = 0x83C96CA4; //!< Server notifies client that the connection is accepted.
-constexpr std::uint32_t UDP_PACKET_KIND_DISCONNECT = 0xD0F235AB; //!< Node notifies peer of the disconnect.
-constexpr std::uint32_t UDP_PACKET_KIND_DATA       = 0xA765B8F6; //!< Regular data packet.
-constexpr std::uint32_t UDP_PACKET_KIND_DATA_MORE  = 0x782A2A78; //!< Part of a fragmented data packet.
-constexpr std::uint32_t UDP_PACKET_KIND_DATA_TAIL  = 0x00DA7A11; //!< Final part of a fragmented data packet.
-constexpr std::uint32_t UDP_PACKET_KIND_ACKS       = 0x71AC2519; //!< Collection of acknowledges.
+constexpr std::uint32_t UDP_PACKET_KIND_HELLO                = 0x3BF0E110; //!< Client notifies server of its existence and of the wish to connect.
+constexpr std::uint32_t UDP_PACKET_KIND_CONNECT              = 0x83C96CA4; //!< Server notifies client that the connection is accepted.
+constexpr std::uint32_t UDP_PACKET_KIND_DISCONNECT           = 0xD0F235AB; //!< Node notifies peer of the disconnect.
+constexpr std::uint32_t UDP_PACKET_KIND_DATA                 = 0xA765B8F6; //!< Regular data packet.
+constexpr std::uint32_t UDP_PACKET_KIND_DATA_MORE            = 0x782A2A78; //!< Part of a fragmented data packet.
+constexpr std::uint32_t UDP_PACKET_KIND_DATA_TAIL            = 0x00DA7A11; //!< Final part of a fragmented data packet.
+constexpr std::uint32_t UDP_PACKET_KIND_DATA_UNORDERED       = 0x6E0D3A7B; //!< Data packet which is handled as soon as it's received (not in order).
+constexpr std::uint32_t UDP_PACKET_KIND_UNRELIABLE           = 0x1D5C80E2; //!< Data packet without an ordinal (never acknowledged or retransmitted).
+constexpr std::uint32_t UDP_PACKET_KIND_UNRELIABLE_SEQUENCED = 0x9A4F06C3; //!< Same as above, but dropped if a newer one was already received.
+constexpr std::uint32_t UDP_PACKET_KIND_ACKS                 = 0x71AC2519; //!< Collection of acknowledges.
+constexpr std::uint32_t UDP_PACKET_KIND_ACKS_BITMAPS         = 0x5B17AC4D; //!< Collection of acknowledges (bitmap-encoded).
 // clang-format on
 
+// Optional protocol features. A client lists the ones it supports in its HELLO packets, and the
+// server replies with the ones that will be used (supported by both sides) in its CONNECT packets.
+// Both lists are appended to the end of the packet, where older peers (which don't know about them)
+// simply don't look - so if either side doesn't send the list, no optional features are used.
+
+// clang-format off
+constexpr std::uint32_t UDP_FEATURE_COMPACT_ACKS   = (1u << 0); //!< Acks are encoded as bitmaps (see Ack_encoding.hpp).
+constexpr std::uint32_t UDP_FEATURE_DELIVERY_MODES = (1u << 1); //!< DATA_UNORDERED, UNRELIABLE and UNRELIABLE_SEQUENCED packets are understood.
+constexpr std::uint32_t UDP_FEATURE_STREAMS        = (1u << 2); //!< Headers of data packets also hold the stream index and the ordinal within the stream.
+constexpr std::uint32_t UDP_FEATURE_COMPRESSION    = (1u << 3); //!< Payloads of data packets can be compressed (see Payload_codec.hpp). Used only together with streams.
+
+constexpr std::uint32_t UDP_FEATURES_ALL = UDP_FEATURE_COMPACT_ACKS | UDP_FEATURE_DELIVERY_MODES | UDP_FEATURE_STREAMS | UDP_FEATURE_COMPRESSION;
+//! Compression is off unless the user enables it.
+constexpr std::uint32_t UDP_FEATURES_DEFAULT = UDP_FEATURES_ALL & ~UDP_FEATURE_COMPRESSION;
+// clang-format on
+
+// If a client lists UDP_FEATURE_COMPRESSION in its HELLO packets, the features are followed by the
+// ID of its compression dictionary (see `PayloadCodec::getDictionaryId()`); the server uses
+// compression only if its own dictionary has the same ID.
+
+//! Set in the stream index of a data packet if its payload (everything after the acks) is
+//! compressed; the payload then starts with its original size (uint32).
+constexpr std::uint16_t UDP_STREAM_FLAG_COMPRESSED = 0x8000;
+
 } // namespace rn
 HOBGOBLIN_NAMESPACE_END
 
@@ -7,8 +7,11 @@
 
 #include <Hobgoblin/HGExcept.hpp>
 #include <Hobgoblin/Logging.hpp>
+#include <Hobgoblin/RigelNet/Configuration.hpp>
 #include <Hobgoblin/RigelNet/Handlermgmt.hpp>
 
+#include <utility>
+
 #include <Hobgoblin/Private/Pmacro_define.hpp>
 
 HOBGOBLIN_NAMESPACE_BEGIN
@@ -19,28 +22,60 @@ constexpr auto LOG_ID = "Hobgoblin.RigelNet";
 } // namespace
 
 PZInteger UdpReceiveBuffer::getLength() const {
-    return stopz(_packets.size());
+    auto length = _queue.packets.getSize();
+    for (const auto& streamQueue : _streamQueues) {
+        length += streamQueue.packets.getSize();
+    }
+    return length;
+}
+
+void UdpReceiveBuffer::setAckEncoding(AckEncoding aAckEncoding) {
+    _ackEncoding = aAckEncoding;
+}
+
+void UdpReceiveBuffer::setStreamsEnabled(bool aEnabled) {
+    _streamQueues.clear();
+    if (aEnabled) {
+        _streamQueues.resize(pztos(RN_STREAM_COUNT));
+    }
+}
+
+void UdpReceiveBuffer::enableCompression(const RN_CompressionSettings& aSettings) {
+    HG_HARD_ASSERT(!_streamQueues.empty());
+    _payloadCodec = std::make_unique<PayloadCodec>(aSettings.dictionary);
 }
 
 void UdpReceiveBuffer::reset() {
-    _packets.clear();
-    _headOrdinal = 1;
+    _queue.packets.clear(1);
+    _ackEncoding = AckEncoding::ORDINAL_LIST;
+    _counters    = Counters{};
+    _streamQueues.clear();
+
+    _outOfOrderPackets.clear();
+    _latestUnreliableSequence = 0;
+
+    _payloadCodec.reset();
 }
 
 std::vector<PacketOrdinal> UdpReceiveBuffer::storeDataPacket(util::Packet  aPacket,
                                                              PacketOrdinal aPacketOrdinal,
                                                              std::uint32_t aPacketKind) {
-    if (aPacketOrdinal < _headOrdinal) {
-        // Old data - ignore
+    TaggedPacket* slot = _queue.getEmptySlot(aPacketOrdinal);
+    if (slot == nullptr) {
+        // Old data or already received - ignore
+        _counters.duplicatePacketCount += 1;
         return {};
     }
 
-    const std::size_t indexInBuffer = pztos(aPacketOrdinal - _headOrdinal);
-    if (indexInBuffer >= _packets.size()) {
-        _packets.resize(indexInBuffer + 1u);
-    } else if (_packets[indexInBuffer].tag != TaggedPacket::WAITING_FOR_DATA) {
-        // Already received - ignore
-        return {};
+    const bool    hasStream     = !_streamQueues.empty();
+    std::uint16_t streamIndex   = 0;
+    PacketOrdinal streamOrdinal = 0;
+    bool          isCompressed  = false;
+    if (hasStream) {
+        streamIndex   = aPacket.extract<std::uint16_t>();
+        streamOrdinal = aPacket.extract<PacketOrdinal>();
+        isCompressed  = ((streamIndex & UDP_STREAM_FLAG_COMPRESSED) != 0);
+        streamIndex &= ~UDP_STREAM_FLAG_COMPRESSED;
     }
 
     std::vector<PacketOrdinal> acks;
@@ -49,27 +84,169 @@ std::vector<PacketOrdinal> UdpReceiveBuffer::storeDataPacket(util::Packet  aPack
         if (ackOrdinal == 0u) {
             break;
         }
-        acks.push_back(ackOrdinal);
+        if (_ackEncoding == AckEncoding::BITMAPS) {
+            const auto mask = aPacket.extract<std::uint32_t>();
+            ForEachAckInBitmap(ackOrdinal, mask, [&acks](PacketOrdinal aAck) {
+                acks.push_back(aAck);
+            });
+        } else {
+            acks.push_back(ackOrdinal);
+        }
     }
 
-    _packets[indexInBuffer].packet = std::move(aPacket);
+    if (isCompressed) {
+        aPacket = _decompressPayload(aPacket);
+    }
 
+    if (aPacketKind == UDP_PACKET_KIND_DATA_UNORDERED) {
+        // Its slot only remembers that it was received
+        _outOfOrderPackets.push_back(std::move(aPacket));
+        slot->tag = TaggedPacket::UNPACKED;
+        return acks;
+    }
+
+    TaggedPacket::Tag tag;
     if (aPacketKind == UDP_PACKET_KIND_DATA) {
-        _packets[indexInBuffer].tag = TaggedPacket::READY_FOR_UNPACKING;
+        tag = TaggedPacket::READY_FOR_UNPACKING;
     } else if (aPacketKind == UDP_PACKET_KIND_DATA_MORE) {
-        _packets[indexInBuffer].tag = TaggedPacket::FRAGMENT;
+        tag = TaggedPacket::FRAGMENT;
     } else if (aPacketKind == UDP_PACKET_KIND_DATA_TAIL) {
-        _packets[indexInBuffer].tag = TaggedPacket::FRAGMENT_TAIL;
+        tag = TaggedPacket::FRAGMENT_TAIL;
     } else {
         HG_THROW_TRACED(InvalidDataError, 0, "Invalid packet kind {}.", aPacketKind);
     }
 
+    if (hasStream) {
+        if (streamIndex >= RN_STREAM_COUNT || streamOrdinal == 0) {
+            HG_THROW_TRACED(InvalidDataError,
+                            0,
+                            "Invalid stream {} (ordinal {}).",
+                            streamIndex,
+                            streamOrdinal);
+        }
+        // The packet moves on to its stream, and its slot only remembers that it was received
+        slot->tag = TaggedPacket::UNPACKED;
+        slot      = _streamQueues[streamIndex].getEmptySlot(streamOrdinal);
+        if (slot == nullptr) {
+            return acks;
+        }
+    }
+
+    slot->packet = std::move(aPacket);
+    slot->tag    = tag;
+
     return acks;
 }
 
+void UdpReceiveBuffer::storeUnreliablePacket(util::Packet aPacket, std::uint32_t aPacketKind) {
+    if (aPacketKind == UDP_PACKET_KIND_UNRELIABLE_SEQUENCED) {
+        const auto sequence = aPacket.extract<std::uint32_t>();
+        // (Serial number arithmetic, so that wrapping around doesn't matter)
+        if (_latestUnreliableSequence != 0 &&
+            static_cast<std::int32_t>(sequence - _latestUnreliableSequence) <= 0) {
+            // Stale data - ignore
+            return;
+        }
+        _latestUnreliableSequence = sequence;
+    } else if (aPacketKind != UDP_PACKET_KIND_UNRELIABLE) {
+        HG_THROW_TRACED(InvalidDataError, 0, "Invalid packet kind {}.", aPacketKind);
+    }
+
+    _outOfOrderPackets.push_back(std::move(aPacket));
+}
+
 bool UdpReceiveBuffer::takeNextReadyPacket(NeverNull<util::Packet*> aPacket) {
-    while (!_packets.empty()) {
-        switch (const auto tag = _packets[0].tag) {
+    if (!_outOfOrderPackets.empty()) {
+        *aPacket = std::move(_outOfOrderPackets.front());
+        _outOfOrderPackets.pop_front();
+        return true;
+    }
+
+    // (With streams, this only drops the slots of the packets which were received)
+    if (_queue.takeNextReadyPacket(aPacket, _counters)) {
+        return true;
+    }
+    for (auto& streamQueue : _streamQueues) {
+        if (streamQueue.takeNextReadyPacket(aPacket, _counters)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+UdpReceiveBuffer::Counters UdpReceiveBuffer::takeCounters() {
+    return std::exchange(_counters, Counters{});
+}
+
+util::Packet UdpReceiveBuffer::_decompressPayload(util::Packet& aPacket) {
+    // No datagram can be larger than this
+    static constexpr std::uint32_t MAX_ORIGINAL_BYTE_COUNT = 65535;
+
+    if (_payloadCodec == nullptr) {
+        HG_THROW_TRACED(InvalidDataError,
+                        0,
+                        "Received a compressed packet, but compression is not enabled.");
+    }
+
+    const auto originalByteCount = aPacket.extract<std::uint32_t>();
+    if (originalByteCount == 0 || originalByteCount > MAX_ORIGINAL_BYTE_COUNT) {
+        HG_THROW_TRACED(InvalidDataError,
+                        0,
+                        "Invalid size of compressed payload ({}).",
+                        originalByteCount);
+    }
+
+    const auto  compressedByteCount = aPacket.getRemainingDataSize();
+    const auto* compressedBytes =
+        static_cast<const std::uint8_t*>(aPacket.readInPlace(compressedByteCount));
+    if (!_payloadCodec->decompress({compressedBytes, static_cast<std::size_t>(compressedByteCount)},
+                                   static_cast<PZInteger>(originalByteCount),
+                                   _decompressionOutput)) {
+        HG_THROW_TRACED(InvalidDataError, 0, "Compressed payload is corrupt.");
+    }
+
+    util::Packet result;
+    const auto   bytesWritten =
+        result.write(_decompressionOutput.data(), stopz(_decompressionOutput.size()));
+    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(_decompressionOutput.size()));
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////
+// MARK: ORDERED QUEUE                                                   //
+///////////////////////////////////////////////////////////////////////////
+
+UdpReceiveBuffer::TaggedPacket* UdpReceiveBuffer::OrderedQueue::getEmptySlot(
+    PacketOrdinal aPacketOrdinal) {
+    if (aPacketOrdinal < packets.getHeadOrdinal()) {
+        return nullptr;
+    }
+    if (aPacketOrdinal - packets.getHeadOrdinal() >= MAX_ORDINALS_AHEAD) {
+        HG_THROW_TRACED(InvalidDataError,
+                        0,
+                        "Packet ordinal {} is too far ahead of the expected one ({}).",
+                        aPacketOrdinal,
+                        packets.getHeadOrdinal());
+    }
+
+    // (Slots are reused, so they have to be reinitialized)
+    while (!packets.contains(aPacketOrdinal)) {
+        auto& slot = packets.pushBack();
+        slot.packet.clear();
+        slot.tag = TaggedPacket::WAITING_FOR_DATA;
+    }
+
+    auto& slot = packets[aPacketOrdinal];
+    if (slot.tag != TaggedPacket::WAITING_FOR_DATA) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+bool UdpReceiveBuffer::OrderedQueue::takeNextReadyPacket(NeverNull<util::Packet*> aPacket,
+                                                         Counters&                aCounters) {
+    while (!packets.isEmpty()) {
+        switch (const auto tag = packets.front().tag) {
         case TaggedPacket::WAITING_FOR_DATA:
             return false;
 
@@ -83,8 +260,7 @@ bool UdpReceiveBuffer::takeNextReadyPacket(NeverNull<util::Packet*> aPacket) {
             goto BREAK_WHILE;
 
         case TaggedPacket::UNPACKED:
-            _packets.pop_front();
-            _headOrdinal += 1;
+            packets.popFront();
             break;
 
         default:
@@ -93,34 +269,35 @@ bool UdpReceiveBuffer::takeNextReadyPacket(NeverNull<util::Packet*> aPacket) {
     }
 BREAK_WHILE:
 
-    _tryToAssembleFragmentedPacketAtHead();
+    tryToAssembleFragmentedPacketAtHead(aCounters);
 
-    if (_packets.empty() || _packets[0].tag != TaggedPacket::READY_FOR_UNPACKING) {
+    if (packets.isEmpty() || packets.front().tag != TaggedPacket::READY_FOR_UNPACKING) {
         return false;
     }
 
     // It spams too much; uncomment if you need to debug.
     // HG_LOG_INFO(LOG_ID,
     //             "Packet {} taken for handling ({} bytes total, {} remaining).",
-    //             _headOrdinal,
-    //             _packets[0].packet.getDataSize(),
-    //             _packets[0].packet.getRemainingDataSize());
+    //             packets.getHeadOrdinal(),
+    //             packets.front().packet.getDataSize(),
+    //             packets.front().packet.getRemainingDataSize());
 
-    *aPacket = std::move(_packets[0].packet);
-    _packets.pop_front();
-    _headOrdinal += 1;
+    *aPacket = std::move(packets.front().packet);
+    packets.popFront();
 
     return true;
 }
 
-void UdpReceiveBuffer::_tryToAssembleFragmentedPacketAtHead() {
-    if (_packets.empty() || _packets.front().tag != TaggedPacket::FRAGMENT) {
+void UdpReceiveBuffer::OrderedQueue::tryToAssembleFragmentedPacketAtHead(Counters& aCounters) {
+    if (packets.isEmpty() || packets.front().tag != TaggedPacket::FRAGMENT) {
         return;
     }
 
+    const PacketOrdinal headOrdinal = packets.getHeadOrdinal();
+
     bool allFragmentsPresent = false;
-    for (const auto& taggedPacket : _packets) {
-        switch (taggedPacket.tag) {
+    for (PacketOrdinal ordinal = headOrdinal; ordinal != packets.getEndOrdinal(); ordinal += 1) {
+        switch (packets[ordinal].tag) {
         case TaggedPacket::WAITING_FOR_DATA:
             // Still waiting to receive fragments, we can quit right away
             return;
@@ -145,17 +322,19 @@ BREAK_FOR:
     }
 
     // Append all data to head packet, tag it ReadyForUnpacking, and other fragments as Unpacked:
-    for (std::size_t i = 1;; i += 1) {
-        TaggedPacket& curr = _packets[i];
+    TaggedPacket& head = packets.front();
+    for (PacketOrdinal ordinal = headOrdinal + 1;; ordinal += 1) {
+        TaggedPacket& curr = packets[ordinal];
 
         // Note: some leading bytes have been read previously (packet kind and acks),
         //       the rest are untouched.
         const auto remainingBytes = curr.packet.getRemainingDataSize();
         const auto bytesWritten =
-            _packets[0].packet.write(curr.packet.readInPlace(remainingBytes), remainingBytes);
+            head.packet.write(curr.packet.readInPlace(remainingBytes), remainingBytes);
         HG_ASSERT(bytesWritten == remainingBytes);
 
         curr.packet.clear();
+        aCounters.reassembledFragmentCount += 1;
 
         if (curr.tag != TaggedPacket::FRAGMENT_TAIL) {
             curr.tag = TaggedPacket::UNPACKED;
@@ -164,7 +343,10 @@ BREAK_FOR:
             break;
         }
     }
-    _packets[0].tag = TaggedPacket::READY_FOR_UNPACKING;
+    head.tag = TaggedPacket::READY_FOR_UNPACKING;
+
+    aCounters.reassembledPacketCount += 1;
+    aCounters.reassembledFragmentCount += 1; // (The head is a fragment too)
 }
 
 } // namespace rn
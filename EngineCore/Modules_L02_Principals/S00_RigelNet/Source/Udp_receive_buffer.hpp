@@ -5,14 +5,19 @@
 #define UHOBGOBLIN_RN_UDP_RECEIVE_BUFFER_HPP
 
 #include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/RigelNet/Compression.hpp>
 #include <Hobgoblin/Utility/Packet.hpp>
 
+#include "Ack_encoding.hpp"
 #include "Packet_ordinal.hpp"
+#include "Packet_window.hpp"
+#include "Payload_codec.hpp"
 #include "Socket_adapter.hpp"
 #include "Udp_connector_packet_kinds.hpp"
 
 #include <cstdint>
 #include <deque>
+#include <memory>
 #include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -35,6 +40,21 @@ public:
     //! Resets the buffer to its initial state.
     void reset();
 
+    //! Sets how the remote encodes the strong acks in its DATA packets.
+    //! \note `reset()` reverts the encoding to `AckEncoding::ORDINAL_LIST`.
+    void setAckEncoding(AckEncoding aAckEncoding);
+
+    //! Sets whether the headers of the remote's data packets hold the stream index and the
+    //! ordinal of the packet within its stream. If they do, packets are processed in order
+    //! only relative to the other packets of the same stream.
+    //! \note `reset()` disables streams.
+    void setStreamsEnabled(bool aEnabled);
+
+    //! Enables the decompression of data packets whose payloads the remote compressed (only the
+    //! dictionary from the settings is used). Streams must be enabled too.
+    //! \note `reset()` disables compression.
+    void enableCompression(const RN_CompressionSettings& aSettings);
+
     //! Stores a received Data packet, if this same packet (detemined by its ordinal) hasn't
     //! already been received before.
     //!
@@ -46,18 +66,50 @@ public:
     //! \returns a vector of strong acks contained in this packet (which will be empty if this
     //!          same packet has already been received and stores before).
     //!
-    //! \throws InvalidDataError in case the kind of the packet is invalid (not data).
+    //! \throws InvalidDataError in case the kind of the packet is invalid (not data), in case
+    //!         its stream is invalid, in case its ordinal (or its ordinal within its stream) is
+    //!         too far ahead of the packets still waiting to be processed (see
+    //!         `MAX_ORDINALS_AHEAD`), or in case its payload can't be decompressed.
     std::vector<PacketOrdinal> storeDataPacket(util::Packet  aPacket,
                                                PacketOrdinal aPacketOrdinal,
                                                std::uint32_t aPacketKind);
 
+    //! Stores a received UNRELIABLE or UNRELIABLE_SEQUENCED packet, so that it's taken by the
+    //! next call to `takeNextReadyPacket()`. A sequenced packet is dropped if a sequenced packet
+    //! sent after it was already received.
+    //!
+    //! \param aPacket the received packet. The function assumes that the first 4 bytes have
+    //!                already been read from it (packet kind).
+    //! \param aPacketKind kind of the received packet.
+    //!
+    //! \throws InvalidDataError in case the kind of the packet is invalid (not unreliable).
+    void storeUnreliablePacket(util::Packet aPacket, std::uint32_t aPacketKind);
+
     //! Attempt to take the next packet ready for processing. If such a packet exists, its
     //! contents will be moved into the packet pointed to by the passed pointer and `true`
     //! will be returned. Otherwise, nothing happens and `false` is returned.
+    //! Packets which don't need to be processed in order (DATA_UNORDERED, UNRELIABLE and
+    //! UNRELIABLE_SEQUENCED) are taken first, in the order in which they were received.
     //!
     //! \throws InvalidDataError in case invalid data is found in the buffer.
     bool takeNextReadyPacket(NeverNull<util::Packet*> aPacket);
 
+    struct Counters {
+        PZInteger duplicatePacketCount     = 0; //!< Data packets which were already received
+        PZInteger reassembledPacketCount   = 0; //!< Packets reassembled from fragments
+        PZInteger reassembledFragmentCount = 0; //!< Fragments which they were reassembled from
+    };
+
+    //! Returns the counters of events since the last call to this function (or to `reset()`),
+    //! and sets them back to 0.
+    Counters takeCounters();
+
+    //! How far ahead of the first packet which wasn't processed yet the ordinal of a received
+    //! packet can be (both connection-wide and within its stream). The remote never has this
+    //! many packets in flight, so anything further ahead can only be garbage - and storing it
+    //! would make the buffer allocate a slot for every ordinal in between.
+    static constexpr PacketOrdinal MAX_ORDINALS_AHEAD = 1u << 16;
+
 private:
     struct TaggedPacket {
         enum Tag {
@@ -72,10 +124,40 @@ private:
         Tag          tag = WAITING_FOR_DATA;
     };
 
-    std::deque<TaggedPacket> _packets;
-    PacketOrdinal            _headOrdinal = 1;
+    //! Packets which are to be processed in the order of their ordinals (starting from 1).
+    struct OrderedQueue {
+        PacketWindow<TaggedPacket> packets;
+
+        //! Returns the slot for the packet with the given ordinal, or `nullptr` if that packet
+        //! was already received before.
+        //! \throws InvalidDataError if the ordinal is `MAX_ORDINALS_AHEAD` or more past the head.
+        TaggedPacket* getEmptySlot(PacketOrdinal aPacketOrdinal);
+
+        //! See `UdpReceiveBuffer::takeNextReadyPacket()`.
+        bool takeNextReadyPacket(NeverNull<util::Packet*> aPacket, Counters& aCounters);
+
+        void tryToAssembleFragmentedPacketAtHead(Counters& aCounters);
+    };
 
-    void _tryToAssembleFragmentedPacketAtHead();
+    //! All packets by their ordinals. With streams, the packets are moved to their streams as
+    //! soon as they are received, so this only keeps track of which ones were received.
+    OrderedQueue              _queue;
+    std::vector<OrderedQueue> _streamQueues; //!< By ordinal within the stream; empty without streams
+    AckEncoding               _ackEncoding = AckEncoding::ORDINAL_LIST;
+    Counters                  _counters;
+
+    //! Received packets which can be processed right away, regardless of the ones in `_queue`.
+    std::deque<util::Packet> _outOfOrderPackets;
+    //! Sequence of the latest received UNRELIABLE_SEQUENCED packet (0 if none yet). There is
+    //! only one sequence per connector, so older packets are dropped whatever they contain.
+    std::uint32_t _latestUnreliableSequence = 0;
+
+    std::unique_ptr<PayloadCodec> _payloadCodec;        //!< Null unless compression is enabled
+    std::vector<std::uint8_t>     _decompressionOutput; //!< Reused by `_decompressPayload()`
+
+    //! Returns a packet holding only the decompressed payload of the given one (whose read
+    //! position must be at the start of the payload).
+    util::Packet _decompressPayload(util::Packet& aPacket);
 };
 
 } // namespace rn
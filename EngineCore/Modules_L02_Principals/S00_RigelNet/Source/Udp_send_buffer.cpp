@@ -19,19 +19,32 @@ constexpr auto LOG_ID = "Hobgoblin.RigelNet";
 
 constexpr PZInteger MIN_STRONG_ACKNOWLEDGES_PER_PACKET = 0;
 constexpr PZInteger MAX_STRONG_ACKNOWLEDGES_PER_PACKET = 16;
+//! With AckEncoding::BITMAPS; chosen so that the maximum header size stays the same.
+constexpr PZInteger MAX_STRONG_ACK_BITMAPS_PER_PACKET =
+    MAX_STRONG_ACKNOWLEDGES_PER_PACKET * sizeof(PacketOrdinal) / ACK_BITMAP_ENTRY_BYTE_COUNT;
 // clang-format off
 constexpr PZInteger MAX_PACKET_HEADER_BYTE_COUNT = 
       sizeof(std::uint32_t) * 1                                  // Packet type
     + sizeof(PacketOrdinal) * 1                                  // Packet ordinal
+    + sizeof(std::uint16_t) * 1                                  // Stream index (only with streams)
+    + sizeof(PacketOrdinal) * 1                                  // Ordinal within stream (ditto)
     + sizeof(PacketOrdinal) * MAX_STRONG_ACKNOWLEDGES_PER_PACKET // Strong acknowledges
     + sizeof(PacketOrdinal) * 1                                  // Acknowledges terminator
     ;
 constexpr PZInteger MIN_PACKET_HEADER_BYTE_COUNT = 
       sizeof(std::uint32_t) * 1                                  // Packet type
     + sizeof(PacketOrdinal) * 1                                  // Packet ordinal
+    + sizeof(std::uint16_t) * 1                                  // Stream index (only with streams)
+    + sizeof(PacketOrdinal) * 1                                  // Ordinal within stream (ditto)
     + sizeof(PacketOrdinal) * MIN_STRONG_ACKNOWLEDGES_PER_PACKET // Strong acknowledges
     + sizeof(PacketOrdinal) * 1                                  // Acknowledges terminator
     ;
+//! The stream index and ordinal come right after the packet type and ordinal.
+constexpr std::size_t STREAM_HEADER_OFFSET = sizeof(std::uint32_t) + sizeof(PacketOrdinal);
+constexpr PZInteger UNRELIABLE_PACKET_HEADER_BYTE_COUNT = 
+      sizeof(std::uint32_t) * 1                                  // Packet type
+    + sizeof(std::uint32_t) * 1                                  // Sequence (only if sequenced)
+    ;
 // clang-format on
 
 //! Endianess-agnostic implementation of ntoh for 32bit integers
@@ -53,120 +66,161 @@ std::int32_t hton32(std::int32_t host) {
 } // namespace
 
 UdpSendBuffer::UdpSendBuffer(PZInteger                     aMaxPacketSize,
-                             const RN_RetransmitPredicate& aRetransmitPredicate)
+                             const RN_RetransmitPredicate& aRetransmitPredicate,
+                             const RN_CongestionControl&   aCongestionControl)
     : _maxPacketSize{aMaxPacketSize}
-    , _retransmitPredicate{aRetransmitPredicate} {
+    , _retransmitPredicate{aRetransmitPredicate}
+    , _congestionControl{aCongestionControl}
+    , _congestionController{CongestionController::create(RN_CongestionControl::None, aMaxPacketSize)} {
+    _nextStreamOrdinals.assign(pztos(RN_STREAM_COUNT), 1);
     _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
 }
 
 void UdpSendBuffer::reset() {
-    _packets.clear();
-    _headOrdinal = 1;
+    // (The slots are kept for reuse, but the shared payloads mustn't be held on to)
+    while (!_packets.isEmpty()) {
+        _packets.front().clear();
+        _packets.popFront();
+    }
+    _packets.clear(1);
+    _transmissions.clear();
+    _sendCycle = 0;
     _weakAcks.clear();
     _strongAcks.clear();
+    _ackEncoding = AckEncoding::ORDINAL_LIST;
+
+    _unreliablePackets.clear();
+    _nextUnreliableSequence = 1;
+
+    _streamsEnabled = false;
+    _nextStreamOrdinals.assign(pztos(RN_STREAM_COUNT), 1);
+
+    _payloadCodec.reset();
+
+    _congestionController = CongestionController::create(_congestionControl, _maxPacketSize);
+    _bytesInFlight        = 0;
+    _nextUnsentOrdinal    = 1;
 
     _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
 }
 
-PZInteger UdpSendBuffer::getLength() const {
-    return stopz(_packets.size());
+void UdpSendBuffer::setAckEncoding(AckEncoding aAckEncoding) {
+    _ackEncoding = aAckEncoding;
 }
 
-void UdpSendBuffer::appendDataForSending(NeverNull<const void*> aData, PZInteger aDataByteCount) {
-    HG_HARD_ASSERT(aDataByteCount > 0);
+void UdpSendBuffer::setStreamsEnabled(bool aEnabled) {
+    HG_HARD_ASSERT(_packets.getSize() == 1 && _getTailPacket().isEmpty() && _strongAcks.empty());
 
-    const auto headerSizeOfNextPacket = [this]() -> PZInteger {
-        return MIN_PACKET_HEADER_BYTE_COUNT +
-               std::min(stopz(_strongAcks.size()), MAX_STRONG_ACKNOWLEDGES_PER_PACKET) *
-                   sizeof(PacketOrdinal);
-    };
+    _streamsEnabled = aEnabled;
+    _nextStreamOrdinals.assign(pztos(RN_STREAM_COUNT), 1);
 
-    // We want to send independent DATA packets whenever possible,
-    // and fragmented only when necessary.
-    if (auto& tail = _getTailPacket(); tail.packet.getDataSize() + aDataByteCount <= _maxPacketSize) {
-        const auto bytesWritten = tail.packet.write(aData, aDataByteCount);
-        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aDataByteCount));
-        return;
-    } else if (aDataByteCount + MAX_PACKET_HEADER_BYTE_COUNT <= _maxPacketSize) {
-        _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
-        auto&      tail         = _getTailPacket();
-        const auto bytesWritten = tail.packet.write(aData, aDataByteCount);
-        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aDataByteCount));
-        HG_ASSERT(tail.packet.getDataSize() <= _maxPacketSize);
-        return;
-    } else if (aDataByteCount + headerSizeOfNextPacket() <= _maxPacketSize) {
-        _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
-        auto&      tail         = _getTailPacket();
-        const auto bytesWritten = tail.packet.write(aData, aDataByteCount);
-        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aDataByteCount));
-        HG_ASSERT(tail.packet.getDataSize() <= _maxPacketSize);
-        return;
-    }
+    // The header of the tail packet has to be rewritten
+    _packets.clear(_packets.getHeadOrdinal());
+    _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
+}
 
-    // At this point, we have to send a fragmented packet
+void UdpSendBuffer::enableCompression(const RN_CompressionSettings& aSettings) {
+    HG_HARD_ASSERT(_streamsEnabled);
+    // (The original size of the payload is sent along with the compressed one)
+    HG_VALIDATE_ARGUMENT(aSettings.minPayloadByteCount > stopz(sizeof(std::uint32_t)));
 
-    const auto packetCountBefore    = _packets.size();
-    bool       reusedExistingPacket = false;
+    _payloadCodec                  = std::make_unique<PayloadCodec>(aSettings.dictionary);
+    _minCompressedPayloadByteCount = aSettings.minPayloadByteCount;
+}
 
-    // Prepare the current latest outgoing packet (finalize it if it's full enough, and
-    // set its type to DATA_MORE otherwise):
-    {
-        auto& tail = _getTailPacket();
+PZInteger UdpSendBuffer::getLength() const {
+    return _packets.getSize();
+}
 
-        // This is kind of an arbitrarily chosen limit, but if the latest outgoing packet is at
-        // least 50% full, we'll send it independently to avoid dependencies between packets.
-        if (tail.packet.getDataSize() > _maxPacketSize / 2) {
-            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA_MORE);
+void UdpSendBuffer::appendDataForSending(NeverNull<const void*> aData,
+                                         PZInteger              aDataByteCount,
+                                         PZInteger              aStream) {
+    const auto* bytes = static_cast<const char*>(aData.get());
+    _appendData(_streamsEnabled ? aStream : 0,
+                aDataByteCount,
+                [bytes](TaggedPacket& aTarget, PZInteger aOffset, PZInteger aByteCount) {
+                    const auto bytesWritten = aTarget.packet.write(bytes + aOffset, aByteCount);
+                    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aByteCount));
+                });
+}
+
+void UdpSendBuffer::appendUnorderedDataForSending(NeverNull<const void*> aData,
+                                                  PZInteger              aDataByteCount) {
+    HG_HARD_ASSERT(aDataByteCount > 0);
+
+    if (aDataByteCount + MAX_PACKET_HEADER_BYTE_COUNT > _maxPacketSize) {
+        appendDataForSending(aData, aDataByteCount);
+        return;
+    }
+
+    auto* tail = &_getTailPacket();
+    if (tail->kind != UDP_PACKET_KIND_DATA_UNORDERED ||
+        tail->getSize() + aDataByteCount > _maxPacketSize) {
+        if (tail->isEmpty()) {
+            _retargetEmptyTailPacket(UDP_PACKET_KIND_DATA_UNORDERED, 0);
         } else {
-            // Otherwise we must edit the type of the packet onto which we're going to start
-            // appending the data to DATA_MORE, so that the recepient knows not to do anything
-            // with it until the remaining fragments are also received and assembled.
-            _changePacketKind(tail, UDP_PACKET_KIND_DATA_MORE);
-            reusedExistingPacket = true;
+            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA_UNORDERED);
+            tail = &_getTailPacket();
         }
     }
 
-    // Pack the data into multiple consecutive packets:
-    PZInteger bytesPacked = 0;
-    while (true) {
-        auto& tail = _getTailPacket();
+    const auto bytesWritten = tail->packet.write(aData, aDataByteCount);
+    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aDataByteCount));
+    HG_ASSERT(tail->getSize() <= _maxPacketSize);
+}
 
-        HG_HARD_ASSERT(pztos(_maxPacketSize) >= tail.packet.getDataSize());
+void UdpSendBuffer::appendUnreliableDataForSending(NeverNull<const void*> aData,
+                                                   PZInteger              aDataByteCount,
+                                                   bool                   aSequenced) {
+    HG_HARD_ASSERT(aDataByteCount > 0);
 
-        const PZInteger remainingCapacity = _maxPacketSize - tail.packet.getDataSize();
-        const PZInteger bytesToPackNow    = std::min(remainingCapacity, aDataByteCount - bytesPacked);
+    if (aDataByteCount + UNRELIABLE_PACKET_HEADER_BYTE_COUNT > _maxPacketSize) {
+        appendDataForSending(aData, aDataByteCount);
+        return;
+    }
 
-        const auto bytesWritten =
-            tail.packet.write(static_cast<const char*>(aData.get()) + bytesPacked, bytesToPackNow);
-        HG_ASSERT(bytesWritten == static_cast<std::int64_t>(bytesToPackNow));
-        bytesPacked += bytesToPackNow;
+    const auto kind = aSequenced ? UDP_PACKET_KIND_UNRELIABLE_SEQUENCED : UDP_PACKET_KIND_UNRELIABLE;
 
-        if (bytesPacked < aDataByteCount) {
-            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA_MORE);
-        } else {
-            break;
+    // Messages composed during the same step share packets as long as they fit
+    util::Packet* target = nullptr;
+    if (!_unreliablePackets.empty()) {
+        auto& last = _unreliablePackets.back();
+        if (last.kind == kind && stopz(last.packet.getDataSize()) + aDataByteCount <= _maxPacketSize) {
+            target = &last.packet;
         }
     }
-
-    // Mark the last outgoing packet as DATA_TAIL:
-    {
-        auto& tail = _getTailPacket();
-        _changePacketKind(tail, UDP_PACKET_KIND_DATA_TAIL);
+    if (target == nullptr) {
+        _unreliablePackets.push_back({util::Packet{}, kind});
+        target = &_unreliablePackets.back().packet;
+        *target << kind;
+        if (aSequenced) {
+            *target << _nextUnreliableSequence;
+            _nextUnreliableSequence += 1;
+        }
     }
 
-    // This is just for verification: if we managed to 'piggyback' off a previously existing
-    // DATA packet, we expect that at least 1 new packet was added. Otherwise, we expect that
-    // at least 2 new packets were added (at least 1 FRAGMENT and 1 TAIL).
-    const auto packetCountAfter = _packets.size();
-    if (reusedExistingPacket) {
-        HG_HARD_ASSERT(packetCountBefore + 1 <= packetCountAfter);
-    } else {
-        HG_HARD_ASSERT(packetCountBefore + 2 <= packetCountAfter);
+    const auto bytesWritten = target->write(aData, aDataByteCount);
+    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(aDataByteCount));
+}
+
+void UdpSendBuffer::appendSharedDataForSending(const SharedPayload& aPayload, PZInteger aStream) {
+    HG_VALIDATE_ARGUMENT(aPayload != nullptr && !aPayload->empty());
+
+    const auto payloadByteCount = stopz(aPayload->size());
+    if (payloadByteCount < MIN_SHARED_PAYLOAD_BYTE_COUNT) {
+        appendDataForSending(aPayload->data(), payloadByteCount, aStream);
+        return;
     }
 
-    // We don't want chaining of multiple fragmented packets, so finalize the tail and
-    // start the next regular packet:
-    _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
+    _appendData(_streamsEnabled ? aStream : 0,
+                payloadByteCount,
+                [&aPayload](TaggedPacket& aTarget, PZInteger aOffset, PZInteger aByteCount) {
+                    aTarget.sharedSegments.push_back({aPayload,
+                                                      aOffset,
+                                                      aByteCount,
+                                                      stopz(aTarget.packet.getDataSize())});
+                    aTarget.sharedByteCount += aByteCount;
+                });
 }
 
 void UdpSendBuffer::appendAckForSending(PacketOrdinal aPacketOrdinal) {
@@ -176,23 +230,23 @@ void UdpSendBuffer::appendAckForSending(PacketOrdinal aPacketOrdinal) {
 
 UdpSendBuffer::AckReceivedResult UdpSendBuffer::ackReceived(PacketOrdinal aPacketOrdinal,
                                                             bool          aIsStrong) {
-    if (aPacketOrdinal < _headOrdinal) {
+    if (aPacketOrdinal < _packets.getHeadOrdinal()) {
         return {{}, false}; // Already acknowledged before
     }
 
-    const std::uint32_t indexInBuffer = (aPacketOrdinal - _headOrdinal);
-    if (indexInBuffer >= _packets.size()) {
+    if (!_packets.contains(aPacketOrdinal)) {
         HG_THROW_TRACED(InvalidDataError,
                         0,
                         "Received ACK for packet that's not yet sent ({}).",
                         aPacketOrdinal);
     }
 
-    auto& target = _packets[indexInBuffer];
+    auto& target = _packets[aPacketOrdinal];
 
     if (!aIsStrong) {
         switch (target.tag) {
         case TaggedPacket::NOT_ACKNOWLEDGED:
+            _packetLeftFlight(target);
             target.tag = TaggedPacket::ACKNOWLEDGED_WEAKLY;
             break;
 
@@ -205,21 +259,23 @@ UdpSendBuffer::AckReceivedResult UdpSendBuffer::ackReceived(PacketOrdinal aPacke
             HG_UNREACHABLE("Unexpected value for target.tag at this point ({}).", (int)target.tag);
         }
 
-        target.packet.clear();
+        target.clear();
         return {{}, false};
     }
 
     const auto timeToAck = target.stopwatch.getElapsedTime<std::chrono::microseconds>();
 
+    if (target.tag == TaggedPacket::NOT_ACKNOWLEDGED) {
+        _packetLeftFlight(target);
+    }
     target.tag = TaggedPacket::ACKNOWLEDGED_STRONGLY;
-    target.packet.clear();
+    target.clear();
 
-    if (indexInBuffer == 0) {
-        while (!_packets.empty() && _packets.front().tag == TaggedPacket::ACKNOWLEDGED_STRONGLY) {
-            _packets.pop_front();
-            _headOrdinal += 1;
+    if (aPacketOrdinal == _packets.getHeadOrdinal()) {
+        while (!_packets.isEmpty() && _packets.front().tag == TaggedPacket::ACKNOWLEDGED_STRONGLY) {
+            _packets.popFront();
         }
-        if (_packets.empty()) {
+        if (_packets.isEmpty()) {
             _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
         }
     }
@@ -229,50 +285,265 @@ UdpSendBuffer::AckReceivedResult UdpSendBuffer::ackReceived(PacketOrdinal aPacke
 
 std::vector<util::Packet> UdpSendBuffer::exportPackets() {
     std::vector<util::Packet> result;
-    result.reserve(_packets.size());
+    result.reserve(_unreliablePackets.size() + pztos(_packets.getSize()));
 
-    while (_packets.size() > 1) {
-        auto& packet = _packets.front();
-        result.emplace_back(std::move(packet.packet));
-        _packets.pop_front();
-        _headOrdinal += 1;
+    for (auto& unreliablePacket : _unreliablePackets) {
+        result.emplace_back(std::move(unreliablePacket.packet));
     }
+    _unreliablePackets.clear();
 
-    if (_packets.front().packet.getDataSize() > 0) {
+    // Local peers get plain packets, so shared segments have to be copied in
+    const auto exportFront = [&]() {
         auto& packet = _packets.front();
-        result.emplace_back(std::move(packet.packet));
-        _packets.pop_front();
-        _headOrdinal += 1;
+        if (packet.sharedSegments.empty()) {
+            result.emplace_back(std::move(packet.packet));
+        } else {
+            auto& exported = result.emplace_back();
+            for (const auto& piece : _gatherPieces(packet)) {
+                const auto bytesWritten = exported.write(piece.data, stopz(piece.byteCount));
+                HG_ASSERT(bytesWritten == static_cast<std::int64_t>(piece.byteCount));
+            }
+            packet.clear();
+        }
+        _packets.popFront();
+    };
+
+    while (_packets.getSize() > 1) {
+        exportFront();
+    }
 
+    if (_packets.front().getSize() > 0) {
+        exportFront();
         _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
     }
 
     return result;
 }
 
+RN_CongestionControl UdpSendBuffer::getCongestionControl() const {
+    return _congestionController->getAlgorithm();
+}
+
+RN_CongestionControlState UdpSendBuffer::getCongestionControlState() const {
+    return _congestionController->getState(_bytesInFlight);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // MARK: PRIVATE METHODS                                                 //
 ///////////////////////////////////////////////////////////////////////////
 
 UdpSendBuffer::TaggedPacket& UdpSendBuffer::_getTailPacket() {
-    HG_HARD_ASSERT(!_packets.empty());
+    HG_HARD_ASSERT(!_packets.isEmpty());
     return _packets.back();
 }
 
-void UdpSendBuffer::_prepareNextOutgoingDataPacket(std::uint32_t aPacketType) {
-    _packets.emplace_back();
-    _packets.back().tag = TaggedPacket::Tag::READY_FOR_SENDING;
+PZInteger UdpSendBuffer::_getUnreliableHeaderByteCount(std::uint32_t aPacketKind) {
+    return (aPacketKind == UDP_PACKET_KIND_UNRELIABLE_SEQUENCED) ? UNRELIABLE_PACKET_HEADER_BYTE_COUNT
+                                                                 : stopz(sizeof(std::uint32_t));
+}
+
+template <class taWriteFunction>
+void UdpSendBuffer::_appendData(PZInteger              aStream,
+                                PZInteger              aDataByteCount,
+                                const taWriteFunction& aWriteFunction) {
+    HG_HARD_ASSERT(aDataByteCount > 0);
+    HG_ASSERT(aStream >= 0 && aStream < RN_STREAM_COUNT);
+
+    // Regular data mustn't end up in an unordered packet, or in a packet of another stream
+    if (auto& tail = _getTailPacket(); tail.kind != UDP_PACKET_KIND_DATA || tail.stream != aStream) {
+        if (tail.isEmpty()) {
+            _retargetEmptyTailPacket(UDP_PACKET_KIND_DATA, aStream);
+        } else {
+            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA, aStream);
+        }
+    }
+
+    const auto headerSizeOfNextPacket = [this]() -> PZInteger {
+        if (_ackEncoding == AckEncoding::BITMAPS) {
+            PrepareAcks(_strongAcks);
+            return MIN_PACKET_HEADER_BYTE_COUNT +
+                   std::min(CountAckBitmaps(_strongAcks), MAX_STRONG_ACK_BITMAPS_PER_PACKET) *
+                       ACK_BITMAP_ENTRY_BYTE_COUNT;
+        }
+        return MIN_PACKET_HEADER_BYTE_COUNT +
+               std::min(stopz(_strongAcks.size()), MAX_STRONG_ACKNOWLEDGES_PER_PACKET) *
+                   sizeof(PacketOrdinal);
+    };
+
+    // We want to send independent DATA packets whenever possible,
+    // and fragmented only when necessary.
+    if (auto& tail = _getTailPacket(); tail.getSize() + aDataByteCount <= _maxPacketSize) {
+        aWriteFunction(tail, 0, aDataByteCount);
+        return;
+    } else if (aDataByteCount + MAX_PACKET_HEADER_BYTE_COUNT <= _maxPacketSize) {
+        _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA, aStream);
+        auto& tail = _getTailPacket();
+        aWriteFunction(tail, 0, aDataByteCount);
+        HG_ASSERT(tail.getSize() <= _maxPacketSize);
+        return;
+    } else if (aDataByteCount + headerSizeOfNextPacket() <= _maxPacketSize) {
+        _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA, aStream);
+        auto& tail = _getTailPacket();
+        aWriteFunction(tail, 0, aDataByteCount);
+        HG_ASSERT(tail.getSize() <= _maxPacketSize);
+        return;
+    }
+
+    // At this point, we have to send a fragmented packet
+
+    const auto packetCountBefore    = _packets.getSize();
+    bool       reusedExistingPacket = false;
+
+    // Prepare the current latest outgoing packet (finalize it if it's full enough, and
+    // set its type to DATA_MORE otherwise):
+    {
+        auto& tail = _getTailPacket();
+
+        // This is kind of an arbitrarily chosen limit, but if the latest outgoing packet is at
+        // least 50% full, we'll send it independently to avoid dependencies between packets.
+        if (tail.getSize() > _maxPacketSize / 2) {
+            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA_MORE, aStream);
+        } else {
+            // Otherwise we must edit the type of the packet onto which we're going to start
+            // appending the data to DATA_MORE, so that the recepient knows not to do anything
+            // with it until the remaining fragments are also received and assembled.
+            _changePacketKind(tail, UDP_PACKET_KIND_DATA_MORE);
+            reusedExistingPacket = true;
+        }
+    }
+
+    // Pack the data into multiple consecutive packets:
+    PZInteger bytesPacked = 0;
+    while (true) {
+        auto& tail = _getTailPacket();
+
+        HG_HARD_ASSERT(_maxPacketSize >= tail.getSize());
+
+        const PZInteger remainingCapacity = _maxPacketSize - tail.getSize();
+        const PZInteger bytesToPackNow    = std::min(remainingCapacity, aDataByteCount - bytesPacked);
+
+        aWriteFunction(tail, bytesPacked, bytesToPackNow);
+        bytesPacked += bytesToPackNow;
+
+        if (bytesPacked < aDataByteCount) {
+            _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA_MORE, aStream);
+        } else {
+            break;
+        }
+    }
+
+    // Mark the last outgoing packet as DATA_TAIL:
+    {
+        auto& tail = _getTailPacket();
+        _changePacketKind(tail, UDP_PACKET_KIND_DATA_TAIL);
+    }
+
+    // This is just for verification: if we managed to 'piggyback' off a previously existing
+    // DATA packet, we expect that at least 1 new packet was added. Otherwise, we expect that
+    // at least 2 new packets were added (at least 1 FRAGMENT and 1 TAIL).
+    const auto packetCountAfter = _packets.getSize();
+    if (reusedExistingPacket) {
+        HG_HARD_ASSERT(packetCountBefore + 1 <= packetCountAfter);
+    } else {
+        HG_HARD_ASSERT(packetCountBefore + 2 <= packetCountAfter);
+    }
+
+    // We don't want chaining of multiple fragmented packets, so finalize the tail and
+    // start the next regular packet:
+    _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA, aStream);
+}
+
+std::span<const RN_SocketAdapter::DatagramPiece> UdpSendBuffer::_gatherPieces(
+    const TaggedPacket& aTaggedPacket) {
+    const auto* bytes = static_cast<const std::uint8_t*>(aTaggedPacket.packet.getData());
+
+    _pieces.clear();
+    std::size_t position = 0;
+    for (const auto& segment : aTaggedPacket.sharedSegments) {
+        const auto segmentPosition = pztos(segment.position);
+        if (segmentPosition > position) {
+            _pieces.push_back({bytes + position, segmentPosition - position});
+            position = segmentPosition;
+        }
+        _pieces.push_back({segment.payload->data() + segment.payloadOffset,
+                           pztos(segment.byteCount),
+                           &segment.payload});
+    }
+    if (position < aTaggedPacket.packet.getDataSize()) {
+        _pieces.push_back({bytes + position, aTaggedPacket.packet.getDataSize() - position});
+    }
+
+    return _pieces;
+}
 
-    util::Packet& packet = _packets.back().packet;
+bool UdpSendBuffer::_isTransmissionCurrent(const Transmission& aTransmission) {
+    if (!_packets.contains(aTransmission.ordinal)) {
+        return false;
+    }
+    const auto& taggedPacket = _packets[aTransmission.ordinal];
+    return taggedPacket.tag == TaggedPacket::NOT_ACKNOWLEDGED &&
+           taggedPacket.transmissionCount == aTransmission.transmissionCount;
+}
+
+void UdpSendBuffer::_packetTransmitted(PacketOrdinal aOrdinal, PZInteger aByteCount) {
+    auto& taggedPacket = _packets[aOrdinal];
+
+    _congestionController->onPacketSent(aByteCount);
+    taggedPacket.inFlightByteCount = aByteCount;
+    _bytesInFlight += aByteCount;
+
+    taggedPacket.stopwatch.restart();
+    taggedPacket.lastTransmitCycle = _sendCycle;
+    taggedPacket.transmissionCount += 1;
+    taggedPacket.tag = TaggedPacket::NOT_ACKNOWLEDGED;
+
+    _transmissions.push_back({aOrdinal, taggedPacket.transmissionCount});
+}
+
+void UdpSendBuffer::_packetLeftFlight(TaggedPacket& aTaggedPacket) {
+    // Karn's algorithm: the round-trip time can't be measured for retransmitted packets, as it's
+    // unknown which of the transmissions was acknowledged
+    if (aTaggedPacket.transmissionCount == 1) {
+        _congestionController->onRttSample(
+            aTaggedPacket.stopwatch.getElapsedTime<std::chrono::microseconds>());
+    }
+
+    // (Packets considered lost and not yet retransmitted aren't in flight)
+    if (aTaggedPacket.inFlightByteCount > 0) {
+        _congestionController->onPacketAcked(aTaggedPacket.inFlightByteCount, _bytesInFlight);
+        _bytesInFlight -= aTaggedPacket.inFlightByteCount;
+        aTaggedPacket.inFlightByteCount = 0;
+    }
+}
+
+void UdpSendBuffer::_prepareNextOutgoingDataPacket(std::uint32_t aPacketType, PZInteger aStream) {
+    auto& taggedPacket = _packets.pushBack();
+    taggedPacket.reinitialize();
+    taggedPacket.kind   = aPacketType;
+    taggedPacket.stream = aStream;
+
+    util::Packet& packet = taggedPacket.packet;
 
     // Message type:
     packet << aPacketType;
 
     // Message ordinal:
-    packet << static_cast<PacketOrdinal>(_packets.size() + pztos(_headOrdinal) - 1u);
+    packet << static_cast<PacketOrdinal>(_packets.getEndOrdinal() - 1);
+
+    // Stream index and ordinal within the stream:
+    _writeStreamHeader(packet, aPacketType, aStream);
 
     // Strong Acknowledges (zero-terminated):
-    if (_strongAcks.size() <= pztos(MAX_STRONG_ACKNOWLEDGES_PER_PACKET)) {
+    const auto byteCountBeforeAcks = stopz(packet.getDataSize());
+    if (_ackEncoding == AckEncoding::BITMAPS) {
+        // Ordinals start from 1, so a zero base terminates the list just the same
+        PrepareAcks(_strongAcks);
+        WriteAckBitmaps(packet, _strongAcks, MAX_STRONG_ACK_BITMAPS_PER_PACKET);
+        packet << (PacketOrdinal)0;
+        if (!_strongAcks.empty()) {
+            HG_LOG_WARN(LOG_ID, "Excessive amount of pending strong acks ({})!", _strongAcks.size());
+        }
+    } else if (_strongAcks.size() <= pztos(MAX_STRONG_ACKNOWLEDGES_PER_PACKET)) {
         for (PacketOrdinal ack : _strongAcks) {
             packet << ack;
         }
@@ -289,6 +560,9 @@ void UdpSendBuffer::_prepareNextOutgoingDataPacket(std::uint32_t aPacketType) {
         _strongAcks.erase(_strongAcks.begin(), _strongAcks.begin() + MAX_STRONG_ACKNOWLEDGES_PER_PACKET);
         HG_ASSERT(stopz(_strongAcks.size()) == originalSize - MAX_STRONG_ACKNOWLEDGES_PER_PACKET);
     }
+
+    taggedPacket.headerByteCount = stopz(packet.getDataSize());
+    taggedPacket.ackByteCount    = taggedPacket.headerByteCount - byteCountBeforeAcks;
 }
 
 void UdpSendBuffer::_changePacketKind(TaggedPacket& aTaggedPacket, std::uint32_t aNewKind) {
@@ -302,6 +576,90 @@ void UdpSendBuffer::_changePacketKind(TaggedPacket& aTaggedPacket, std::uint32_t
     auto* kindPtr = packet.getMutableData();
 
     std::memcpy(kindPtr, &newKindInNetworkOrder, sizeof(newKindInNetworkOrder));
+    aTaggedPacket.kind = aNewKind;
+}
+
+void UdpSendBuffer::_retargetEmptyTailPacket(std::uint32_t aNewKind, PZInteger aNewStream) {
+    auto& tail = _getTailPacket();
+    HG_HARD_ASSERT(tail.isEmpty() && tail.tag == TaggedPacket::READY_FOR_SENDING);
+
+    if (_streamsEnabled) {
+        // The tail holds the latest ordinal of its stream, so it can be given back
+        if (tail.kind != UDP_PACKET_KIND_DATA_UNORDERED) {
+            _nextStreamOrdinals[pztos(tail.stream)] -= 1;
+        }
+
+        util::Packet streamHeader;
+        _writeStreamHeader(streamHeader, aNewKind, aNewStream);
+        HG_HARD_ASSERT(tail.packet.getDataSize() >= STREAM_HEADER_OFFSET + streamHeader.getDataSize());
+
+        auto* streamHeaderPtr = static_cast<char*>(tail.packet.getMutableData()) + STREAM_HEADER_OFFSET;
+        std::memcpy(streamHeaderPtr, streamHeader.getData(), streamHeader.getDataSize());
+    }
+
+    tail.stream = aNewStream;
+    _changePacketKind(tail, aNewKind);
+}
+
+void UdpSendBuffer::_writeStreamHeader(util::Packet& aPacket, std::uint32_t aKind, PZInteger aStream) {
+    if (!_streamsEnabled) {
+        return;
+    }
+
+    // Unordered packets don't belong to any stream (so they never hold one up)
+    PacketOrdinal streamOrdinal = 0;
+    if (aKind != UDP_PACKET_KIND_DATA_UNORDERED) {
+        streamOrdinal = _nextStreamOrdinals[pztos(aStream)];
+        _nextStreamOrdinals[pztos(aStream)] += 1;
+    }
+    aPacket << static_cast<std::uint16_t>(aStream) << streamOrdinal;
+}
+
+void UdpSendBuffer::_compressPayload(TaggedPacket& aTaggedPacket, SendResult& aResult) {
+    if (_payloadCodec == nullptr || aTaggedPacket.isCompressionDone) {
+        return;
+    }
+
+    const PZInteger headerByteCount  = aTaggedPacket.headerByteCount;
+    const PZInteger payloadByteCount = aTaggedPacket.getSize() - headerByteCount;
+    // The original size has to be sent too, so the compressed data must be smaller than this
+    const PZInteger maxCompressedByteCount = payloadByteCount - stopz(sizeof(std::uint32_t));
+    if (payloadByteCount < _minCompressedPayloadByteCount || maxCompressedByteCount <= 0) {
+        return;
+    }
+    aTaggedPacket.isCompressionDone = true;
+
+    _compressionInput.clear();
+    for (const auto& piece : _gatherPieces(aTaggedPacket)) {
+        const auto* bytes = static_cast<const std::uint8_t*>(piece.data);
+        _compressionInput.insert(_compressionInput.end(), bytes, bytes + piece.byteCount);
+    }
+
+    aResult.uncompressedPayloadByteCount += payloadByteCount;
+
+    const auto payload = std::span{_compressionInput}.subspan(pztos(headerByteCount));
+    if (!_payloadCodec->compress(payload, maxCompressedByteCount, _compressionOutput)) {
+        aResult.compressedPayloadByteCount += payloadByteCount;
+        return;
+    }
+
+    // (The packets are swapped, so that the storage of both is reused)
+    util::Packet& packet = _compressedPacket;
+    packet.clear();
+    auto bytesWritten = packet.write(_compressionInput.data(), headerByteCount);
+    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(headerByteCount));
+    packet << static_cast<std::uint32_t>(payloadByteCount);
+    bytesWritten = packet.write(_compressionOutput.data(), stopz(_compressionOutput.size()));
+    HG_ASSERT(bytesWritten == static_cast<std::int64_t>(_compressionOutput.size()));
+
+    // The stream index is in network order, so the flag is in its first byte
+    auto* streamIndexPtr = static_cast<std::uint8_t*>(packet.getMutableData()) + STREAM_HEADER_OFFSET;
+    *streamIndexPtr |= static_cast<std::uint8_t>(UDP_STREAM_FLAG_COMPRESSED >> 8);
+
+    aTaggedPacket.clear();
+    std::swap(aTaggedPacket.packet, packet);
+
+    aResult.compressedPayloadByteCount += aTaggedPacket.getSize() - headerByteCount;
 }
 
 } // namespace rn
@@ -6,17 +6,27 @@
 
 #include <Hobgoblin/Common.hpp>
 #include <Hobgoblin/Logging.hpp>
+#include <Hobgoblin/RigelNet/Compression.hpp>
+#include <Hobgoblin/RigelNet/Configuration.hpp>
+#include <Hobgoblin/RigelNet/Congestion_control.hpp>
 #include <Hobgoblin/RigelNet/Retransmit_predicate.hpp>
 #include <Hobgoblin/Utility/Packet.hpp>
 #include <Hobgoblin/Utility/Time_utils.hpp>
 
+#include "Ack_encoding.hpp"
+#include "Congestion_controller.hpp"
 #include "Invalid_data_error.hpp"
 #include "Packet_ordinal.hpp"
+#include "Packet_window.hpp"
+#include "Payload_codec.hpp"
 #include "Socket_adapter.hpp"
 #include "Udp_connector_packet_kinds.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -34,7 +44,13 @@ public:
     //!                       fragmented.
     //! \param aRetransmitPredicate reference to a retransmit predicate to use. The original
     //!                             predicate object must outlive the send buffer!
-    UdpSendBuffer(PZInteger aMaxPacketSize, const RN_RetransmitPredicate& aRetransmitPredicate);
+    //! \param aCongestionControl reference to the congestion control algorithm to use. It's
+    //!                           read only by `reset()` (until the first reset, none is used),
+    //!                           so it doesn't have to be initialized yet. The original object
+    //!                           must outlive the send buffer!
+    UdpSendBuffer(PZInteger                     aMaxPacketSize,
+                  const RN_RetransmitPredicate& aRetransmitPredicate,
+                  const RN_CongestionControl&   aCongestionControl);
 
     //! Returns the length of the buffer (number of packets in it).
     //! \note if length is growing uncontrollably, it means that the packets are not being
@@ -42,14 +58,75 @@ public:
     //!       than they can be sent, or similar.
     PZInteger getLength() const;
 
-    //! Resets the buffer to its initial state.
+    //! Resets the buffer to its initial state (including the state of congestion control).
     void reset();
 
-    //! Appends the given data into one or more outgoing packets (preserving the order of information).
+    //! Sets how acks will be encoded from now on (the remote must have agreed to it).
+    //! \note `reset()` reverts the encoding to `AckEncoding::ORDINAL_LIST`.
+    void setAckEncoding(AckEncoding aAckEncoding);
+
+    //! Sets whether the headers of data packets hold the stream index and the ordinal of the
+    //! packet within its stream (the remote must have agreed to it). Without that, all data is
+    //! sent as stream 0. Must be called right after `reset()`, before anything is appended.
+    //! \note `reset()` disables streams.
+    void setStreamsEnabled(bool aEnabled);
+
+    //! Enables the compression of the payloads of data packets (the remote must have agreed to
+    //! it, with the same dictionary). Each packet is compressed right before it's sent for the
+    //! first time (so after fragmentation), if its payload is large enough and shrinks. Streams
+    //! must already be enabled, because the stream index holds the flag which tells the remote
+    //! that the payload is compressed.
+    //! \note `reset()` disables compression.
+    void enableCompression(const RN_CompressionSettings& aSettings);
+
+    //! Appends the given data into one or more outgoing packets (preserving the order of information
+    //! within the stream).
     //!
     //! \param aData pointer to the data.
     //! \param aDataByteCount number of bytes pointed to by aData, must be greater than 0.
-    void appendDataForSending(NeverNull<const void*> aData, PZInteger aDataByteCount);
+    //! \param aStream index of the stream, in the range [0, RN_STREAM_COUNT). Ignored (treated
+    //!                as 0) unless streams are enabled.
+    void appendDataForSending(NeverNull<const void*> aData,
+                              PZInteger              aDataByteCount,
+                              PZInteger              aStream = 0);
+
+    //! Appends the given data into an outgoing DATA_UNORDERED packet, which the remote handles
+    //! as soon as it's received (without waiting for the packets before it). It's otherwise
+    //! delivered just like regular data (acknowledged and retransmitted if needed).
+    //!
+    //! \param aData pointer to the data.
+    //! \param aDataByteCount number of bytes pointed to by aData, must be greater than 0.
+    //!
+    //! \note unordered packets can't be fragmented, so data which doesn't fit into a single
+    //!       packet is appended with `appendDataForSending()` instead.
+    void appendUnorderedDataForSending(NeverNull<const void*> aData, PZInteger aDataByteCount);
+
+    //! Appends the given data into an outgoing UNRELIABLE (or UNRELIABLE_SEQUENCED) packet, which
+    //! is sent only once, during the next call to `sendData()`, and never acknowledged. These
+    //! packets aren't counted as being in flight, but they are paced like any other packets.
+    //!
+    //! \param aData pointer to the data.
+    //! \param aDataByteCount number of bytes pointed to by aData, must be greater than 0.
+    //! \param aSequenced if true, the packet is numbered, so that the remote can drop it if it
+    //!                   arrives after a packet sent later.
+    //!
+    //! \note unreliable packets can't be fragmented, so data which doesn't fit into a single
+    //!       packet is appended with `appendDataForSending()` instead.
+    void appendUnreliableDataForSending(NeverNull<const void*> aData,
+                                        PZInteger              aDataByteCount,
+                                        bool                   aSequenced);
+
+    //! Payloads smaller than this are copied by `appendSharedDataForSending()` like any other
+    //! data, because referencing them would cost more than copying them.
+    static constexpr PZInteger MIN_SHARED_PAYLOAD_BYTE_COUNT = 128;
+
+    //! Same as `appendDataForSending()`, except that the data isn't copied into the outgoing
+    //! packets - they only keep a reference to (a part of) the payload, and the pieces are
+    //! gathered into a datagram only when the packet is being sent.
+    //!
+    //! \param aPayload the data to send, must not be empty.
+    //! \param aStream index of the stream (see `appendDataForSending()`).
+    void appendSharedDataForSending(const SharedPayload& aPayload, PZInteger aStream = 0);
 
     //! Adds an ACK to be sent to the remote.
     //! \note weak acks are sent in dedicated ACKS packets, and strong acks are send in outgoing DATA
@@ -81,20 +158,44 @@ public:
     AckReceivedResult ackReceived(PacketOrdinal aPacketOrdinal, bool aIsStrong);
 
     struct SendResult {
-        PZInteger                uploadedByteCount; //!< Number of uploaded bytes.
-        RN_SocketAdapter::Status socketStatus;      //!< Last status of the socket.
+        PZInteger                uploadedByteCount;      //!< Number of uploaded bytes.
+        PZInteger                retransmittedByteCount; //!< Part of the above spent on retransmits.
+        RN_SocketAdapter::Status socketStatus;           //!< Last status of the socket.
+
+        //! Payload bytes of the packets which were sent for the first time and were large enough
+        //! to be compressed, before compression.
+        PZInteger uncompressedPayloadByteCount = 0;
+        //! The same payloads after compression (those which didn't shrink are counted as they are).
+        PZInteger compressedPayloadByteCount = 0;
+
+        PZInteger sentPacketCount          = 0; //!< Including retransmissions
+        PZInteger retransmittedPacketCount = 0;
+        PZInteger ackByteCount             = 0; //!< Of the acks in the headers of the sent packets
+        PZInteger payloadByteCount         = 0; //!< Of the sent packets (after compression)
     };
 
     //! Send packet until no more outgoing packets remain, until the packet limit is reached,
-    //! or until an error occurs.
+    //! until congestion control doesn't allow sending any more, or until an error occurs.
+    //! Unreliable packets are sent first, and always all of them (they don't count against
+    //! the packet limit) - whatever can't be sent because of an error is dropped.
+    //! With congestion control, packets are sent only while there is room in the congestion
+    //! window, they are retransmitted only after their retransmit timeout expires (in addition
+    //! to the retransmit predicate allowing it), and all sending is paced. A packet which is
+    //! about to be retransmitted is considered lost, so it doesn't count as being in flight
+    //! until it's actually retransmitted.
+    //! Only the packets which could be due for retransmission are checked, in the order in
+    //! which they were last sent (which assumes that the retransmit predicate, once it's true
+    //! for a packet, stays true as time passes).
     //!
     //! \param aPacketLimiter pointer to a variable of type PZInteger. Each time an attempt is
     //!                       made to send a packet, this variable is decremented by 1. If it
     //!                       reaches 0, `send()` returns.
     //! \param aCurrentMeanLatency current mean latency (round-trip) to the remote; needed for
     //!                            retransmit decisions.
-    //! \param aSendFunction callable object of type `RN_SocketAdapter::Status(util::Packet&)`
-    //!                      which will be used to send packets. It should return the status of
+    //! \param aSendFunction callable object of type
+    //!                      `RN_SocketAdapter::Status(std::span<const RN_SocketAdapter::DatagramPiece>)`
+    //!                      which will be used to send packets (each packet is passed as the
+    //!                      sequence of pieces it consists of). It should return the status of
     //!                      the socket after sending. As soon as it returns anything other than
     //!                      'OK', sending stops and `send()` returns, regardless of the number
     //!                      of remaining packets or the value of the packet limiter.
@@ -112,10 +213,21 @@ public:
     //!       scenarios!
     std::vector<util::Packet> exportPackets();
 
+    //! Returns the congestion control algorithm in use (chosen on the last `reset()`).
+    RN_CongestionControl getCongestionControl() const;
+
+    //! Returns the current state of congestion control.
+    RN_CongestionControlState getCongestionControlState() const;
+
 private:
     PZInteger _maxPacketSize;
 
     const RN_RetransmitPredicate& _retransmitPredicate;
+    const RN_CongestionControl&   _congestionControl;
+
+    std::unique_ptr<CongestionController> _congestionController;
+    PZInteger                             _bytesInFlight     = 0;
+    PacketOrdinal                         _nextUnsentOrdinal = 1;
 
     struct TaggedPacket {
         enum Tag {
@@ -125,75 +237,291 @@ private:
             ACKNOWLEDGED_STRONGLY,
         };
 
-        util::Packet    packet;
-        util::Stopwatch stopwatch; //!< Measures time since last upload (or upload attempt).
-        PZInteger       cyclesSinceLastTransmit = 0;
-        Tag             tag                     = READY_FOR_SENDING;
+        //! Part of a shared payload which is logically a part of the packet.
+        struct SharedSegment {
+            SharedPayload payload;
+            PZInteger     payloadOffset; //!< Where the segment starts within the payload
+            PZInteger     byteCount;
+            PZInteger     position; //!< Offset in `packet` at which the segment is spliced in
+        };
+
+        util::Packet               packet; //!< Header and all data which isn't shared
+        std::vector<SharedSegment> sharedSegments;
+        PZInteger                  sharedByteCount = 0;
+        util::Stopwatch            stopwatch; //!< Measures time since last upload (or upload attempt).
+        std::int64_t               lastTransmitCycle = 0; //!< Value of `_sendCycle` when last sent
+        PZInteger                  transmissionCount = 0;
+        PZInteger                  inFlightByteCount = 0; //!< 0 unless sent and not lost or acked
+        PZInteger                  headerByteCount   = 0;
+        PZInteger                  ackByteCount      = 0; //!< Part of the header
+        std::uint32_t              kind              = UDP_PACKET_KIND_DATA;
+        PZInteger                  stream            = 0;
+        bool                       isCompressionDone = false; //!< Compressed or incompressible
+        Tag                        tag               = READY_FOR_SENDING;
+
+        //! Returns the full size of the packet, including all shared segments.
+        PZInteger getSize() const {
+            return stopz(packet.getDataSize()) + sharedByteCount;
+        }
+
+        //! Returns true if the packet holds no data yet (only the header).
+        bool isEmpty() const {
+            return getSize() == headerByteCount;
+        }
+
+        //! Removes all data from the packet and releases all shared segments.
+        void clear() {
+            packet.clear();
+            sharedSegments.clear();
+            sharedByteCount = 0;
+        }
+
+        //! Brings a reused packet to its initial state (keeping the storage of its buffers).
+        void reinitialize() {
+            clear();
+            stopwatch.restart();
+            lastTransmitCycle = 0;
+            transmissionCount = 0;
+            inFlightByteCount = 0;
+            headerByteCount   = 0;
+            ackByteCount      = 0;
+            kind              = UDP_PACKET_KIND_DATA;
+            stream            = 0;
+            isCompressionDone = false;
+            tag               = READY_FOR_SENDING;
+        }
     };
 
-    std::deque<TaggedPacket> _packets;
-    PacketOrdinal            _headOrdinal = 1;
+    //! All packets from the oldest one which isn't strongly acknowledged yet to the tail. The
+    //! slots of dropped packets are reused, so steady traffic doesn't allocate.
+    PacketWindow<TaggedPacket> _packets;
+
+    //! A (re)transmission of a packet.
+    struct Transmission {
+        PacketOrdinal ordinal;
+        PZInteger     transmissionCount; //!< Of the packet, including this transmission
+    };
+
+    //! Transmissions in the order in which they happened, starting from the oldest one which
+    //! could still be retransmitted. Entries of packets which were acknowledged or transmitted
+    //! again since are stale and only skipped (until they reach the front and are dropped).
+    std::deque<Transmission> _transmissions;
+    std::int64_t             _sendCycle = 0; //!< Number of calls to `sendData()`
+
+    bool                       _streamsEnabled = false;
+    std::vector<PacketOrdinal> _nextStreamOrdinals; //!< Per stream; 0 is reserved for 'no stream'
 
     std::vector<PacketOrdinal> _weakAcks;
     std::vector<PacketOrdinal> _strongAcks;
+    AckEncoding                _ackEncoding = AckEncoding::ORDINAL_LIST;
+
+    struct UnreliablePacket {
+        util::Packet  packet;
+        std::uint32_t kind;
+    };
+
+    //! UNRELIABLE and UNRELIABLE_SEQUENCED packets waiting for the next `sendData()`.
+    std::vector<UnreliablePacket> _unreliablePackets;
+    std::uint32_t                 _nextUnreliableSequence = 1;
+
+    //! Reused by `_gatherPieces()`
+    std::vector<RN_SocketAdapter::DatagramPiece> _pieces;
+
+    std::unique_ptr<PayloadCodec> _payloadCodec; //!< Null unless compression is enabled
+    PZInteger                     _minCompressedPayloadByteCount = 0;
+    std::vector<std::uint8_t>     _compressionInput;  //!< Reused by `_compressPayload()`
+    std::vector<std::uint8_t>     _compressionOutput; //!< Reused by `_compressPayload()`
+    util::Packet                  _compressedPacket;  //!< Reused by `_compressPayload()`
 
     static constexpr PZInteger UDP_HEADER_BYTE_COUNT = 8;
 
     TaggedPacket& _getTailPacket();
-    void          _prepareNextOutgoingDataPacket(std::uint32_t aPacketType);
+
+    static PZInteger _getUnreliableHeaderByteCount(std::uint32_t aPacketKind);
+
+    //! Appends `aDataByteCount` bytes of data to the outgoing packets of the given stream
+    //! (fragmenting them if needed), using `aWriteFunction(TaggedPacket&, PZInteger aOffset,
+    //! PZInteger aByteCount)` to put the bytes `[aOffset, aOffset + aByteCount)` of the data
+    //! into a packet.
+    template <class taWriteFunction>
+    void _appendData(PZInteger              aStream,
+                     PZInteger              aDataByteCount,
+                     const taWriteFunction& aWriteFunction);
+
+    std::span<const RN_SocketAdapter::DatagramPiece> _gatherPieces(const TaggedPacket& aTaggedPacket);
+    //! Returns whether the transmission is the latest one of a packet which isn't acknowledged.
+    bool          _isTransmissionCurrent(const Transmission& aTransmission);
+    //! Must be called after a packet was successfully (re)transmitted.
+    void          _packetTransmitted(PacketOrdinal aOrdinal, PZInteger aByteCount);
+    //! Must be called when the first ack (weak or strong) for a sent packet is received.
+    void          _packetLeftFlight(TaggedPacket& aTaggedPacket);
+    void          _prepareNextOutgoingDataPacket(std::uint32_t aPacketType, PZInteger aStream = 0);
     void          _changePacketKind(TaggedPacket& aTaggedPacket, std::uint32_t aNewKind);
+    //! Changes the kind and the stream of the tail packet, which must still be empty.
+    void          _retargetEmptyTailPacket(std::uint32_t aNewKind, PZInteger aNewStream);
+    //! Writes the stream index and the ordinal within the stream (only if streams are enabled).
+    void          _writeStreamHeader(util::Packet& aPacket, std::uint32_t aKind, PZInteger aStream);
+    //! Compresses the payload of a packet which is about to be sent for the first time (if
+    //! compression is enabled, and the payload is large enough and shrinks), and adds its size
+    //! before and after to `aResult`.
+    void          _compressPayload(TaggedPacket& aTaggedPacket, SendResult& aResult);
 };
 
 template <class taSendFunction>
 UdpSendBuffer::SendResult UdpSendBuffer::sendData(NeverNull<PZInteger*>     aPacketLimiter,
                                                   std::chrono::microseconds aCurrentMeanLatency,
                                                   const taSendFunction&     aSendFunction) {
-    PZInteger uploadedByteCount = 0;
+    SendResult result{0, 0, RN_SocketAdapter::Status::OK};
+
+    _sendCycle += 1;
+    _congestionController->beginSending();
+    bool isCongestionLimited = false;
+
+    for (const auto& [packet, kind] : _unreliablePackets) {
+        const RN_SocketAdapter::DatagramPiece piece{packet.getData(), pztos(packet.getDataSize())};
+        const PZInteger byteCount = stopz(packet.getDataSize()) + UDP_HEADER_BYTE_COUNT;
+        switch (RN_SocketAdapter::Status status = aSendFunction(std::span{&piece, 1})) {
+        case RN_SocketAdapter::Status::OK:
+            result.uploadedByteCount += byteCount;
+            result.sentPacketCount += 1;
+            result.payloadByteCount += stopz(packet.getDataSize()) - _getUnreliableHeaderByteCount(kind);
+            _congestionController->onPacketSent(byteCount);
+            break;
 
-    for (auto& taggedPacket : _packets) {
+        case RN_SocketAdapter::Status::NotReady:
+            result.uploadedByteCount += byteCount;
+            result.socketStatus = status;
+            _unreliablePackets.clear();
+            return result;
+
+        case RN_SocketAdapter::Status::Disconnected:
+            result.socketStatus = status;
+            _unreliablePackets.clear();
+            return result;
+
+        default:
+            HG_UNREACHABLE("Invalid value for RN_SocketAdapter::Status ({}).", (int)status);
+        }
+    }
+    _unreliablePackets.clear();
+
+    // Returns false if sending should stop
+    const auto sendPacket = [&](PacketOrdinal aOrdinal, bool aIsNew) -> bool {
+        auto& taggedPacket = _packets[aOrdinal];
+
+        *aPacketLimiter -= 1;
+
+        if (aIsNew) {
+            _compressPayload(taggedPacket, result);
+        }
+
+        const PZInteger byteCount = taggedPacket.getSize() + UDP_HEADER_BYTE_COUNT;
+        switch (RN_SocketAdapter::Status status = aSendFunction(_gatherPieces(taggedPacket))) {
+        case RN_SocketAdapter::Status::OK:
+            result.uploadedByteCount += byteCount;
+            result.sentPacketCount += 1;
+            result.ackByteCount += taggedPacket.ackByteCount;
+            result.payloadByteCount += taggedPacket.getSize() - taggedPacket.headerByteCount;
+            if (aIsNew) {
+                _nextUnsentOrdinal = aOrdinal + 1;
+            } else {
+                result.retransmittedByteCount += byteCount;
+                result.retransmittedPacketCount += 1;
+            }
+            _packetTransmitted(aOrdinal, byteCount);
+            return true;
+
+        case RN_SocketAdapter::Status::NotReady:
+            result.uploadedByteCount += byteCount;
+            result.socketStatus = status;
+            return false;
+
+        case RN_SocketAdapter::Status::Disconnected:
+            result.socketStatus = status;
+            return false;
+
+        default:
+            HG_UNREACHABLE("Invalid value for RN_SocketAdapter::Status ({}).", (int)status);
+        }
+    };
+
+    // Retransmissions. Packets transmitted earlier have been waiting longer, so the first one
+    // which isn't due yet means that none of the following ones are either. (Only the packets
+    // in the queue at this point are checked, not the ones which get retransmitted now.)
+    const std::size_t transmissionCount = _transmissions.size();
+    for (std::size_t i = 0; i < transmissionCount; i += 1) {
         if (*aPacketLimiter == 0) {
             break;
         }
 
-        if (taggedPacket.tag == TaggedPacket::ACKNOWLEDGED_WEAKLY ||
-            taggedPacket.tag == TaggedPacket::ACKNOWLEDGED_STRONGLY) {
+        const auto transmission = _transmissions[i];
+        if (!_isTransmissionCurrent(transmission)) {
             continue;
         }
 
-        if ((taggedPacket.tag == TaggedPacket::READY_FOR_SENDING) ||
-            _retransmitPredicate(taggedPacket.cyclesSinceLastTransmit,
-                                 taggedPacket.stopwatch.getElapsedTime(),
-                                 aCurrentMeanLatency)) {
+        auto&      taggedPacket = _packets[transmission.ordinal];
+        const auto elapsedTime  = taggedPacket.stopwatch.getElapsedTime<std::chrono::microseconds>();
+        if (!_retransmitPredicate(static_cast<PZInteger>(_sendCycle - taggedPacket.lastTransmitCycle),
+                                  elapsedTime,
+                                  aCurrentMeanLatency) ||
+            !_congestionController->isRetransmitAllowed(elapsedTime, 1)) {
+            break;
+        }
+        if (!_congestionController->isRetransmitAllowed(elapsedTime, taggedPacket.transmissionCount)) {
+            continue; // Its timeout was backed off
+        }
+
+        if (taggedPacket.inFlightByteCount > 0) {
+            _congestionController->onPacketLost(transmission.ordinal, _nextUnsentOrdinal);
+            _bytesInFlight -= taggedPacket.inFlightByteCount;
+            taggedPacket.inFlightByteCount = 0;
+        }
 
-            *aPacketLimiter -= 1;
+        if (isCongestionLimited || _congestionController->isPacingLimited() ||
+            !_congestionController->canSendPacket(_bytesInFlight)) {
+            // Nothing more will be sent, but keep going to detect all lost packets
+            isCongestionLimited = true;
+            continue;
+        }
 
-            switch (RN_SocketAdapter::Status status = aSendFunction(taggedPacket.packet)) {
-            case RN_SocketAdapter::Status::OK:
-                uploadedByteCount += stopz(taggedPacket.packet.getDataSize() + UDP_HEADER_BYTE_COUNT);
-                break;
+        if (!sendPacket(transmission.ordinal, false)) {
+            return result;
+        }
+    }
 
-            case RN_SocketAdapter::Status::NotReady:
-                uploadedByteCount += stopz(taggedPacket.packet.getDataSize() + UDP_HEADER_BYTE_COUNT);
-                return {uploadedByteCount, RN_SocketAdapter::Status::NotReady};
+    while (!_transmissions.empty() && !_isTransmissionCurrent(_transmissions.front())) {
+        _transmissions.pop_front();
+    }
 
-            case RN_SocketAdapter::Status::Disconnected:
-                return {uploadedByteCount, RN_SocketAdapter::Status::Disconnected};
+    // New packets
+    for (auto ordinal = std::max(_nextUnsentOrdinal, _packets.getHeadOrdinal());
+         ordinal != _packets.getEndOrdinal() && !isCongestionLimited;
+         ordinal += 1) {
+        if (*aPacketLimiter == 0) {
+            break;
+        }
 
-            default:
-                HG_UNREACHABLE("Invalid value for RN_SocketAdapter::Status ({}).", (int)status);
-            }
+        if (_packets[ordinal].tag != TaggedPacket::READY_FOR_SENDING) {
+            continue; // (Only if the remote acknowledged a packet which wasn't sent yet)
+        }
 
-            taggedPacket.stopwatch.restart();
-            taggedPacket.cyclesSinceLastTransmit = 0;
+        if (_congestionController->isPacingLimited() ||
+            !_congestionController->canSendPacket(_bytesInFlight)) {
+            break;
         }
 
-        taggedPacket.cyclesSinceLastTransmit += 1;
-        taggedPacket.tag = TaggedPacket::NOT_ACKNOWLEDGED;
-    } // end for
+        if (!sendPacket(ordinal, true)) {
+            return result;
+        }
+    }
 
-    _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
+    // If the tail wasn't sent (because of the packet limiter or congestion control), it can
+    // still take more data - no need to start a new one
+    if (_getTailPacket().tag != TaggedPacket::READY_FOR_SENDING) {
+        _prepareNextOutgoingDataPacket(UDP_PACKET_KIND_DATA);
+    }
 
-    return {uploadedByteCount, RN_SocketAdapter::Status::OK};
+    return result;
 }
 
 template <class taSendFunction>
@@ -205,6 +533,21 @@ PZInteger UdpSendBuffer::sendWeakAcks(const taSendFunction& aSendFunction) {
     }
 
     util::Packet packet;
+
+    if (_ackEncoding == AckEncoding::BITMAPS) {
+        packet << UDP_PACKET_KIND_ACKS_BITMAPS;
+        PrepareAcks(_weakAcks);
+        const auto limit = (_maxPacketSize - stopz(packet.getDataSize())) / ACK_BITMAP_ENTRY_BYTE_COUNT;
+        WriteAckBitmaps(packet, _weakAcks, limit);
+        if (!_weakAcks.empty()) {
+            HG_LOG_WARN(LOG_ID, "Excessive amount of pending weak acks ({})!", _weakAcks.size());
+        }
+
+        const PZInteger dataSize = packet.getDataSize();
+        aSendFunction(packet);
+        return dataSize;
+    }
+
     packet << UDP_PACKET_KIND_ACKS;
 
     const std::size_t limit =
@@ -10,6 +10,8 @@
 #include <Hobgoblin/HGExcept.hpp>
 
 #include <cassert>
+#include <cstdint>
+#include <memory>
 #include <utility>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -19,6 +21,10 @@ namespace rn {
 
 namespace {
 constexpr auto UDP_HEADER_BYTE_COUNT = 8u;
+
+std::uint64_t MakeAddressKey(sf::IpAddress addr, std::uint16_t port) {
+    return (static_cast<std::uint64_t>(addr.toInteger()) << 16) | port;
+}
 } // namespace
 
 RN_UdpServerImpl::RN_UdpServerImpl(std::string passphrase,
@@ -33,12 +39,17 @@ RN_UdpServerImpl::RN_UdpServerImpl(std::string passphrase,
     _socket.init(_maxPacketSize);
 
     _clients.reserve(static_cast<std::size_t>(size));
+    _clientAddressKeys.resize(static_cast<std::size_t>(size));
+    _addressToClientIndex.reserve(static_cast<std::size_t>(size));
     for (PZInteger i = 0; i < size; i += 1) {
         auto connector = std::make_unique<RN_UdpConnectorImpl>(
             _socket,
             _timeoutLimit,
             _passphrase,
             _retransmitPredicate,
+            _localFeatures,
+            _congestionControl,
+            _compression,
             rn_detail::EventFactory{_eventListeners, i},
             _maxPacketSize);
 
@@ -89,12 +100,16 @@ void RN_UdpServerImpl::resize(PZInteger newSize) {
             _timeoutLimit,
             _passphrase,
             _retransmitPredicate,
+            _localFeatures,
+            _congestionControl,
+            _compression,
             rn_detail::EventFactory{_eventListeners, i},
             _maxPacketSize);
 
         _clients.push_back(std::move(connector));
         i += 1;
     }
+    _clientAddressKeys.resize(static_cast<std::size_t>(newSize));
 }
 
 void RN_UdpServerImpl::setTimeoutLimit(std::chrono::microseconds limit) {
@@ -123,6 +138,49 @@ RN_Telemetry RN_UdpServerImpl::update(RN_UpdateMode mode) {
     }
 }
 
+void RN_UdpServerImpl::setIoThreadEnabled(bool aEnabled) {
+    _socket.setIoThreadEnabled(aEnabled);
+}
+
+bool RN_UdpServerImpl::isIoThreadEnabled() const noexcept {
+    return _socket.isIoThreadEnabled();
+}
+
+void RN_UdpServerImpl::setCompactAcksEnabled(bool aEnabled) {
+    if (aEnabled) {
+        _localFeatures |= UDP_FEATURE_COMPACT_ACKS;
+    } else {
+        _localFeatures &= ~UDP_FEATURE_COMPACT_ACKS;
+    }
+}
+
+bool RN_UdpServerImpl::isCompactAcksEnabled() const noexcept {
+    return (_localFeatures & UDP_FEATURE_COMPACT_ACKS) != 0;
+}
+
+void RN_UdpServerImpl::setCongestionControl(RN_CongestionControl aCongestionControl) {
+    _congestionControl = aCongestionControl;
+}
+
+RN_CongestionControl RN_UdpServerImpl::getCongestionControl() const noexcept {
+    return _congestionControl;
+}
+
+void RN_UdpServerImpl::setCompression(const RN_CompressionSettings& aCompression) {
+    HG_VALIDATE_ARGUMENT(aCompression.minPayloadByteCount > stopz(sizeof(std::uint32_t)),
+                         "Minimal size of compressed payloads must be larger than 4 bytes.");
+    _compression = aCompression;
+    if (aCompression.enabled) {
+        _localFeatures |= UDP_FEATURE_COMPRESSION;
+    } else {
+        _localFeatures &= ~UDP_FEATURE_COMPRESSION;
+    }
+}
+
+const RN_CompressionSettings& RN_UdpServerImpl::getCompression() const noexcept {
+    return _compression;
+}
+
 void RN_UdpServerImpl::addEventListener(NeverNull<RN_EventListener*> aEventListener) {
     _addEventListener(aEventListener);
 }
@@ -149,6 +207,22 @@ void RN_UdpServerImpl::kickClient(PZInteger          aClientIndex,
     getClientConnector(aClientIndex).disconnect(aNotifyRemote, aMessage);
 }
 
+RN_ConnectorTelemetry RN_UdpServerImpl::getClientTelemetry() const {
+    RN_ConnectorTelemetry telemetry;
+    for (const auto& client : _clients) {
+        if (client->isConnected()) {
+            telemetry += client->getTelemetry();
+        }
+    }
+    return telemetry;
+}
+
+void RN_UdpServerImpl::resetClientTelemetry() {
+    for (auto& client : _clients) {
+        client->resetTelemetry();
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // STATE INSPECTION                                                      //
 ///////////////////////////////////////////////////////////////////////////
@@ -276,6 +350,8 @@ RN_Telemetry RN_UdpServerImpl::_updateReceive() {
     }
     _senderIndex = -1;
 
+    _socket.flush(); // Send out the weak acks
+
     return telemetry;
 }
 
@@ -287,19 +363,39 @@ RN_Telemetry RN_UdpServerImpl::_updateSend() {
         }
         telemetry += client->sendData();
     }
+    _socket.flush();
     return telemetry;
 }
 
 int RN_UdpServerImpl::_findConnector(sf::IpAddress addr, std::uint16_t port) const {
-    for (int i = 0; i < getSize(); i += 1) {
-        const auto& remote = getClientConnector(i).getRemoteInfo();
-        if (remote.port == port && remote.ipAddress == addr) {
-            return i;
-        }
+    const auto iter = _addressToClientIndex.find(MakeAddressKey(addr, port));
+    if (iter == _addressToClientIndex.end()) {
+        return -1;
+    }
+
+    // The connector could have been disconnected (and reset) since the entry was added
+    const auto& remote = _clients[iter->second]->getRemoteInfo();
+    if (remote.port == port && remote.ipAddress == addr) {
+        return iter->second;
     }
     return -1;
 }
 
+void RN_UdpServerImpl::_registerClientAddress(PZInteger aClientIndex) {
+    auto& key = _clientAddressKeys[pztos(aClientIndex)];
+    if (key.has_value()) {
+        const auto iter = _addressToClientIndex.find(*key);
+        // Another connector could have taken over the address in the meantime
+        if (iter != _addressToClientIndex.end() && iter->second == aClientIndex) {
+            _addressToClientIndex.erase(iter);
+        }
+    }
+
+    const auto& remote = _clients[pztos(aClientIndex)]->getRemoteInfo();
+    key = MakeAddressKey(remote.ipAddress, remote.port);
+    _addressToClientIndex[*key] = aClientIndex;
+}
+
 void RN_UdpServerImpl::_handlePacketFromUnknownSender(sf::IpAddress senderIp, 
                                                       std::uint16_t senderPort, 
                                                       util::Packet& packet) {
@@ -309,6 +405,8 @@ void RN_UdpServerImpl::_handlePacketFromUnknownSender(sf::IpAddress senderIp,
             connector->setClientIndex(i);
             if (!connector->tryAccept(senderIp, senderPort, packet)) {
                 // TODO Notify of error
+            } else {
+                _registerClientAddress(i);
             }
             return;
         }
@@ -316,19 +414,46 @@ void RN_UdpServerImpl::_handlePacketFromUnknownSender(sf::IpAddress senderIp,
     // TODO Send disconnect message (no room left)
 }
 
-void RN_UdpServerImpl::_compose(RN_ComposeForAllType, const void* data, std::size_t sizeInBytes) {
+void RN_UdpServerImpl::_compose(RN_ComposeForAllType,
+                                RN_ComposeOptions options,
+                                const void*       data,
+                                std::size_t       sizeInBytes) {
+    PZInteger recipientCount = 0;
+    for (auto& client : _clients) {
+        if (client->getStatus() == RN_ConnectorStatus::Connected) {
+            recipientCount += 1;
+        }
+    }
+
+    // (Only reliable ordered messages can be shared - the others don't stay in the send buffers)
+    if (recipientCount < 2 || stopz(sizeInBytes) < UdpSendBuffer::MIN_SHARED_PAYLOAD_BYTE_COUNT ||
+        options.deliveryMode != RN_DeliveryMode::ReliableOrdered) {
+        for (auto& client : _clients) {
+            if (client->getStatus() == RN_ConnectorStatus::Connected) {
+                client->appendDataForSending(data, sizeInBytes, options);
+            }
+        }
+        return;
+    }
+
+    // Store the data once and let all the recipients' send buffers reference it
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    const auto payload = std::make_shared<const std::vector<std::uint8_t>>(bytes, bytes + sizeInBytes);
     for (auto& client : _clients) {
         if (client->getStatus() == RN_ConnectorStatus::Connected) {
-            client->appendDataForSending(data, sizeInBytes);
+            client->appendSharedDataForSending(payload, options.stream);
         }
     }
 }
 
-void RN_UdpServerImpl::_compose(PZInteger receiver, const void* data, std::size_t sizeInBytes) {
+void RN_UdpServerImpl::_compose(PZInteger         receiver,
+                                RN_ComposeOptions options,
+                                const void*       data,
+                                std::size_t       sizeInBytes) {
     if (_clients[receiver]->getStatus() != RN_ConnectorStatus::Connected) {
         HG_THROW_TRACED(TracedLogicError, 0, "Cannot compose messages to clients that are not connected.");
     }
-    _clients[receiver]->appendDataForSending(data, sizeInBytes);
+    _clients[receiver]->appendDataForSending(data, sizeInBytes, options);
 }
 
 util::Packet* RN_UdpServerImpl::_getCurrentPacket() {
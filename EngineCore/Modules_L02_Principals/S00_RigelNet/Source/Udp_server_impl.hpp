@@ -14,8 +14,11 @@
 #include "Udp_connector_impl.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Hobgoblin/Private/Pmacro_define.hpp>
@@ -53,6 +56,22 @@ public:
 
     RN_Telemetry update(RN_UpdateMode mode) override;
 
+    void setIoThreadEnabled(bool aEnabled) override;
+
+    bool isIoThreadEnabled() const noexcept override;
+
+    void setCompactAcksEnabled(bool aEnabled) override;
+
+    bool isCompactAcksEnabled() const noexcept override;
+
+    void setCongestionControl(RN_CongestionControl aCongestionControl) override;
+
+    RN_CongestionControl getCongestionControl() const noexcept override;
+
+    void setCompression(const RN_CompressionSettings& aCompression) override;
+
+    const RN_CompressionSettings& getCompression() const noexcept override;
+
     void addEventListener(NeverNull<RN_EventListener*> aEventListener) override;
 
     void removeEventListener(NeverNull<RN_EventListener*> aEventListener) override;
@@ -69,6 +88,10 @@ public:
                     bool               aNotifyRemote = true,
                     const std::string& aMessage      = "") override;
 
+    RN_ConnectorTelemetry getClientTelemetry() const override;
+
+    void resetClientTelemetry() override;
+
     ///////////////////////////////////////////////////////////////////////////
     // STATE INSPECTION                                                      //
     ///////////////////////////////////////////////////////////////////////////
@@ -106,9 +129,23 @@ private:
 
     std::vector<std::unique_ptr<RN_UdpConnectorImpl>> _clients;
 
+    //! Maps remote addresses (IPv4 address and port packed into a single integer) to indices
+    //! of connectors in `_clients`.
+    //! Entries are added when a connector accepts a new remote, but aren't removed when the
+    //! connector is disconnected (that can happen deep inside the connector), so each entry
+    //! must be validated against the connector's current remote info before use. Each
+    //! connector has at most one entry (its previous one is removed when the slot is reused).
+    std::unordered_map<std::uint64_t, int> _addressToClientIndex;
+
+    //! For each connector in `_clients`, its key in `_addressToClientIndex` (if any).
+    std::vector<std::optional<std::uint64_t>> _clientAddressKeys;
+
     std::string               _passphrase;
     std::chrono::microseconds _timeoutLimit = std::chrono::microseconds{0};
     RN_RetransmitPredicate    _retransmitPredicate;
+    std::uint32_t             _localFeatures = UDP_FEATURES_DEFAULT; //!< See RN_UdpConnectorImpl
+    RN_CongestionControl      _congestionControl = RN_CongestionControl::None;
+    RN_CompressionSettings    _compression;
     int                       _senderIndex = -1;
     bool                      _running     = false;
 
@@ -117,12 +154,19 @@ private:
     RN_Telemetry _updateReceive();
     RN_Telemetry _updateSend();
     int          _findConnector(sf::IpAddress addr, std::uint16_t port) const;
+    void         _registerClientAddress(PZInteger aClientIndex);
     void         _handlePacketFromUnknownSender(sf::IpAddress senderIp,
                                                 std::uint16_t senderPort,
                                                 util::Packet& packet);
 
-    void _compose(RN_ComposeForAllType receiver, const void* data, std::size_t sizeInBytes) override;
-    void _compose(PZInteger receiver, const void* data, std::size_t sizeInBytes) override;
+    void _compose(RN_ComposeForAllType receiver,
+                  RN_ComposeOptions    options,
+                  const void*          data,
+                  std::size_t          sizeInBytes) override;
+    void _compose(PZInteger         receiver,
+                  RN_ComposeOptions options,
+                  const void*       data,
+                  std::size_t       sizeInBytes) override;
     util::Packet* _getCurrentPacket() override;
     void          _setUserData(util::AnyPtr userData) override;
     util::AnyPtr  _getUserData() const override;
@@ -0,0 +1,216 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <gtest/gtest.h>
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/Packet.hpp>
+
+#include "Ack_encoding.hpp"
+using namespace hg::rn;
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace {
+using Acks = std::vector<PacketOrdinal>;
+
+//! Same as in Udp_send_buffer.cpp.
+constexpr hg::PZInteger MAX_STRONG_ACK_BITMAPS_PER_PACKET =
+    16 * sizeof(PacketOrdinal) / ACK_BITMAP_ENTRY_BYTE_COUNT;
+
+//! Decodes a list of bitmap entries the same way an ACKS_BITMAPS packet is decoded.
+Acks DecodeAckBitmaps(hg::util::Packet& aPacket) {
+    Acks result;
+    while (!aPacket.endOfPacket()) {
+        const auto base = aPacket.extract<PacketOrdinal>();
+        const auto mask = aPacket.extract<std::uint32_t>();
+        ForEachAckInBitmap(base, mask, [&result](PacketOrdinal aAck) {
+            result.push_back(aAck);
+        });
+    }
+    return result;
+}
+
+//! Prepares, encodes and decodes the acks; checks that nothing was left unencoded.
+Acks RoundTrip(Acks aAcks, hg::PZInteger* aEntryCount = nullptr) {
+    PrepareAcks(aAcks);
+    const hg::PZInteger entryCount = CountAckBitmaps(aAcks);
+    if (aEntryCount != nullptr) {
+        *aEntryCount = entryCount;
+    }
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, aAcks, entryCount);
+    EXPECT_TRUE(aAcks.empty());
+    EXPECT_EQ(hg::stopz(packet.getDataSize()), entryCount * ACK_BITMAP_ENTRY_BYTE_COUNT);
+
+    return DecodeAckBitmaps(packet);
+}
+} // namespace
+
+TEST(AckEncodingTest, PrepareSortsAndRemovesDuplicates) {
+    Acks acks = {7, 3, 7, 1, 3, 3, 100, 2, 1};
+    PrepareAcks(acks);
+    EXPECT_EQ(acks, (Acks{1, 2, 3, 7, 100}));
+
+    Acks empty;
+    PrepareAcks(empty);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(AckEncodingTest, NoAcks) {
+    Acks acks;
+    EXPECT_EQ(CountAckBitmaps(acks), 0);
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, acks, MAX_STRONG_ACK_BITMAPS_PER_PACKET);
+    EXPECT_EQ(packet.getDataSize(), 0u);
+}
+
+TEST(AckEncodingTest, SingleAck) {
+    Acks acks = {42};
+    EXPECT_EQ(CountAckBitmaps(acks), 1);
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, acks, 1);
+    EXPECT_TRUE(acks.empty());
+    EXPECT_EQ(packet.extract<PacketOrdinal>(), 42u);
+    EXPECT_EQ(packet.extract<std::uint32_t>(), 0u);
+    EXPECT_TRUE(packet.endOfPacket());
+}
+
+TEST(AckEncodingTest, DuplicateAndUnsortedInputRoundTrips) {
+    hg::PZInteger entryCount = 0;
+    EXPECT_EQ(RoundTrip({40, 5, 6, 40, 5, 38, 200, 6, 199}, &entryCount),
+              (Acks{5, 6, 38, 40, 199, 200}));
+    EXPECT_EQ(entryCount, 3); // [5..37], [38..70], [199..231]
+}
+
+TEST(AckEncodingTest, GapOf32FitsIntoOneEntry) {
+    // The last bit of the mask encodes base + 32
+    Acks acks = {10, 42};
+    EXPECT_EQ(CountAckBitmaps(acks), 1);
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, acks, 1);
+    EXPECT_TRUE(acks.empty());
+    EXPECT_EQ(packet.extract<PacketOrdinal>(), 10u);
+    EXPECT_EQ(packet.extract<std::uint32_t>(), std::uint32_t{1} << 31);
+    EXPECT_TRUE(packet.endOfPacket());
+}
+
+TEST(AckEncodingTest, GapOf33NeedsTwoEntries) {
+    hg::PZInteger entryCount = 0;
+    EXPECT_EQ(RoundTrip({10, 43}, &entryCount), (Acks{10, 43}));
+    EXPECT_EQ(entryCount, 2);
+}
+
+TEST(AckEncodingTest, GapOf34NeedsTwoEntries) {
+    hg::PZInteger entryCount = 0;
+    EXPECT_EQ(RoundTrip({10, 44}, &entryCount), (Acks{10, 44}));
+    EXPECT_EQ(entryCount, 2);
+}
+
+TEST(AckEncodingTest, ConsecutiveAcksFillWholeEntries) {
+    Acks acks;
+    for (PacketOrdinal i = 1; i <= 100; i += 1) {
+        acks.push_back(i);
+    }
+
+    hg::PZInteger entryCount = 0;
+    EXPECT_EQ(RoundTrip(acks, &entryCount), acks);
+    EXPECT_EQ(entryCount, 4); // 33 + 33 + 33 + 1
+}
+
+TEST(AckEncodingTest, WritingIsSplitAcrossPackets) {
+    // Every ack needs its own entry, so it takes 3 packets to send them all
+    const hg::PZInteger ackCount = MAX_STRONG_ACK_BITMAPS_PER_PACKET * 2 + 3;
+
+    Acks acks;
+    for (hg::PZInteger i = 0; i < ackCount; i += 1) {
+        acks.push_back(static_cast<PacketOrdinal>(1 + i * 100));
+    }
+    const Acks expected = acks;
+    ASSERT_EQ(CountAckBitmaps(acks), ackCount);
+
+    Acks decoded;
+    for (hg::PZInteger expectedEntries :
+         {MAX_STRONG_ACK_BITMAPS_PER_PACKET, MAX_STRONG_ACK_BITMAPS_PER_PACKET, hg::PZInteger{3}}) {
+        hg::util::Packet packet;
+        WriteAckBitmaps(packet, acks, MAX_STRONG_ACK_BITMAPS_PER_PACKET);
+        EXPECT_EQ(hg::stopz(packet.getDataSize()), expectedEntries * ACK_BITMAP_ENTRY_BYTE_COUNT);
+
+        const Acks part = DecodeAckBitmaps(packet);
+        decoded.insert(decoded.end(), part.begin(), part.end());
+    }
+    EXPECT_TRUE(acks.empty());
+    EXPECT_EQ(decoded, expected);
+}
+
+TEST(AckEncodingTest, AcksWhichDontFitStayInTheVector) {
+    Acks acks = {1, 2, 100, 101, 200};
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, acks, 1);
+    EXPECT_EQ(acks, (Acks{100, 101, 200}));
+    EXPECT_EQ(DecodeAckBitmaps(packet), (Acks{1, 2}));
+}
+
+TEST(AckEncodingTest, ForEachAckInBitmap) {
+    Acks acks;
+    const auto collect = [&acks](PacketOrdinal aAck) {
+        acks.push_back(aAck);
+    };
+
+    ForEachAckInBitmap(1000, 0x00000000u, collect);
+    EXPECT_EQ(acks, (Acks{1000}));
+
+    acks.clear();
+    ForEachAckInBitmap(1000, 0x80000005u, collect);
+    EXPECT_EQ(acks, (Acks{1000, 1001, 1003, 1032}));
+
+    acks.clear();
+    ForEachAckInBitmap(1000, 0xFFFFFFFFu, collect);
+    ASSERT_EQ(acks.size(), 33u);
+    EXPECT_EQ(acks.front(), 1000u);
+    EXPECT_EQ(acks.back(), 1032u);
+}
+
+TEST(AckEncodingTest, DecodingTruncatedBitmapListThrows) {
+    Acks acks = {1, 2, 100};
+
+    hg::util::Packet packet;
+    WriteAckBitmaps(packet, acks, MAX_STRONG_ACK_BITMAPS_PER_PACKET);
+    packet << PacketOrdinal{500}; // Base without a mask
+
+    EXPECT_THROW(DecodeAckBitmaps(packet), hg::util::PacketReadError);
+
+    hg::util::Packet halfEntry;
+    halfEntry << std::uint16_t{7};
+    EXPECT_THROW(DecodeAckBitmaps(halfEntry), hg::util::PacketReadError);
+}
+
+TEST(AckEncodingTest, DecodingGarbageStaysWithinEachEntry) {
+    hg::util::Packet packet;
+    std::uint32_t    state = 12345;
+    for (int i = 0; i < 64; i += 1) {
+        state = state * 1664525u + 1013904223u;
+        packet << state;
+    }
+
+    // Every decoded ordinal must be within [base, base + 32] of its own entry
+    // (wrapping around is fine - such acks are simply not found in the send buffer)
+    while (!packet.endOfPacket()) {
+        const auto base  = packet.extract<PacketOrdinal>();
+        const auto mask  = packet.extract<std::uint32_t>();
+        int        count = 0;
+        ForEachAckInBitmap(base, mask, [&](PacketOrdinal aAck) {
+            EXPECT_LE(static_cast<PacketOrdinal>(aAck - base), 32u);
+            count += 1;
+        });
+        EXPECT_EQ(count, 1 + std::popcount(mask));
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#ifdef __linux__
+
+#include <gtest/gtest.h>
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/Packet.hpp>
+
+#include "Native_udp_socket.hpp"
+using namespace hg::rn;
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+//! Lets only a limited number of datagrams through to the OS at a time, and fails the rest with
+//! `EAGAIN`, as the OS does when the socket's send buffer is full. (This can't be provoked with
+//! a real socket on the loopback interface, which never runs out of buffer space.)
+class LimitedNativeUdpSocket : public RN_NativeUdpSocket {
+public:
+    hg::PZInteger budget = 0;
+
+protected:
+    int _sendDatagrams(mmsghdr* aHeaders, unsigned aCount) override {
+        if (budget == 0) {
+            errno = EAGAIN;
+            return -1;
+        }
+        const auto count = std::min(aCount, static_cast<unsigned>(budget));
+        const int  res   = RN_NativeUdpSocket::_sendDatagrams(aHeaders, count);
+        if (res > 0) {
+            budget -= res;
+        }
+        return res;
+    }
+};
+
+constexpr hg::PZInteger MAX_DATAGRAM_SIZE = 64;
+} // namespace
+
+class NativeUdpSocketTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _receiver.init(MAX_DATAGRAM_SIZE);
+        ASSERT_EQ(_receiver.bind(0, sf::IpAddress::LocalHost), sf::Socket::Done);
+        _sender.init(MAX_DATAGRAM_SIZE);
+        ASSERT_EQ(_sender.bind(0, sf::IpAddress::LocalHost), sf::Socket::Done);
+    }
+
+    sf::Socket::Status _send(std::uint32_t aValue) {
+        hg::util::Packet packet;
+        packet << aValue;
+        return _sender.send(packet.getData(),
+                            static_cast<std::size_t>(packet.getDataSize()),
+                            sf::IpAddress::LocalHost,
+                            _receiver.getLocalPort());
+    }
+
+    std::vector<std::uint32_t> _receiveAll() {
+        std::vector<std::uint32_t> result;
+        int                        idleCount = 0;
+        while (idleCount < 10) {
+            hg::util::Packet packet;
+            sf::IpAddress    address;
+            std::uint16_t    port;
+            const auto       status = _receiver.receive(packet, address, port);
+            if (status != sf::Socket::Done) {
+                idleCount += 1;
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                continue;
+            }
+            idleCount = 0;
+            result.push_back(packet.extract<std::uint32_t>());
+        }
+        return result;
+    }
+
+    LimitedNativeUdpSocket _sender;
+    RN_NativeUdpSocket     _receiver;
+};
+
+TEST_F(NativeUdpSocketTest, DatagramsKeptWhileSendBufferIsFull) {
+    constexpr std::uint32_t BATCH_SIZE = static_cast<std::uint32_t>(RN_NativeUdpSocket::BATCH_SIZE);
+
+    // Fill the queue; nothing is handed to the OS yet
+    std::uint32_t nextValue = 0;
+    for (; nextValue < BATCH_SIZE; nextValue += 1) {
+        ASSERT_EQ(_send(nextValue), sf::Socket::Done);
+    }
+
+    // Only some of the queue fits into the send buffer
+    _sender.budget = 10;
+    EXPECT_EQ(_sender.flush(), sf::Socket::NotReady);
+    EXPECT_EQ(_sender.flush(), sf::Socket::NotReady);
+
+    // What didn't go out is still queued, so there's room for exactly 10 more
+    for (int i = 0; i < 10; i += 1, nextValue += 1) {
+        ASSERT_EQ(_send(nextValue), sf::Socket::Done);
+    }
+    // The queue is full and the send buffer is still full, so this one is rejected
+    EXPECT_EQ(_send(nextValue), sf::Socket::NotReady);
+
+    // Once there's room in the send buffer, the next flush sends the rest
+    _sender.budget = 1000;
+    EXPECT_EQ(_sender.flush(), sf::Socket::Done);
+
+    const auto received = _receiveAll();
+    ASSERT_EQ(received.size(), nextValue);
+    for (std::uint32_t i = 0; i < nextValue; i += 1) {
+        EXPECT_EQ(received[i], i);
+    }
+}
+
+TEST_F(NativeUdpSocketTest, LargeDatagramWaitsForQueue) {
+    ASSERT_EQ(_send(0), sf::Socket::Done);
+
+    // A datagram too large for the queue must not overtake the queued one
+    std::vector<std::uint8_t> large(MAX_DATAGRAM_SIZE * 2, 0xAB);
+    EXPECT_EQ(
+        _sender.send(large.data(), large.size(), sf::IpAddress::LocalHost, _receiver.getLocalPort()),
+        sf::Socket::NotReady);
+
+    _sender.budget = 1;
+    EXPECT_EQ(_sender.flush(), sf::Socket::Done);
+
+    const auto received = _receiveAll();
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0], 0u);
+}
+
+#endif // __linux__
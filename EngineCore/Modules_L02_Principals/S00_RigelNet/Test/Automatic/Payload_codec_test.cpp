@@ -0,0 +1,246 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <gtest/gtest.h>
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Common.hpp>
+
+#include "Payload_codec.hpp"
+using namespace hg::rn;
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+using Bytes = std::vector<std::uint8_t>;
+
+Bytes MakeText(int aRepetitionCount) {
+    const std::string sentence = "The quick brown fox jumps over the lazy dog. ";
+
+    Bytes result;
+    for (int i = 0; i < aRepetitionCount; i += 1) {
+        result.insert(result.end(), sentence.begin(), sentence.end());
+        result.push_back(static_cast<std::uint8_t>(i)); // So that it's not all the same
+    }
+    return result;
+}
+
+//! Deterministic bytes which don't compress.
+Bytes MakeNoise(std::size_t aByteCount, std::uint32_t aSeed = 12345) {
+    Bytes         result;
+    std::uint32_t state = aSeed;
+    for (std::size_t i = 0; i < aByteCount; i += 1) {
+        state = state * 1664525u + 1013904223u;
+        result.push_back(static_cast<std::uint8_t>(state >> 24));
+    }
+    return result;
+}
+
+std::shared_ptr<const Bytes> MakeDictionary(const Bytes& aBytes) {
+    return std::make_shared<const Bytes>(aBytes);
+}
+
+hg::PZInteger Size(const Bytes& aBytes) {
+    return static_cast<hg::PZInteger>(aBytes.size());
+}
+} // namespace
+
+TEST(PayloadCodecTest, RoundTripWithoutDictionary) {
+    PayloadCodec codec{nullptr};
+    const auto   original = MakeText(20);
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+    EXPECT_LT(compressed.size(), original.size() / 4);
+
+    Bytes decompressed;
+    ASSERT_TRUE(codec.decompress(compressed, Size(original), decompressed));
+    EXPECT_EQ(decompressed, original);
+}
+
+TEST(PayloadCodecTest, RoundTripWithDictionary) {
+    const auto   sample = MakeText(3);
+    PayloadCodec codec{MakeDictionary(sample)};
+    PayloadCodec codecWithoutDictionary{nullptr};
+
+    // Too short to repeat itself much, but it's all in the dictionary
+    const Bytes original(sample.begin() + 5, sample.begin() + 60);
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+    Bytes withoutDictionary;
+    ASSERT_TRUE(codecWithoutDictionary.compress(original, Size(original) * 2, withoutDictionary));
+    EXPECT_LT(compressed.size() * 4, withoutDictionary.size());
+
+    Bytes decompressed;
+    ASSERT_TRUE(codec.decompress(compressed, Size(original), decompressed));
+    EXPECT_EQ(decompressed, original);
+}
+
+TEST(PayloadCodecTest, LongRunsRoundTrip) {
+    // Long literal runs and long (overlapping) matches need length continuation bytes
+    PayloadCodec codec{nullptr};
+    auto         original = MakeNoise(700);
+    original.insert(original.end(), 1000, 0xAA);
+    const auto noise = MakeNoise(300, 777);
+    original.insert(original.end(), noise.begin(), noise.end());
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+
+    Bytes decompressed;
+    ASSERT_TRUE(codec.decompress(compressed, Size(original), decompressed));
+    EXPECT_EQ(decompressed, original);
+}
+
+TEST(PayloadCodecTest, EmptyInput) {
+    PayloadCodec codec{MakeDictionary(MakeText(1))};
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress({}, 100, compressed));
+
+    Bytes decompressed{1, 2, 3};
+    ASSERT_TRUE(codec.decompress(compressed, 0, decompressed));
+    EXPECT_TRUE(decompressed.empty());
+
+    // But nothing decompresses from no data at all
+    EXPECT_FALSE(codec.decompress({}, 0, decompressed));
+}
+
+TEST(PayloadCodecTest, IncompressibleInput) {
+    PayloadCodec codec{nullptr};
+    const auto   original = MakeNoise(500);
+
+    Bytes compressed;
+    EXPECT_FALSE(codec.compress(original, Size(original), compressed));
+
+    // It still round trips if the output is allowed to be larger
+    ASSERT_TRUE(codec.compress(original, Size(original) * 2, compressed));
+    Bytes decompressed;
+    ASSERT_TRUE(codec.decompress(compressed, Size(original), decompressed));
+    EXPECT_EQ(decompressed, original);
+}
+
+TEST(PayloadCodecTest, TruncatedInputIsRejected) {
+    PayloadCodec codec{nullptr};
+    const auto   original = MakeText(10);
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+
+    Bytes decompressed;
+    for (std::size_t length = 0; length < compressed.size(); length += 1) {
+        const std::span<const std::uint8_t> truncated{compressed.data(), length};
+        EXPECT_FALSE(codec.decompress(truncated, Size(original), decompressed)) << "length " << length;
+    }
+}
+
+TEST(PayloadCodecTest, WrongOriginalSizeIsRejected) {
+    PayloadCodec codec{nullptr};
+    const auto   original = MakeText(10);
+
+    Bytes compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+
+    Bytes decompressed;
+    EXPECT_FALSE(codec.decompress(compressed, Size(original) - 1, decompressed));
+    EXPECT_FALSE(codec.decompress(compressed, Size(original) + 1, decompressed));
+}
+
+TEST(PayloadCodecTest, OverlongLiteralLengthIsRejected) {
+    PayloadCodec codec{nullptr};
+    Bytes        decompressed;
+
+    // Literal length 15 + 255 + 10, but only 3 literals follow
+    const Bytes data{0xF0, 255, 10, 'a', 'b', 'c'};
+    EXPECT_FALSE(codec.decompress(data, 1000, decompressed));
+
+    // Literal length continues past the end of the data
+    const Bytes unterminated{0xF0, 255, 255};
+    EXPECT_FALSE(codec.decompress(unterminated, 1000, decompressed));
+
+    // Fits into the data, but is longer than the original
+    const Bytes tooLong{0x30, 'a', 'b', 'c'};
+    EXPECT_FALSE(codec.decompress(tooLong, 2, decompressed));
+}
+
+TEST(PayloadCodecTest, OverlongMatchLengthIsRejected) {
+    PayloadCodec codec{nullptr};
+    Bytes        decompressed;
+
+    // One literal, then a match of 4 + 15 + 200 bytes at offset 1 (but the original is 50 bytes)
+    const Bytes data{0x1F, 'a', 1, 0, 200, 0x00};
+    EXPECT_FALSE(codec.decompress(data, 50, decompressed));
+
+    // Match length continues past the end of the data
+    const Bytes unterminated{0x1F, 'a', 1, 0, 255};
+    EXPECT_FALSE(codec.decompress(unterminated, 1000, decompressed));
+
+    // The same match, but with a fitting size, is fine
+    ASSERT_TRUE(codec.decompress(data, 1 + 4 + 15 + 200, decompressed));
+    EXPECT_EQ(decompressed, Bytes(220, 'a'));
+}
+
+TEST(PayloadCodecTest, OffsetBeforeDictionaryIsRejected) {
+    const Bytes  dictionary{'w', 'x', 'y', 'z'};
+    PayloadCodec codec{MakeDictionary(dictionary)};
+    PayloadCodec codecWithoutDictionary{nullptr};
+    Bytes        decompressed;
+
+    // One literal, then a match of 4 bytes at the given offset, then a final empty sequence
+    const auto makeData = [](std::uint8_t aOffset) {
+        return Bytes{0x10, 'a', aOffset, 0, 0x00};
+    };
+
+    // Offset 5 is the start of the dictionary
+    ASSERT_TRUE(codec.decompress(makeData(5), 5, decompressed));
+    EXPECT_EQ(decompressed, (Bytes{'a', 'w', 'x', 'y', 'z'}));
+
+    EXPECT_FALSE(codec.decompress(makeData(6), 5, decompressed));
+    EXPECT_FALSE(codecWithoutDictionary.decompress(makeData(2), 5, decompressed));
+    EXPECT_FALSE(codec.decompress(makeData(0), 5, decompressed));
+}
+
+TEST(PayloadCodecTest, DictionaryMismatch) {
+    const auto sample      = MakeText(3);
+    auto       otherSample = sample;
+    for (auto& byte : otherSample) {
+        byte ^= 0x5A;
+    }
+
+    PayloadCodec codec{MakeDictionary(sample)};
+    PayloadCodec otherCodec{MakeDictionary(otherSample)};
+    PayloadCodec codecWithoutDictionary{nullptr};
+
+    const Bytes original(sample.begin() + 5, sample.begin() + 60);
+    Bytes       compressed;
+    ASSERT_TRUE(codec.compress(original, Size(original), compressed));
+
+    // The format can't tell that the dictionary is different, but the result is never the original
+    Bytes decompressed;
+    if (otherCodec.decompress(compressed, Size(original), decompressed)) {
+        EXPECT_NE(decompressed, original);
+    }
+    EXPECT_FALSE(codecWithoutDictionary.decompress(compressed, Size(original), decompressed));
+
+    // Which is why peers compare dictionary IDs first
+    EXPECT_EQ(PayloadCodec::getDictionaryId(nullptr), 0u);
+    EXPECT_EQ(PayloadCodec::getDictionaryId(&sample), PayloadCodec::getDictionaryId(&sample));
+    EXPECT_NE(PayloadCodec::getDictionaryId(&sample), PayloadCodec::getDictionaryId(&otherSample));
+    EXPECT_NE(PayloadCodec::getDictionaryId(&sample), 0u);
+}
+
+TEST(PayloadCodecTest, GarbageDoesntCrash) {
+    PayloadCodec codec{MakeDictionary(MakeText(2))};
+    Bytes        decompressed;
+
+    for (std::uint32_t seed = 1; seed <= 2000; seed += 1) {
+        const auto garbage = MakeNoise(1 + seed % 64, seed);
+        if (codec.decompress(garbage, 100, decompressed)) {
+            EXPECT_EQ(decompressed.size(), 100u);
+        }
+    }
+}
@@ -10,11 +10,14 @@
 #include <Hobgoblin/RigelNet_macros.hpp>
 using namespace hg::rn;
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 namespace {
@@ -71,6 +74,104 @@ protected:
     std::unique_ptr<RN_ServerInterface> _server;
     std::unique_ptr<RN_ClientInterface> _client;
 
+    //! Clients created by `_connectClients()` (in addition to `_client`).
+    std::vector<std::unique_ptr<RN_ClientInterface>> _clients;
+
+    //! Sum of the telemetry returned by the updates of `_server` and `_client` in `_updateAll()`.
+    RN_Telemetry _serverTelemetry;
+    RN_Telemetry _clientTelemetry;
+
+    //! How long `_updateAll()` waits after the Receive and after the Send updates.
+    std::chrono::milliseconds _updatePause{2};
+
+    //! Replaces `_server` with a new (not yet started) server with room for `aSize` clients.
+    void _recreateServer(hg::PZInteger      aSize,
+                         RN_NetworkingStack aNetworkingStack = RN_NetworkingStack::Default) {
+        _server->removeEventListener(&_eventListenerServer);
+        _server = RN_ServerFactory::createServer(RN_Protocol::UDP,
+                                                 PASS,
+                                                 aSize,
+                                                 MAX_PACKET_SIZE,
+                                                 aNetworkingStack);
+        _server->addEventListener(&_eventListenerServer);
+    }
+
+    //! Starts `_server` and connects `_client` to it over the loopback interface.
+    //! Returns whether both sides got connected.
+    bool _connectClient() {
+        _server->start(0);
+        _client->connect(0, sf::IpAddress::LocalHost, _server->getLocalPort());
+        return _pumpUntil(
+            [this]() {
+                return _client->getServerConnector().isConnected() &&
+                       _server->getClientConnector(0).isConnected();
+            },
+            100);
+    }
+
+    //! Starts `_server` and connects `aCount` new clients (added to `_clients`) to it over the
+    //! loopback interface. If given, `aPrepareClient` is called with each client (and its
+    //! position in `_clients`) before it connects. Returns whether all of them got connected.
+    bool _connectClients(
+        hg::PZInteger                                                aCount,
+        RN_NetworkingStack                                           aNetworkingStack,
+        const std::function<void(RN_ClientInterface&, hg::PZInteger)>& aPrepareClient = {}) {
+        _server->start(0);
+        for (hg::PZInteger i = 0; i < aCount; i += 1) {
+            _clients.push_back(RN_ClientFactory::createClient(RN_Protocol::UDP,
+                                                              PASS,
+                                                              MAX_PACKET_SIZE,
+                                                              aNetworkingStack));
+            if (aPrepareClient) {
+                aPrepareClient(*_clients.back(), i);
+            }
+            _clients.back()->connect(0, sf::IpAddress::LocalHost, _server->getLocalPort());
+        }
+        return _pumpUntil([this]() { return _allClientsConnected(); }, 200);
+    }
+
+    //! Returns whether all clients in `_clients` are connected (on both sides).
+    bool _allClientsConnected() const {
+        for (const auto& client : _clients) {
+            if (!client->getServerConnector().isConnected() ||
+                !_server->getClientConnector(client->getClientIndex()).isConnected()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! Updates all nodes: first all of them receive, and then (after a short pause) all of
+    //! them send.
+    void _updateAll() {
+        _serverTelemetry += _server->update(RN_UpdateMode::Receive);
+        _clientTelemetry += _client->update(RN_UpdateMode::Receive);
+        for (auto& client : _clients) {
+            client->update(RN_UpdateMode::Receive);
+        }
+        std::this_thread::sleep_for(_updatePause);
+
+        _serverTelemetry += _server->update(RN_UpdateMode::Send);
+        _clientTelemetry += _client->update(RN_UpdateMode::Send);
+        for (auto& client : _clients) {
+            client->update(RN_UpdateMode::Send);
+        }
+        std::this_thread::sleep_for(_updatePause);
+    }
+
+    //! Calls `_updateAll()` until `aPredicate` returns true, at most `aMaxUpdateCount` times.
+    //! Returns the last result of the predicate.
+    template <class taPredicate>
+    bool _pumpUntil(const taPredicate& aPredicate, int aMaxUpdateCount) {
+        for (int i = 0; i < aMaxUpdateCount; i += 1) {
+            if (aPredicate()) {
+                return true;
+            }
+            _updateAll();
+        }
+        return aPredicate();
+    }
+
     const EventCount& _getEventCount(const RN_NodeInterface& aNode) const {
         if (&aNode == _server.get()) {
             return _eventCountServer;
@@ -294,3 +395,842 @@ INSTANTIATE_TEST_SUITE_P(RigelNetFragmentedPacketsTest,
                          ::testing::Range(/* start (included) */ -100,
                                           /* end (not included)*/ 101,
                                           /* step */ 1));
+
+RN_DEFINE_RPC_P(AppendNumber, RNTest_, RN_ARGS(int, number)) {
+    RN_NODE_IN_HANDLER().callIfServer([](RN_ServerInterface& /*server*/) {
+        throw RN_IllegalMessage{};
+    });
+
+    RN_NODE_IN_HANDLER().callIfClient([&](RN_ClientInterface& client) {
+        client.getUserDataOrThrow<std::vector<int>>()->push_back(number);
+    });
+}
+
+// MARK: I/O thread
+
+TEST_F(RigelNetTest, MessagesAreDeliveredWithIoThreadsEnabled) {
+    constexpr int MESSAGE_COUNT = 300;
+
+    std::vector<int> receivedNumbers;
+    _client->setUserData(&receivedNumbers);
+
+    _server->setIoThreadEnabled(true);
+    _client->setIoThreadEnabled(true);
+    ASSERT_TRUE(_server->isIoThreadEnabled());
+    ASSERT_TRUE(_client->isIoThreadEnabled());
+
+    ASSERT_TRUE(_connectClient());
+
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, 0, i);
+        if (i == MESSAGE_COUNT / 2) {
+            // Switching the I/O thread off (and on) mid-session must not lose anything
+            _updateAll();
+            _server->setIoThreadEnabled(false);
+            _client->setIoThreadEnabled(false);
+            _updateAll();
+            _client->setIoThreadEnabled(true);
+        }
+    }
+
+    _pumpUntil([&]() { return receivedNumbers.size() >= MESSAGE_COUNT; }, 200);
+
+    ASSERT_EQ(receivedNumbers.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(receivedNumbers[hg::pztos(i)], i);
+    }
+
+    _client->disconnect(true);
+    EXPECT_TRUE(_pumpUntil([&]() { return _server->getClientConnector(0).isDisconnected(); }, 100));
+}
+
+// MARK: Native batched sockets
+
+#ifdef __linux__
+class RigelNetNativeBatchedTest : public RigelNetTest {};
+
+TEST_F(RigelNetNativeBatchedTest, ClientsConnectAndReceiveMessages) {
+    constexpr hg::PZInteger SERVER_SIZE   = 3;
+    constexpr int           MESSAGE_COUNT = 500;
+
+    _recreateServer(SERVER_SIZE, RN_NetworkingStack::NativeBatched);
+    ASSERT_EQ(_server->getNetworkingStack(), RN_NetworkingStack::NativeBatched);
+
+    std::vector<std::vector<int>> receivedNumbers(SERVER_SIZE);
+    ASSERT_TRUE(_connectClients(SERVER_SIZE,
+                                RN_NetworkingStack::NativeBatched,
+                                [&](RN_ClientInterface& aClient, hg::PZInteger aIndex) {
+                                    aClient.setUserData(&receivedNumbers[hg::pztos(aIndex)]);
+                                }));
+
+    // Many more packets than fit into a single batch
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, RN_COMPOSE_FOR_ALL, i);
+    }
+
+    _pumpUntil(
+        [&]() {
+            return std::all_of(receivedNumbers.begin(), receivedNumbers.end(), [](const auto& aNumbers) {
+                return aNumbers.size() >= MESSAGE_COUNT;
+            });
+        },
+        200);
+
+    for (const auto& numbers : receivedNumbers) {
+        ASSERT_EQ(numbers.size(), MESSAGE_COUNT);
+        for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+            ASSERT_EQ(numbers[hg::pztos(i)], i);
+        }
+    }
+
+    for (auto& client : _clients) {
+        client->disconnect(true);
+    }
+
+    const auto allDisconnected = [&]() {
+        for (hg::PZInteger i = 0; i < SERVER_SIZE; i += 1) {
+            if (!_server->getClientConnector(i).isDisconnected()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    EXPECT_TRUE(_pumpUntil(allDisconnected, 100));
+}
+#endif // __linux__
+
+// MARK: Stress test
+
+namespace {
+struct StressTestServerState {
+    std::vector<std::vector<int>> receivedNumbers; //!< Per client index
+    int                           misroutedCount = 0;
+};
+} // namespace
+
+RN_DEFINE_RPC_P(StressTestMessage, RNTest_, RN_ARGS(std::uint16_t, senderPort, int, number)) {
+    RN_NODE_IN_HANDLER().callIfServer([&](RN_ServerInterface& server) {
+        auto&      state       = *server.getUserDataOrThrow<StressTestServerState>();
+        const auto senderIndex = server.getSenderIndex();
+        if (server.getClientConnector(senderIndex).getRemoteInfo().port != senderPort) {
+            state.misroutedCount += 1;
+            return;
+        }
+        state.receivedNumbers[hg::pztos(senderIndex)].push_back(number);
+    });
+
+    RN_NODE_IN_HANDLER().callIfClient([](RN_ClientInterface& /*client*/) {
+        throw RN_IllegalMessage{};
+    });
+}
+
+//! Many clients send messages to a full server while many more remotes, unknown to the
+//! server, flood it with junk datagrams, so that the server has to route thousands of
+//! datagrams per update. Every message must end up with the connector of its sender.
+//! (The server is full so junk only ever goes through the lookup and gets dropped.)
+class RigelNetStressTest : public RigelNetTest {};
+
+TEST_F(RigelNetStressTest, ManyRemotesAndThousandsOfPacketsPerUpdate) {
+    constexpr hg::PZInteger CLIENT_COUNT            = 24;
+    constexpr int           SPAMMER_COUNT           = 32;
+    constexpr int           SPAM_PER_SPAMMER_UPDATE = 64;
+    constexpr int           MESSAGES_PER_UPDATE     = 20;
+    constexpr int           UPDATES_WITH_MESSAGES   = 10;
+    constexpr int           MESSAGE_COUNT           = MESSAGES_PER_UPDATE * UPDATES_WITH_MESSAGES;
+
+    _recreateServer(CLIENT_COUNT);
+    StressTestServerState serverState;
+    serverState.receivedNumbers.resize(hg::pztos(CLIENT_COUNT));
+    _server->setUserData(&serverState);
+
+    ASSERT_TRUE(_connectClients(CLIENT_COUNT, RN_NetworkingStack::Default));
+
+    std::vector<std::unique_ptr<sf::UdpSocket>> spammers;
+    for (int i = 0; i < SPAMMER_COUNT; i += 1) {
+        spammers.push_back(std::make_unique<sf::UdpSocket>());
+        ASSERT_EQ(spammers.back()->bind(sf::Socket::AnyPort), sf::Socket::Done);
+        spammers.back()->setBlocking(false);
+    }
+
+    const auto spamAndUpdate = [&]() {
+        const std::uint32_t junk[] = {0xDEADBEEF, 0xDEADBEEF, 0xDEADBEEF, 0xDEADBEEF};
+        for (int i = 0; i < SPAM_PER_SPAMMER_UPDATE; i += 1) {
+            for (auto& spammer : spammers) {
+                (void)spammer->send(junk,
+                                    sizeof(junk),
+                                    sf::IpAddress::LocalHost,
+                                    _server->getLocalPort());
+            }
+        }
+        _updateAll();
+    };
+
+    for (int update = 0; update < UPDATES_WITH_MESSAGES; update += 1) {
+        for (auto& client : _clients) {
+            for (int i = 0; i < MESSAGES_PER_UPDATE; i += 1) {
+                RNTest_Compose_StressTestMessage(*client,
+                                                 RN_COMPOSE_FOR_ALL,
+                                                 client->getLocalPort(),
+                                                 update * MESSAGES_PER_UPDATE + i);
+            }
+        }
+        spamAndUpdate();
+    }
+
+    const auto allReceived = [&]() {
+        for (const auto& numbers : serverState.receivedNumbers) {
+            if (numbers.size() < MESSAGE_COUNT) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (int i = 0; i < 500 && !allReceived(); i += 1) {
+        spamAndUpdate();
+    }
+
+    EXPECT_TRUE(_allClientsConnected());
+    EXPECT_EQ(serverState.misroutedCount, 0);
+    for (const auto& numbers : serverState.receivedNumbers) {
+        ASSERT_EQ(numbers.size(), MESSAGE_COUNT);
+        for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+            ASSERT_EQ(numbers[hg::pztos(i)], i);
+        }
+    }
+}
+
+// MARK: Shared broadcast payloads
+
+RN_DEFINE_RPC_P(AppendBytes, RNTest_, RN_ARGS(RN_RawDataView, bytes)) {
+    RN_NODE_IN_HANDLER().callIfServer([](RN_ServerInterface& /*server*/) {
+        throw RN_IllegalMessage{};
+    });
+
+    RN_NODE_IN_HANDLER().callIfClient([&](RN_ClientInterface& client) {
+        auto&       vec  = *client.getUserDataOrThrow<std::vector<std::uint8_t>>();
+        const auto* data = static_cast<const std::uint8_t*>(bytes.getData());
+        vec.insert(vec.end(), data, data + bytes.getDataSize());
+    });
+}
+
+//! Parameters: networking stack, and whether I/O threads are enabled.
+class RigelNetSharedPayloadTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<std::tuple<RN_NetworkingStack, bool>> {};
+
+//! Broadcasts of all sizes (large ones are queued in the connectors as shared payloads, and
+//! some of them have to be fragmented) interleaved with messages to single clients must reach
+//! every client intact and in order. With the I/O thread, shared payloads are handed over to
+//! it by reference.
+TEST_P(RigelNetSharedPayloadTest, BroadcastsInterleavedWithSingleMessagesArriveIntact) {
+    constexpr hg::PZInteger CLIENT_COUNT  = 4;
+    constexpr int           MESSAGE_COUNT = 120;
+
+    const auto [networkingStack, ioThreadEnabled] = GetParam();
+
+    _recreateServer(CLIENT_COUNT, networkingStack);
+    _server->setIoThreadEnabled(ioThreadEnabled);
+
+    std::vector<std::vector<std::uint8_t>> receivedBytes(CLIENT_COUNT);
+    ASSERT_TRUE(_connectClients(CLIENT_COUNT,
+                                networkingStack,
+                                [&](RN_ClientInterface& aClient, hg::PZInteger aIndex) {
+                                    aClient.setIoThreadEnabled(ioThreadEnabled);
+                                    aClient.setUserData(&receivedBytes[hg::pztos(aIndex)]);
+                                }));
+
+    // (Indexed by the clients' indices on the server)
+    std::vector<std::vector<std::uint8_t>> expectedBytes(CLIENT_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        std::vector<std::uint8_t> message(hg::pztos(1 + (i * 97) % 700));
+        for (std::size_t j = 0; j < message.size(); j += 1) {
+            message[j] = static_cast<std::uint8_t>(i + j);
+        }
+
+        if (i % 3 == 2) {
+            const hg::PZInteger receiver = i % CLIENT_COUNT;
+            RNTest_Compose_AppendBytes(*_server,
+                                       receiver,
+                                       RN_RawDataView(message.data(), message.size()));
+            auto& expected = expectedBytes[hg::pztos(receiver)];
+            expected.insert(expected.end(), message.begin(), message.end());
+        } else {
+            RNTest_Compose_AppendBytes(*_server,
+                                       RN_COMPOSE_FOR_ALL,
+                                       RN_RawDataView(message.data(), message.size()));
+            for (auto& expected : expectedBytes) {
+                expected.insert(expected.end(), message.begin(), message.end());
+            }
+        }
+
+        if (i % 10 == 9) {
+            _updateAll();
+        }
+    }
+
+    const auto getExpectedBytes = [&](hg::PZInteger aPosition) -> const std::vector<std::uint8_t>& {
+        return expectedBytes[hg::pztos(_clients[hg::pztos(aPosition)]->getClientIndex())];
+    };
+
+    _pumpUntil(
+        [&]() {
+            for (hg::PZInteger i = 0; i < CLIENT_COUNT; i += 1) {
+                if (receivedBytes[hg::pztos(i)].size() < getExpectedBytes(i).size()) {
+                    return false;
+                }
+            }
+            return true;
+        },
+        300);
+
+    for (hg::PZInteger i = 0; i < CLIENT_COUNT; i += 1) {
+        SCOPED_TRACE("client = " + std::to_string(i));
+        EXPECT_EQ(receivedBytes[hg::pztos(i)], getExpectedBytes(i));
+    }
+}
+
+#ifdef __linux__
+INSTANTIATE_TEST_SUITE_P(RigelNetSharedPayloadTest,
+                         RigelNetSharedPayloadTest,
+                         ::testing::Combine(::testing::Values(RN_NetworkingStack::Default,
+                                                              RN_NetworkingStack::NativeBatched),
+                                            ::testing::Bool()));
+#else
+INSTANTIATE_TEST_SUITE_P(RigelNetSharedPayloadTest,
+                         RigelNetSharedPayloadTest,
+                         ::testing::Combine(::testing::Values(RN_NetworkingStack::Default),
+                                            ::testing::Bool()));
+#endif
+
+// MARK: Compact acks
+
+RN_DEFINE_RPC_P(AppendNumberOnServer, RNTest_, RN_ARGS(int, number)) {
+    RN_NODE_IN_HANDLER().callIfServer([&](RN_ServerInterface& server) {
+        server.getUserDataOrThrow<std::vector<int>>()->push_back(number);
+    });
+
+    RN_NODE_IN_HANDLER().callIfClient([](RN_ClientInterface& /*client*/) {
+        throw RN_IllegalMessage{};
+    });
+}
+
+//! Param: whether compact acks are enabled on the server and on the client.
+class RigelNetCompactAcksTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<std::tuple<bool, bool>> {};
+
+TEST_P(RigelNetCompactAcksTest, EncodingIsNegotiatedAndMessagesAreDelivered) {
+    constexpr int MESSAGE_COUNT = 400;
+
+    const auto [serverEnabled, clientEnabled] = GetParam();
+
+    ASSERT_TRUE(_server->isCompactAcksEnabled()); // Enabled by default
+    ASSERT_TRUE(_client->isCompactAcksEnabled());
+    _server->setCompactAcksEnabled(serverEnabled);
+    _client->setCompactAcksEnabled(clientEnabled);
+
+    std::vector<int> numbersOnServer;
+    std::vector<int> numbersOnClient;
+    _server->setUserData(&numbersOnServer);
+    _client->setUserData(&numbersOnClient);
+
+    ASSERT_TRUE(_connectClient());
+
+    const bool expectCompactAcks = serverEnabled && clientEnabled;
+    EXPECT_EQ(_server->getClientConnector(0).isUsingCompactAcks(), expectCompactAcks);
+    EXPECT_EQ(_client->getServerConnector().isUsingCompactAcks(), expectCompactAcks);
+
+    // Many packets in flight in both directions, so that plenty of acks are exchanged
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, 0, i);
+        RNTest_Compose_AppendNumberOnServer(*_client, 0, i);
+        if (i % 20 == 19) {
+            _updateAll();
+        }
+    }
+
+    _pumpUntil(
+        [&]() {
+            return numbersOnServer.size() >= MESSAGE_COUNT &&
+                   numbersOnClient.size() >= MESSAGE_COUNT;
+        },
+        200);
+
+    ASSERT_EQ(numbersOnServer.size(), MESSAGE_COUNT);
+    ASSERT_EQ(numbersOnClient.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(numbersOnServer[hg::pztos(i)], i);
+        ASSERT_EQ(numbersOnClient[hg::pztos(i)], i);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RigelNetCompactAcksTest,
+                         RigelNetCompactAcksTest,
+                         ::testing::Combine(::testing::Bool(), ::testing::Bool()));
+
+// MARK: Congestion control
+
+class RigelNetCongestionControlTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<RN_CongestionControl> {};
+
+TEST_P(RigelNetCongestionControlTest, WindowIsRespectedAndMessagesAreDelivered) {
+    constexpr int MESSAGE_COUNT = 3000;
+
+    const auto algorithm = GetParam();
+
+    ASSERT_EQ(_server->getCongestionControl(), RN_CongestionControl::None); // Default
+    _server->setCongestionControl(algorithm);
+    _client->setCongestionControl(algorithm);
+    ASSERT_EQ(_server->getCongestionControl(), algorithm);
+
+    std::vector<int> numbersOnClient;
+    _client->setUserData(&numbersOnClient);
+
+    _updatePause = std::chrono::milliseconds{1};
+    ASSERT_TRUE(_connectClient());
+
+    // Far more data than fits into the initial window at once
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, 0, i);
+    }
+
+    // The window is checked before each new packet is sent, so it can be exceeded by at most
+    // one packet
+    const auto windowIsRespected = [&]() {
+        const auto state = _server->getClientConnector(0).getCongestionControlState();
+        return algorithm == RN_CongestionControl::None ||
+               state.bytesInFlight <= state.congestionWindow + MAX_PACKET_SIZE + 8;
+    };
+    _pumpUntil(
+        [&]() {
+            EXPECT_TRUE(windowIsRespected());
+            return numbersOnClient.size() >= MESSAGE_COUNT;
+        },
+        2000);
+
+    ASSERT_EQ(numbersOnClient.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(numbersOnClient[hg::pztos(i)], i);
+    }
+
+    const auto state = _server->getClientConnector(0).getCongestionControlState();
+    EXPECT_EQ(state.algorithm, algorithm);
+    EXPECT_GE(state.smoothedRtt.count(), 0);
+    EXPECT_GE(state.rttVariance.count(), 0);
+    EXPECT_LE(_serverTelemetry.retransmittedByteCount, _serverTelemetry.uploadByteCount);
+    if (algorithm == RN_CongestionControl::None) {
+        EXPECT_EQ(state.congestionWindow, 0);
+        EXPECT_EQ(state.pacingRate, 0);
+    } else {
+        EXPECT_GE(state.congestionWindow, 2 * MAX_PACKET_SIZE);
+        EXPECT_GT(state.pacingRate, 0);
+        EXPECT_GE(state.retransmitTimeout, std::chrono::milliseconds{10});
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RigelNetCongestionControlTest,
+                         RigelNetCongestionControlTest,
+                         ::testing::Values(RN_CongestionControl::None,
+                                           RN_CongestionControl::LossBased,
+                                           RN_CongestionControl::DelayBased));
+
+// MARK: Delivery modes
+
+class RigelNetDeliveryModeTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<RN_DeliveryMode> {};
+
+TEST_P(RigelNetDeliveryModeTest, MessagesAreDeliveredAccordingToMode) {
+    constexpr int MESSAGE_COUNT = 400;
+
+    const auto mode = GetParam();
+
+    std::vector<int> numbersOnServer;
+    std::vector<int> numbersOnClient;
+    _server->setUserData(&numbersOnServer);
+    _client->setUserData(&numbersOnClient);
+
+    ASSERT_TRUE(_connectClient());
+
+    // Regular messages are mixed in, and must stay intact and in order regardless
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, {0}, mode, i);
+        RNTest_Compose_AppendNumberOnServer(*_client, 0, mode, i);
+        RNTest_Compose_AppendNumberOnServer(*_client, 0, MESSAGE_COUNT + i);
+        if (i % 20 == 19) {
+            _updateAll();
+        }
+    }
+
+    _pumpUntil(
+        [&]() {
+            return numbersOnServer.size() >= 2 * MESSAGE_COUNT &&
+                   numbersOnClient.size() >= MESSAGE_COUNT;
+        },
+        200);
+
+    std::vector<int> regularNumbers;
+    std::vector<int> numbersInMode;
+    for (const int number : numbersOnServer) {
+        (number >= MESSAGE_COUNT ? regularNumbers : numbersInMode).push_back(number);
+    }
+    ASSERT_EQ(regularNumbers.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(regularNumbers[hg::pztos(i)], MESSAGE_COUNT + i);
+    }
+
+    for (const auto* numbers : {&numbersInMode, &numbersOnClient}) {
+        switch (mode) {
+        case RN_DeliveryMode::ReliableOrdered:
+            ASSERT_EQ(numbers->size(), MESSAGE_COUNT);
+            for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+                ASSERT_EQ((*numbers)[hg::pztos(i)], i);
+            }
+            break;
+
+        case RN_DeliveryMode::ReliableUnordered:
+            {
+                ASSERT_EQ(numbers->size(), MESSAGE_COUNT);
+                auto sorted = *numbers;
+                std::sort(sorted.begin(), sorted.end());
+                for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+                    ASSERT_EQ(sorted[hg::pztos(i)], i);
+                }
+            }
+            break;
+
+        case RN_DeliveryMode::Unreliable:
+            // Can be lost (but hardly all of them over loopback), but never duplicated
+            {
+                ASSERT_FALSE(numbers->empty());
+                ASSERT_LE(numbers->size(), MESSAGE_COUNT);
+                auto sorted = *numbers;
+                std::sort(sorted.begin(), sorted.end());
+                EXPECT_EQ(std::adjacent_find(sorted.begin(), sorted.end()), sorted.end());
+            }
+            break;
+
+        case RN_DeliveryMode::UnreliableSequenced:
+            // Stale messages are dropped, so the ones that arrive are always newer
+            ASSERT_FALSE(numbers->empty());
+            ASSERT_LE(numbers->size(), MESSAGE_COUNT);
+            for (std::size_t i = 1; i < numbers->size(); i += 1) {
+                ASSERT_LT((*numbers)[i - 1], (*numbers)[i]);
+            }
+            break;
+
+        default:
+            FAIL();
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RigelNetDeliveryModeTest,
+                         RigelNetDeliveryModeTest,
+                         ::testing::Values(RN_DeliveryMode::ReliableOrdered,
+                                           RN_DeliveryMode::ReliableUnordered,
+                                           RN_DeliveryMode::Unreliable,
+                                           RN_DeliveryMode::UnreliableSequenced));
+
+// MARK: Streams
+
+//! Param: whether the server composes its messages for all clients (shared payloads).
+class RigelNetStreamsTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<bool> {};
+
+TEST_P(RigelNetStreamsTest, MessagesAreDeliveredInOrderWithinEachStream) {
+    constexpr int MESSAGE_COUNT = 200;
+    constexpr int STREAMS[]     = {0, 1, 7, RN_STREAM_COUNT - 1};
+
+    const bool forAll = GetParam();
+
+    std::vector<int> numbersOnServer;
+    std::vector<int> numbersOnClient;
+    _server->setUserData(&numbersOnServer);
+    _client->setUserData(&numbersOnClient);
+
+    ASSERT_TRUE(_connectClient());
+
+    EXPECT_THROW(RNTest_Compose_AppendNumber(*_server, {0}, RN_Stream{RN_STREAM_COUNT}, 0),
+                 hg::InvalidArgumentError);
+    EXPECT_THROW(RNTest_Compose_AppendNumberOnServer(*_client, 0, RN_Stream{-1}, 0),
+                 hg::InvalidArgumentError);
+
+    // Each number says which stream it was composed in (number / MESSAGE_COUNT)
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        for (const int stream : STREAMS) {
+            const int number = stream * MESSAGE_COUNT + i;
+            if (forAll) {
+                RNTest_Compose_AppendNumber(*_server, RN_COMPOSE_FOR_ALL, RN_Stream{stream}, number);
+            } else {
+                RNTest_Compose_AppendNumber(*_server, {0}, RN_Stream{stream}, number);
+            }
+            RNTest_Compose_AppendNumberOnServer(*_client, 0, RN_Stream{stream}, number);
+        }
+        if (i % 20 == 19) {
+            _updateAll();
+        }
+    }
+
+    constexpr auto TOTAL_COUNT = std::size(STREAMS) * MESSAGE_COUNT;
+    _pumpUntil(
+        [&]() {
+            return numbersOnServer.size() >= TOTAL_COUNT &&
+                   numbersOnClient.size() >= TOTAL_COUNT;
+        },
+        200);
+
+    for (const auto* numbers : {&numbersOnServer, &numbersOnClient}) {
+        ASSERT_EQ(numbers->size(), TOTAL_COUNT);
+        for (const int stream : STREAMS) {
+            std::vector<int> numbersInStream;
+            for (const int number : *numbers) {
+                if (number / MESSAGE_COUNT == stream) {
+                    numbersInStream.push_back(number);
+                }
+            }
+            ASSERT_EQ(numbersInStream.size(), MESSAGE_COUNT);
+            for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+                ASSERT_EQ(numbersInStream[hg::pztos(i)], stream * MESSAGE_COUNT + i);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RigelNetStreamsTest, RigelNetStreamsTest, ::testing::Values(false, true));
+
+// MARK: Compression
+
+namespace {
+//! Returns compression settings for the test: -1 means disabled, 0 means enabled without a
+//! dictionary, and other values mean enabled with one of two different dictionaries.
+RN_CompressionSettings MakeCompressionSettings(int aVariant) {
+    RN_CompressionSettings settings;
+    settings.enabled             = (aVariant >= 0);
+    settings.minPayloadByteCount = 32;
+    if (aVariant > 0) {
+        auto dictionary = std::make_shared<std::vector<std::uint8_t>>();
+        for (int i = 0; i < 1000; i += 1) {
+            dictionary->push_back(static_cast<std::uint8_t>((i * aVariant) % 7));
+        }
+        settings.dictionary = std::move(dictionary);
+    }
+    return settings;
+}
+} // namespace
+
+//! Param: compression settings of the server and of the client (see `MakeCompressionSettings()`).
+class RigelNetCompressionTest
+    : public RigelNetTest
+    , public ::testing::WithParamInterface<std::tuple<int, int>> {};
+
+TEST_P(RigelNetCompressionTest, CompressionIsNegotiatedAndMessagesArriveIntact) {
+    constexpr int MESSAGE_COUNT = 200;
+
+    const auto [serverVariant, clientVariant] = GetParam();
+    const bool expectCompression = (serverVariant >= 0 && serverVariant == clientVariant);
+
+    ASSERT_FALSE(_server->getCompression().enabled); // Disabled by default
+    ASSERT_FALSE(_client->getCompression().enabled);
+    _server->setCompression(MakeCompressionSettings(serverVariant));
+    _client->setCompression(MakeCompressionSettings(clientVariant));
+
+    std::vector<std::uint8_t> bytesOnClient;
+    std::vector<int>          numbersOnServer;
+    _client->setUserData(&bytesOnClient);
+    _server->setUserData(&numbersOnServer);
+
+    ASSERT_TRUE(_connectClient());
+    EXPECT_EQ(_server->getClientConnector(0).isUsingCompression(), expectCompression);
+    EXPECT_EQ(_client->getServerConnector().isUsingCompression(), expectCompression);
+
+    // Repetitive messages (like state updates) of all sizes - some of them are fragmented
+    std::vector<std::uint8_t> expectedBytes;
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        std::vector<std::uint8_t> message(hg::pztos(1 + (i * 37) % 500));
+        for (std::size_t j = 0; j < message.size(); j += 1) {
+            message[j] = static_cast<std::uint8_t>((j % 16 == 0) ? i : (j % 7));
+        }
+        RNTest_Compose_AppendBytes(*_server, 0, RN_RawDataView(message.data(), message.size()));
+        expectedBytes.insert(expectedBytes.end(), message.begin(), message.end());
+
+        RNTest_Compose_AppendNumberOnServer(*_client, 0, i);
+
+        if (i % 10 == 9) {
+            _updateAll();
+        }
+    }
+
+    _pumpUntil(
+        [&]() {
+            return bytesOnClient.size() >= expectedBytes.size() &&
+                   numbersOnServer.size() >= MESSAGE_COUNT;
+        },
+        200);
+
+    ASSERT_EQ(bytesOnClient, expectedBytes);
+    ASSERT_EQ(numbersOnServer.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(numbersOnServer[hg::pztos(i)], i);
+    }
+
+    for (const auto* telemetry : {&_serverTelemetry, &_clientTelemetry}) {
+        if (expectCompression) {
+            EXPECT_GT(telemetry->uncompressedPayloadByteCount, 0);
+            EXPECT_LT(telemetry->compressedPayloadByteCount, telemetry->uncompressedPayloadByteCount);
+        } else {
+            EXPECT_EQ(telemetry->uncompressedPayloadByteCount, 0);
+            EXPECT_EQ(telemetry->compressedPayloadByteCount, 0);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(RigelNetCompressionTest,
+                         RigelNetCompressionTest,
+                         ::testing::Values(std::make_tuple(-1, -1),
+                                           std::make_tuple(0, 0),
+                                           std::make_tuple(1, 1),
+                                           std::make_tuple(1, 2),
+                                           std::make_tuple(0, 1),
+                                           std::make_tuple(0, -1),
+                                           std::make_tuple(-1, 0)));
+
+TEST_F(RigelNetTest, CompressionRejectsTooSmallMinimalPayloadSize) {
+    // The original size of a compressed payload takes 4 bytes, so smaller payloads can't shrink
+    auto settings                = MakeCompressionSettings(0);
+    settings.minPayloadByteCount = 4;
+    EXPECT_THROW(_server->setCompression(settings), hg::InvalidArgumentError);
+    EXPECT_THROW(_client->setCompression(settings), hg::InvalidArgumentError);
+    EXPECT_FALSE(_server->getCompression().enabled);
+
+    settings.minPayloadByteCount = 5;
+    _server->setCompression(settings);
+    EXPECT_TRUE(_server->getCompression().enabled);
+}
+
+// MARK: Retransmission
+
+TEST_F(RigelNetTest, OnlyPacketsWhichCouldBeDueAreCheckedForRetransmission) {
+    constexpr int MESSAGE_COUNT = 200;
+
+    int  predicateCallCount = 0;
+    bool isRetransmitDue    = false;
+    _server->setRetransmitPredicate(
+        [&](hg::PZInteger, std::chrono::microseconds, std::chrono::microseconds) {
+            predicateCallCount += 1;
+            return isRetransmitDue;
+        });
+
+    std::vector<int> numbersOnClient;
+    _client->setUserData(&numbersOnClient);
+
+    _updatePause = std::chrono::milliseconds{1};
+    ASSERT_TRUE(_connectClient());
+
+    // The client doesn't receive anything for now, so every message stays in its own
+    // unacknowledged packet - but as the oldest one isn't due, none of the others are checked
+    predicateCallCount = 0;
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        RNTest_Compose_AppendNumber(*_server, 0, i);
+        _server->update(RN_UpdateMode::Send);
+    }
+    EXPECT_LE(predicateCallCount, MESSAGE_COUNT);
+    EXPECT_GE(_server->getClientConnector(0).getSendBufferSize(), MESSAGE_COUNT);
+
+    isRetransmitDue = true;
+    _pumpUntil([&]() { return numbersOnClient.size() >= MESSAGE_COUNT; }, 200);
+
+    ASSERT_EQ(numbersOnClient.size(), MESSAGE_COUNT);
+    for (int i = 0; i < MESSAGE_COUNT; i += 1) {
+        ASSERT_EQ(numbersOnClient[hg::pztos(i)], i);
+    }
+    EXPECT_GT(_serverTelemetry.retransmittedByteCount, 0);
+}
+
+// MARK: Telemetry
+
+TEST_F(RigelNetTest, ConnectorTelemetryIsCollectedAndAggregated) {
+    constexpr int BUFFER_COUNT = 20;
+
+    std::vector<std::uint16_t> serverVector;
+    for (int i = 0; i < MAX_PACKET_SIZE * 2; i += 1) {
+        serverVector.push_back(static_cast<std::uint16_t>(i));
+    }
+
+    std::vector<std::uint16_t> clientVector;
+    _client->setUserData(&clientVector);
+
+    _updatePause = std::chrono::milliseconds{1};
+    ASSERT_TRUE(_connectClient());
+
+    // Every buffer is 4x the max packet size, so it has to be fragmented
+    for (int i = 0; i < BUFFER_COUNT; i += 1) {
+        RNTest_Compose_SendBinaryBuffer(
+            *_server,
+            RN_COMPOSE_FOR_ALL,
+            RN_RawDataView(serverVector.data(), serverVector.size() * sizeof(std::uint16_t)));
+        _updateAll();
+    }
+    const auto allReceived = [&]() {
+        return _client->getServerConnector().getTelemetry().reassembledPacketCount == BUFFER_COUNT;
+    };
+    ASSERT_TRUE(_pumpUntil(allReceived, 100));
+    ASSERT_EQ(clientVector, serverVector);
+    for (int i = 0; i < 10; i += 1) {
+        _updateAll(); // Let the acks arrive
+    }
+
+    const auto serverSide = _server->getClientConnector(0).getTelemetry();
+    const auto clientSide = _client->getServerConnector().getTelemetry();
+
+    EXPECT_GT(serverSide.windowDuration, std::chrono::microseconds{0});
+
+    // Every data packet which the server sent was eventually acknowledged
+    ASSERT_GT(serverSide.rttSampleCount, 0);
+    std::int64_t histogramTotal = 0;
+    for (const auto count : serverSide.rttHistogram) {
+        histogramTotal += count;
+    }
+    EXPECT_EQ(histogramTotal, serverSide.rttSampleCount);
+    EXPECT_LE(serverSide.rttMin, serverSide.getRttMean());
+    EXPECT_GE(serverSide.rttMax, serverSide.getRttMean());
+    EXPECT_GE(serverSide.getRttVariance(), 0.0);
+
+    const auto p50 = serverSide.getRttPercentile(50.0);
+    const auto p99 = serverSide.getRttPercentile(99.0);
+    EXPECT_LE(serverSide.rttMin, p50);
+    EXPECT_LE(p50, p99);
+    EXPECT_LE(p99, serverSide.rttMax);
+    EXPECT_EQ(serverSide.getRttPercentile(100.0), serverSide.rttMax);
+
+    EXPECT_GE(serverSide.sentPacketCount, BUFFER_COUNT * 4);
+    EXPECT_GT(serverSide.payloadByteCount,
+              static_cast<std::int64_t>(BUFFER_COUNT * serverVector.size() * sizeof(std::uint16_t)));
+    EXPECT_LT(serverSide.payloadByteCount, serverSide.uploadByteCount);
+    EXPECT_GT(serverSide.receivedPacketCount, 0);
+
+    EXPECT_GE(clientSide.receivedPacketCount, BUFFER_COUNT * 4);
+    EXPECT_GT(clientSide.ackByteCount, 0);
+    EXPECT_LE(clientSide.ackByteCount, clientSide.uploadByteCount);
+    EXPECT_EQ(clientSide.reassembledPacketCount, BUFFER_COUNT);
+    EXPECT_GE(clientSide.reassembledFragmentCount, BUFFER_COUNT * 4);
+    EXPECT_GT(clientSide.maxRecvBufferLength, 0);
+
+    // With a single client, the aggregate is the same as the client's connector's telemetry
+    const auto aggregate = _server->getClientTelemetry();
+    EXPECT_EQ(aggregate.rttSampleCount, serverSide.rttSampleCount);
+    EXPECT_EQ(aggregate.rttHistogram, serverSide.rttHistogram);
+    EXPECT_EQ(aggregate.sentPacketCount, serverSide.sentPacketCount);
+    EXPECT_EQ(aggregate.uploadByteCount, serverSide.uploadByteCount);
+    EXPECT_EQ(aggregate.payloadByteCount, serverSide.payloadByteCount);
+
+    _server->resetClientTelemetry();
+    const auto afterReset = _server->getClientTelemetry();
+    EXPECT_EQ(afterReset.rttSampleCount, 0);
+    EXPECT_EQ(afterReset.sentPacketCount, 0);
+    EXPECT_EQ(afterReset.uploadByteCount, 0);
+    EXPECT_EQ(afterReset.getRttPercentile(50.0), std::chrono::microseconds{0});
+}
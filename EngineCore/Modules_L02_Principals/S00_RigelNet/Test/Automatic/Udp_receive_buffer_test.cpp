@@ -0,0 +1,73 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+#include <gtest/gtest.h>
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Common.hpp>
+#include <Hobgoblin/Utility/Packet.hpp>
+
+#include "Invalid_data_error.hpp"
+#include "Udp_connector_packet_kinds.hpp"
+#include "Udp_receive_buffer.hpp"
+using namespace hg::rn;
+
+#include <cstdint>
+
+namespace {
+//! Makes a DATA packet as it looks after its kind and ordinal were read (stream header, no acks,
+//! and a single value as the payload).
+hg::util::Packet MakeStreamPacket(std::uint16_t aStreamIndex,
+                                  PacketOrdinal aStreamOrdinal,
+                                  std::int32_t  aValue) {
+    hg::util::Packet packet;
+    packet << aStreamIndex << aStreamOrdinal << PacketOrdinal{0} << aValue;
+    return packet;
+}
+} // namespace
+
+class UdpReceiveBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _buffer.reset();
+        _buffer.setStreamsEnabled(true);
+    }
+
+    UdpReceiveBuffer _buffer;
+};
+
+TEST_F(UdpReceiveBufferTest, StreamPacketsWithinWindowAreStored) {
+    // Stream ordinal 1 is missing, so both have to wait for it
+    constexpr auto LAST_ORDINAL = UdpReceiveBuffer::MAX_ORDINALS_AHEAD;
+    _buffer.storeDataPacket(MakeStreamPacket(0, 2, 2), 1, UDP_PACKET_KIND_DATA);
+    _buffer.storeDataPacket(MakeStreamPacket(0, LAST_ORDINAL, 3), 2, UDP_PACKET_KIND_DATA);
+
+    hg::util::Packet packet;
+    EXPECT_FALSE(_buffer.takeNextReadyPacket(&packet));
+
+    _buffer.storeDataPacket(MakeStreamPacket(0, 1, 1), 3, UDP_PACKET_KIND_DATA);
+    ASSERT_TRUE(_buffer.takeNextReadyPacket(&packet));
+    EXPECT_EQ(packet.extract<std::int32_t>(), 1);
+    ASSERT_TRUE(_buffer.takeNextReadyPacket(&packet));
+    EXPECT_EQ(packet.extract<std::int32_t>(), 2);
+    EXPECT_FALSE(_buffer.takeNextReadyPacket(&packet));
+}
+
+TEST_F(UdpReceiveBufferTest, StreamOrdinalTooFarAheadIsInvalidData) {
+    // The stream head is at ordinal 1
+    constexpr auto BAD_ORDINAL = 1 + UdpReceiveBuffer::MAX_ORDINALS_AHEAD;
+    EXPECT_THROW(_buffer.storeDataPacket(MakeStreamPacket(0, BAD_ORDINAL, 0), 1, UDP_PACKET_KIND_DATA),
+                 InvalidDataError);
+    EXPECT_THROW(_buffer.storeDataPacket(MakeStreamPacket(5, 0xFFFFFFFF, 0), 2, UDP_PACKET_KIND_DATA),
+                 InvalidDataError);
+
+    // Nothing was allocated for the ordinals in between
+    EXPECT_LE(_buffer.getLength(), 2);
+}
+
+TEST_F(UdpReceiveBufferTest, PacketOrdinalTooFarAheadIsInvalidData) {
+    constexpr auto BAD_ORDINAL = 1 + UdpReceiveBuffer::MAX_ORDINALS_AHEAD;
+    EXPECT_THROW(_buffer.storeDataPacket(MakeStreamPacket(0, 1, 0), BAD_ORDINAL, UDP_PACKET_KIND_DATA),
+                 InvalidDataError);
+    EXPECT_EQ(_buffer.getLength(), 0);
+}
@@ -0,0 +1,147 @@
+// Copyright 2026 Jovan Batnozic. Released under MS-PL licence in Serbia.
+// See https://github.com/jbatnozic/Hobgoblin?tab=readme-ov-file#licence
+
+// Measures how many bytes a client spends on acknowledgements while a server streams data to it
+// over the loopback interface, with the original (one ordinal per packet) and with the compact
+// (bitmap) ack encoding. The client doesn't send any data of its own, so everything it uploads
+// is acks (in ACKS packets, and in the headers of its otherwise empty DATA packets).
+
+#define HOBGOBLIN_SHORT_NAMESPACE
+#include <Hobgoblin/Logging.hpp>
+#include <Hobgoblin/RigelNet.hpp>
+#include <Hobgoblin/RigelNet_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace hg::rn;
+
+namespace {
+
+constexpr auto LOG_ID = "RigelNet.PerformanceTest";
+
+const std::string       PASS                = "performance";
+constexpr hg::PZInteger MAX_PACKET_SIZE     = 1400;
+constexpr int           UPDATE_COUNT        = 600;
+constexpr int           MESSAGES_PER_UPDATE = 40;
+constexpr int           MESSAGE_BYTE_COUNT  = 256;
+constexpr int           REPETITION_COUNT    = 3;
+
+struct Results {
+    std::int64_t messagesReceived  = 0;
+    std::int64_t serverUploadBytes = 0;
+    std::int64_t clientUploadBytes = 0; //!< All of it is ack overhead
+    bool         usedCompactAcks   = false;
+};
+
+} // namespace
+
+RN_DEFINE_RPC(AckOverheadTestMessage, RN_ARGS(RN_RawDataView, bytes)) {
+    RN_NODE_IN_HANDLER().callIfClient([&](RN_ClientInterface& client) {
+        *client.getUserDataOrThrow<std::int64_t>() += 1;
+    });
+}
+
+namespace {
+
+Results RunBenchmark(bool aCompactAcks) {
+    Results results;
+
+    auto server = RN_ServerFactory::createServer(RN_Protocol::UDP, PASS, 1, MAX_PACKET_SIZE);
+    auto client = RN_ClientFactory::createClient(RN_Protocol::UDP, PASS, MAX_PACKET_SIZE);
+    server->setCompactAcksEnabled(aCompactAcks);
+    client->setCompactAcksEnabled(aCompactAcks);
+    client->setUserData(&results.messagesReceived);
+
+    server->start(0);
+    client->connect(0, sf::IpAddress::LocalHost, server->getLocalPort());
+
+    const auto updateBoth = [&](bool aCount) {
+        const auto serverTelemetry =
+            server->update(RN_UpdateMode::Receive) + server->update(RN_UpdateMode::Send);
+        const auto clientTelemetry =
+            client->update(RN_UpdateMode::Receive) + client->update(RN_UpdateMode::Send);
+        if (aCount) {
+            results.serverUploadBytes += serverTelemetry.uploadByteCount;
+            results.clientUploadBytes += clientTelemetry.uploadByteCount;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    };
+
+    for (int i = 0; i < 1000 && !server->getClientConnector(0).isConnected(); i += 1) {
+        updateBoth(false);
+    }
+    if (!server->getClientConnector(0).isConnected()) {
+        HG_LOG_ERROR(LOG_ID, "Client failed to connect.");
+        return results;
+    }
+    results.usedCompactAcks = client->getServerConnector().isUsingCompactAcks();
+
+    const std::vector<std::uint8_t> message(MESSAGE_BYTE_COUNT, 0x5A);
+    for (int i = 0; i < UPDATE_COUNT; i += 1) {
+        for (int j = 0; j < MESSAGES_PER_UPDATE; j += 1) {
+            Compose_AckOverheadTestMessage(*server,
+                                           RN_COMPOSE_FOR_ALL,
+                                           RN_RawDataView(message.data(), hg::stopz(message.size())));
+        }
+        updateBoth(true);
+    }
+
+    // Let the remaining data (and acks for it) through
+    for (int i = 0; i < 100; i += 1) {
+        updateBoth(true);
+    }
+
+    client->disconnect(true);
+    server->stop();
+
+    return results;
+}
+
+void PrintResults(const char* aName, const Results& aResults) {
+    const auto acksPerMessage =
+        (aResults.messagesReceived > 0)
+            ? static_cast<double>(aResults.clientUploadBytes) / aResults.messagesReceived
+            : 0.0;
+    const auto ackShare =
+        (aResults.serverUploadBytes > 0)
+            ? 100.0 * aResults.clientUploadBytes / aResults.serverUploadBytes
+            : 0.0;
+
+    HG_LOG_INFO(LOG_ID,
+                "{:>12} | negotiated: {:>8} | messages: {:6} | data: {:9} B | acks: {:8} B "
+                "({:5.2f} B per message, {:5.2f}% of data)",
+                aName,
+                aResults.usedCompactAcks ? "compact" : "ordinals",
+                aResults.messagesReceived,
+                aResults.serverUploadBytes,
+                aResults.clientUploadBytes,
+                acksPerMessage,
+                ackShare);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    hg::log::SetMinimalLogSeverity(hg::log::Severity::Info);
+
+    RN_IndexHandlers();
+
+    HG_LOG_INFO(LOG_ID,
+                "Updates: {}, messages per update: {}, message size: {} B, max packet size: {} B",
+                UPDATE_COUNT,
+                MESSAGES_PER_UPDATE,
+                MESSAGE_BYTE_COUNT,
+                MAX_PACKET_SIZE);
+
+    for (int i = 0; i < REPETITION_COUNT; i += 1) {
+        PrintResults("ordinals", RunBenchmark(false));
+        PrintResults("compact", RunBenchmark(true));
+    }
+
+    return 0;
+}